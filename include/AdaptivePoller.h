@@ -0,0 +1,101 @@
+#ifndef ADAPTIVE_POLLER_H
+#define ADAPTIVE_POLLER_H
+
+#include <Arduino.h>
+
+#include "SolarSnapshot.h"
+
+// Shortest poll interval while values are changing fast
+const uint32_t MIN_POLL_MILLIS = 1000;
+
+// Longest poll interval while values stay within the deadband
+const uint32_t MAX_POLL_MILLIS = 30000;
+
+// Poll interval while nobody looks at the display
+const uint32_t IDLE_POLL_MILLIS = 60000;
+
+// Number of polls within the deadband before the interval is stretched
+const uint8_t FLAT_POLLS_BEFORE_STRETCH = 3;
+
+// First delay after a failed connect or read
+const uint32_t MIN_BACKOFF_MILLIS = 1000;
+
+// Upper limit of the delay after repeated failures
+const uint32_t MAX_BACKOFF_MILLIS = 120000;
+
+// Default deadband of all power values
+const milliwatt_t DEFAULT_DEADBAND_MILLIWATT = 50000;
+
+/**
+ * Decides when the inverter is polled next. The interval is halved as soon
+ * as a power value moves by more than the deadband and stretched by half
+ * after a few polls within it, bounded by MIN_POLL_MILLIS and
+ * MAX_POLL_MILLIS. Failed connects or reads delay the next attempt
+ * exponentially with random jitter, so several monitors do not hit the
+ * proxy in lockstep.
+ */
+class AdaptivePoller {
+   public:
+    explicit AdaptivePoller(uint32_t baseMillis) : baseInterval(baseMillis), currentInterval(baseMillis) {}
+
+    // Sets the change of a power value which counts as significant
+    void setDeadband(milliwatt_t milliwatt) { deadband = milliwatt; }
+
+    // Polls with IDLE_POLL_MILLIS while idle, e.g. display off
+    void setIdle(bool isIdle);
+
+    // Is the next poll or connect attempt due?
+    bool due() const;
+
+    // Time until the next poll or connect attempt is due, 0 if it is due
+    uint32_t millisUntilDue() const;
+
+    // A poll or connect attempt was started
+    void started();
+
+    // A poll succeeded, adapts the interval to the change since the last one
+    void succeeded(const SolarSnapshot &snapshot);
+
+    // A connect or poll failed, delays the next attempt
+    void failed();
+
+    // Forgets the last values and polls right away with the base interval, e.g. after a reconnect
+    void reset();
+
+    // Current interval without backoff
+    uint32_t interval() const { return idle ? IDLE_POLL_MILLIS : currentInterval; }
+
+    // Current delay after failures, 0 = no backoff
+    uint32_t backoffMillis() const { return backoff; }
+
+    // Number of failures in a row
+    uint16_t failures() const { return failureCount; }
+
+    // Number of failures since boot
+    uint32_t totalFailures() const { return failureTotal; }
+
+    // Age of a snapshot which is shown as stale
+    uint32_t staleAfterMillis() const { return 3 * max(interval(), baseInterval); }
+
+   private:
+    // Largest change of a power value between two snapshots
+    static milliwatt_t maxChange(const SolarSnapshot &a, const SolarSnapshot &b);
+
+    uint32_t baseInterval;
+    uint32_t currentInterval;
+    milliwatt_t deadband = DEFAULT_DEADBAND_MILLIWATT;
+    bool idle = false;
+
+    uint32_t nextAt = 0;
+    uint32_t lastStart = 0;
+    uint8_t flatPolls = 0;
+
+    uint32_t backoff = 0;
+    uint16_t failureCount = 0;
+    uint32_t failureTotal = 0;
+
+    SolarSnapshot last = {};
+    bool hasLast = false;
+};
+
+#endif
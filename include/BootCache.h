@@ -0,0 +1,97 @@
+#ifndef BOOT_CACHE_H
+#define BOOT_CACHE_H
+
+#include <Arduino.h>
+
+#include "SolarSnapshot.h"
+
+// Bound of the WiFi connect with the cached BSSID and channel before a full scan is tried
+const unsigned long FAST_CONNECT_TIMEOUT_MILLIS = 5000;
+
+// State kept across restarts for a fast warm boot
+struct BootRecord {
+    uint32_t magic;
+
+    // access point and channel of the last connection, channel 0 = unknown
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint8_t reserved;
+
+    // DHCP lease of the last connection
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+
+    // last acquired values, sequence 0 = none
+    SolarSnapshot snapshot;
+
+    uint32_t crc;
+};
+
+static_assert(sizeof(BootRecord) % 4 == 0, "RTC memory is written in 32 bit blocks");
+static_assert(sizeof(BootRecord) <= 512, "record must fit into the RTC user memory");
+
+// Where the boot record came from
+enum BootSource : uint8_t {
+    BootCold,
+    BootFromFlash,
+    BootFromRtc
+};
+
+/**
+ * Network and last snapshot of the previous run. The record is kept in RTC
+ * memory, which survives restarts and resets, and in a small file on
+ * LittleFS, which also survives power cuts. The RTC copy is updated with
+ * every poll, the file only when the network changed, with the energy
+ * checkpoints and before a restart. The DHCP lease is only reused from the
+ * RTC copy: after a power cut it may have expired.
+ */
+class BootCache {
+   public:
+    // Loads the record from RTC memory or else from flash, returns false on a cold boot
+    bool begin();
+
+    // Where the record came from
+    BootSource source() const { return bootSource; }
+
+    // Are BSSID and channel of the last connection known?
+    bool hasNetwork() const { return record.channel != 0; }
+
+    // Can the lease of the last connection be reused as static configuration?
+    bool hasLease() const { return hasNetwork() && bootSource == BootFromRtc && record.ip != 0; }
+
+    // Is a snapshot of the previous run available?
+    bool hasSnapshot() const { return record.snapshot.sequence != 0; }
+
+    // Cached network and snapshot
+    const BootRecord &cached() const { return record; }
+
+    // Remembers access point, channel and lease after a connect, written to flash if they changed
+    void saveNetwork();
+
+    // Drops access point and lease, e.g. after the fast connect failed
+    void forgetNetwork();
+
+    // Remembers the latest snapshot in RTC memory
+    void saveSnapshot(const SolarSnapshot &snapshot);
+
+    // Writes the record to flash
+    bool persist();
+
+    // Number of flash writes since boot
+    uint32_t writes() const { return writeCount; }
+
+   private:
+    // Updates magic and CRC and writes the RTC copy
+    void writeRtc();
+
+    // Does the record carry a valid magic and CRC?
+    static bool isValid(const BootRecord &candidate);
+
+    BootRecord record = {};
+    BootSource bootSource = BootCold;
+    uint32_t writeCount = 0;
+};
+
+#endif
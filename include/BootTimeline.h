@@ -0,0 +1,44 @@
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+#include <Arduino.h>
+
+// Boot steps kept per boot
+const uint8_t MAX_BOOT_MARKS = 12;
+
+// Target from power on to the first frame with live values on a warm boot
+const unsigned long WARM_BOOT_TARGET_MILLIS = 5000;
+
+/**
+ * Times of the boot steps up to the first frame with live values, e.g.
+ * display ready, WiFi connected, Modbus connected, first poll. Printed
+ * once the first live frame is shown, together with the warm boot target.
+ */
+class BootTimeline {
+   public:
+    // Records the time of a boot step, ignored once the timeline is finished or full
+    void mark(const char *step);
+
+    // Records the first live frame and prints the timeline, later calls are ignored
+    void finish(bool warm);
+
+    // Is the first live frame shown?
+    bool finished() const { return done; }
+
+    // Time from power on to the first live frame, 0 until finished
+    unsigned long firstFrameMillis() const { return firstFrame; }
+
+   private:
+    // One boot step
+    struct Mark {
+        const char *step;
+        unsigned long at;
+    };
+
+    Mark marks[MAX_BOOT_MARKS];
+    uint8_t count = 0;
+    bool done = false;
+    unsigned long firstFrame = 0;
+};
+
+#endif
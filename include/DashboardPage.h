@@ -0,0 +1,40 @@
+#ifndef DASHBOARD_PAGE_H
+#define DASHBOARD_PAGE_H
+
+#include <Arduino.h>
+
+// Live view with the quadrants of screen 1, updated from /events
+static const char DASHBOARD_PAGE[] PROGMEM = R"html(<!DOCTYPE html>
+<html><head><meta charset="utf-8"><meta name="viewport" content="width=device-width,initial-scale=1">
+<title>SolarEdge Monitor</title>
+<style>
+body{margin:0;font-family:sans-serif;background:#111;color:#eee}
+#g{display:grid;grid-template-columns:1fr 1fr;gap:2px;background:#444;height:100vh}
+.q{background:#111;display:flex;flex-direction:column;align-items:center;justify-content:center}
+.l{font-size:1.1em;color:#999}.v{font-size:2.6em;margin:.2em}.a{font-size:1.4em;height:1.2em}
+#bar{width:60%;height:.6em;border:1px solid #eee}#lvl{height:100%;width:0;background:#eee}
+.stale .v{color:#777}
+</style></head><body>
+<div id="g">
+<div class="q"><div class="l">Sun</div><div class="v" id="s">-</div><div class="a" id="sa"></div></div>
+<div class="q"><div class="l">House</div><div class="v" id="h">-</div><div class="a"></div></div>
+<div class="q"><div class="l">Battery <span id="e">-</span></div><div class="v" id="b">-</div><div id="bar"><div id="lvl"></div></div><div class="a" id="ba"></div></div>
+<div class="q"><div class="l">Grid</div><div class="v" id="m">-</div><div class="a" id="ma"></div></div>
+</div>
+<script>
+var v={},t=0,g=document.getElementById('g');
+function $(i){return document.getElementById(i)}
+function kw(x){return (x/1e6).toFixed(2)+' kW'}
+function show(){
+if(v.s!=null){$('s').textContent=kw(v.s);$('sa').textContent=v.s>0?'→':''}
+if(v.h!=null)$('h').textContent=kw(v.h);
+if(v.b!=null){$('b').textContent=kw(Math.abs(v.b));$('ba').textContent=v.b>0?'↓ charging':v.b<0?'↑ discharging':''}
+if(v.e!=null){$('e').textContent=(v.e/10).toFixed(0)+' %';$('lvl').style.width=Math.min(100,v.e/10)+'%'}
+if(v.g!=null){$('m').textContent=kw(Math.abs(v.g));$('ma').textContent=v.g>0?'↑ export':v.g<0?'↓ import':''}
+}
+var es=new EventSource('/events');
+es.onmessage=function(ev){ev.data.split(';').forEach(function(p){var kv=p.split('=');v[kv[0]]=+kv[1]});t=Date.now();g.className='';show()};
+setInterval(function(){if(Date.now()-t>90000)g.className='stale'},5000);
+</script></body></html>)html";
+
+#endif
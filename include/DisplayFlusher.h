@@ -0,0 +1,69 @@
+#ifndef DISPLAY_FLUSHER_H
+#define DISPLAY_FLUSHER_H
+
+#include <Adafruit_SSD1306.h>
+#include <Arduino.h>
+#include <Wire.h>
+
+// Number of 8 pixel high pages of the display
+const uint8_t FLUSH_PAGES = 8;
+
+// Number of columns of the display
+const uint8_t FLUSH_COLUMNS = 128;
+
+// Maximum number of separate column ranges sent per page
+const uint8_t MAX_RANGES_PER_PAGE = 4;
+
+// Unchanged columns between two changes which are sent anyway instead of starting a new range
+const uint8_t RANGE_MERGE_GAP = 10;
+
+// Full frame as sent by Adafruit_SSD1306::display(): 6 command bytes plus 1 KB data in 31 byte chunks
+const uint16_t FULL_FRAME_BYTES = 1 + 6 + 1024 + (1024 + 30) / 31;
+
+/**
+ * Incremental replacement for Adafruit_SSD1306::display(). Keeps a copy of
+ * the frame last sent to the display and only transfers the column ranges
+ * of each page which differ from it, using the SSD1306 page and column
+ * address window.
+ */
+class DisplayFlusher {
+   public:
+    DisplayFlusher(Adafruit_SSD1306 &display, TwoWire &wire, uint8_t address, uint32_t clkDuring = 400000UL, uint32_t clkAfter = 100000UL);
+
+    // Sends all changes of the display buffer, returns the number of bytes put on the I2C bus
+    uint16_t flush();
+
+    // Sends the full frame with the next flush(), e.g. after display.begin()
+    void invalidate() { valid = false; }
+
+    // Bytes sent by the last flush()
+    uint16_t lastFrameBytes() const { return lastBytes; }
+
+    // Bytes sent by all flushes since the last resetStats()
+    uint32_t totalBytes() const { return sumBytes; }
+
+    // Number of flushes since the last resetStats()
+    uint32_t frames() const { return frameCount; }
+
+    // Starts a new measurement window
+    void resetStats();
+
+   private:
+    // Sends columns [from, to] of page to the display, returns the bytes sent
+    uint16_t sendRange(uint8_t page, uint8_t from, uint8_t to);
+
+    Adafruit_SSD1306 &display;
+    TwoWire &wire;
+    uint8_t address;
+    uint32_t clkDuring;
+    uint32_t clkAfter;
+
+    uint8_t lastFrame[FLUSH_PAGES * FLUSH_COLUMNS];
+    bool valid = false;
+
+    uint16_t lastBytes = 0;
+    uint32_t sumBytes = 0;
+    uint32_t frameCount = 0;
+};
+
+#endif
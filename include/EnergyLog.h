@@ -0,0 +1,60 @@
+#ifndef ENERGY_LOG_H
+#define ENERGY_LOG_H
+
+#include <Arduino.h>
+
+#include "EnergyMeter.h"
+
+// Records per log file before the other file is started
+const uint16_t ENERGY_LOG_RECORDS_PER_FILE = 128;
+
+// Interval of the periodic checkpoints, at most this much energy is lost by a power cut
+const unsigned long ENERGY_CHECKPOINT_MILLIS = 10UL * 60 * 1000;
+
+/**
+ * Append-only log of energy counter checkpoints on LittleFS. Records of
+ * fixed size with a sequence number and CRC go alternately into two files:
+ * when one is full, the other one is truncated and continued. LittleFS
+ * spreads the appends over its blocks, so no flash sector is rewritten in
+ * place. Recovery only reads the last record of each file (the one before
+ * it if the last is torn) and takes the newer one.
+ */
+class EnergyLog {
+   public:
+    // Mounts the file system and finds the latest checkpoint, returns false if none was found
+    bool begin(EnergyState &restored);
+
+    // Appends a checkpoint
+    bool append(const EnergyState &state);
+
+    // Number of checkpoints written since boot
+    uint32_t writes() const { return writeCount; }
+
+    // CRC-32 of a flash record, also used by the boot cache
+    static uint32_t crc32(const uint8_t *data, size_t length);
+
+   private:
+    // Checkpoint as stored on flash
+    struct Record {
+        uint32_t magic;
+        uint32_t sequence;
+        EnergyState state;
+        uint32_t crc;
+    };
+
+    // Latest valid record of a file, false if there is none
+    bool lastRecord(uint8_t file, Record &record, uint16_t &count);
+
+    static uint32_t recordCrc(const Record &record);
+
+    bool mounted = false;
+
+    // file appended to and its number of records
+    uint8_t current = 0;
+    uint16_t currentCount = 0;
+
+    uint32_t sequence = 0;
+    uint32_t writeCount = 0;
+};
+
+#endif
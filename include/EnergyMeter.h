@@ -0,0 +1,77 @@
+#ifndef ENERGY_METER_H
+#define ENERGY_METER_H
+
+#include <Arduino.h>
+
+#include "FixedPoint.h"
+#include "SolarSnapshot.h"
+
+// Integrated energy flows
+enum EnergyCounter {
+    EnergyProduction,
+    EnergyConsumption,
+    EnergyImport,
+    EnergyExport,
+    EnergyCharge,
+    EnergyDischarge,
+    ENERGY_COUNTERS
+};
+
+// Energy in mWh
+typedef uint64_t milliwatthour_t;
+
+// Polls further apart than this are not integrated, the power in between is unknown
+const unsigned long MAX_INTEGRATION_GAP_MILLIS = 120000;
+
+// mW * ms per mWh
+const uint32_t MILLIWATT_MILLIS_PER_MILLIWATTHOUR = 3600000UL;
+
+// Persistent part of the counters
+struct EnergyState {
+    // local date of the today counters as YYYYMMDD, 0 = unknown
+    uint32_t day;
+    milliwatthour_t lifetime[ENERGY_COUNTERS];
+    milliwatthour_t today[ENERGY_COUNTERS];
+};
+
+/**
+ * Integrates the power of every poll over its real time delta since the
+ * previous poll (trapezoidal rule) into lifetime and daily counters for
+ * production, consumption, grid import and export, battery charge and
+ * discharge. Remainders below 1 mWh are carried to the next poll.
+ */
+class EnergyMeter {
+   public:
+    // Adds the energy since the previous snapshot
+    void add(const SolarSnapshot &snapshot);
+
+    // Sets the current local date as YYYYMMDD, resets the today counters on a new day, returns true then
+    bool setDay(uint32_t day);
+
+    // Restores counters, e.g. from the flash log
+    void restore(const EnergyState &saved) { state = saved; }
+
+    // Counters to be saved
+    const EnergyState &current() const { return state; }
+
+    // Energy of today
+    milliwatthour_t today(EnergyCounter c) const { return state.today[c]; }
+
+    // Energy since the counters were started
+    milliwatthour_t lifetime(EnergyCounter c) const { return state.lifetime[c]; }
+
+   private:
+    // Power of each flow, only positive parts count
+    static void flows(const SolarSnapshot &snapshot, milliwatt_t (&power)[ENERGY_COUNTERS]);
+
+    EnergyState state = {};
+
+    milliwatt_t lastPower[ENERGY_COUNTERS] = {};
+    unsigned long lastAt = 0;
+    bool hasLast = false;
+
+    // energy below 1 mWh in mW * ms
+    uint32_t rest[ENERGY_COUNTERS] = {};
+};
+
+#endif
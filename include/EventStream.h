@@ -0,0 +1,58 @@
+#ifndef EVENT_STREAM_H
+#define EVENT_STREAM_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+
+#include "FixedText.h"
+#include "SolarSnapshot.h"
+
+// Maximum number of browsers subscribed at the same time
+const uint8_t MAX_EVENT_SUBSCRIBERS = 3;
+
+// Interval of comment lines keeping idle connections open and detecting dead ones
+const unsigned long EVENT_KEEPALIVE_MILLIS = 15000;
+
+/**
+ * Server-Sent Events stream of new snapshots. Every event carries only
+ * the values which changed since the previous event as key=value pairs
+ * in mW and 0.1 %, e.g. "q=12;s=4321567;b=-1000", a new subscriber first
+ * gets all values. A subscriber whose socket buffer cannot take an event
+ * is dropped instead of buffering, the browser reconnects by itself.
+ */
+class EventStream {
+   public:
+    // Takes over the client of the current request, returns false if all slots are taken
+    bool subscribe(WiFiClient &client);
+
+    // Sends the changes since the last published snapshot to all subscribers
+    void publish(const SolarSnapshot &snapshot);
+
+    // Sends keep-alives and releases closed connections, to be called periodically
+    void task();
+
+    // Number of connected subscribers
+    uint8_t subscribers() const;
+
+    // Number of subscribers dropped because they could not keep up
+    uint32_t dropped() const { return droppedCount; }
+
+   private:
+    // Writes the event completely or drops the subscriber
+    void send(uint8_t i, const char *data, size_t length);
+
+    // Builds an event with all values (full) or the changes since lastSent
+    void build(const SolarSnapshot &snapshot, bool full);
+
+    WiFiClient clients[MAX_EVENT_SUBSCRIBERS];
+    bool active[MAX_EVENT_SUBSCRIBERS] = {};
+
+    FixedText<128> event;
+    SolarSnapshot lastSent = {};
+    bool hasLast = false;
+
+    unsigned long lastKeepAlive = 0;
+    uint32_t droppedCount = 0;
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <Arduino.h>
+
+// Power in milliwatt
+typedef int32_t milliwatt_t;
+
+// Percentage in tenths of a percent, 1000 = 100 %
+typedef int16_t decipercent_t;
+
+// Milliwatt per display unit of 0.01 kW
+const milliwatt_t MILLIWATT_PER_CENTI_KW = 10000;
+
+/**
+ * Divides and rounds half away from zero, so positive and negative values
+ * are rounded symmetrically.
+ */
+int32_t divRound(int64_t numerator, int32_t denominator);
+
+/**
+ * Applies a SunSpec scale factor to a register value and returns
+ * round(value * 10^scaleFactor * scale). Saturates instead of overflowing.
+ */
+int32_t scaledToFixed(int64_t value, int16_t scaleFactor, int32_t scale);
+
+/**
+ * Applies a SunSpec scale factor to a register value in W and returns mW:
+ * value * 10^scaleFactor * 1000. Saturates instead of overflowing.
+ */
+milliwatt_t scaledToMilliwatt(int16_t value, int16_t scaleFactor);
+
+/**
+ * Converts the bits of an IEEE 754 single precision float to
+ * round(value * scale) using integer arithmetic only. NaN and infinity
+ * return 0, results outside int32_t saturate.
+ */
+int32_t ieee754ToFixed(uint32_t raw, int32_t scale);
+
+#endif
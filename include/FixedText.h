@@ -0,0 +1,112 @@
+#ifndef FIXED_TEXT_H
+#define FIXED_TEXT_H
+
+#include <Arduino.h>
+
+/**
+ * Fixed capacity text buffer for building display and log lines without
+ * heap allocations. Appends which do not fit are truncated, the buffer is
+ * always null terminated.
+ */
+template <size_t N>
+class FixedText {
+   public:
+    FixedText() { clear(); }
+
+    FixedText(const char *s) {
+        clear();
+        append(s);
+    }
+
+    // Empties the buffer
+    FixedText &clear() {
+        len = 0;
+        buf[0] = '\0';
+        return *this;
+    }
+
+    // Appends a string
+    FixedText &append(const char *s) {
+        while (s != nullptr && *s != '\0' && len < N - 1) {
+            buf[len++] = *s++;
+        }
+        buf[len] = '\0';
+        return *this;
+    }
+
+    // Appends a single character
+    FixedText &append(char c) {
+        if (len < N - 1) {
+            buf[len++] = c;
+            buf[len] = '\0';
+        }
+        return *this;
+    }
+
+    // Appends an integer in decimal notation
+    FixedText &appendInt(long v) {
+        char tmp[12];
+        snprintf(tmp, sizeof(tmp), "%ld", v);
+        return append(tmp);
+    }
+
+    // Appends an unsigned integer in decimal notation
+    FixedText &appendUInt(unsigned long v) {
+        char tmp[12];
+        snprintf(tmp, sizeof(tmp), "%lu", v);
+        return append(tmp);
+    }
+
+    // Appends a fixed point value with the given number of decimals, right aligned to width characters
+    FixedText &appendFixed(int32_t v, uint8_t decimals, uint8_t width = 0) {
+        char tmp[16];
+        uint8_t n = 0;
+
+        uint32_t abs = v < 0 ? -(int64_t)v : v;
+        uint32_t pow10 = 1;
+        for (uint8_t i = 0; i < decimals && i < 9; i++) {
+            pow10 *= 10;
+        }
+
+        // digits are collected in reverse order
+        uint32_t frac = abs % pow10;
+        uint32_t whole = abs / pow10;
+        for (uint8_t i = 0; i < decimals && i < 9; i++) {
+            tmp[n++] = '0' + frac % 10;
+            frac /= 10;
+        }
+        if (decimals > 0) {
+            tmp[n++] = '.';
+        }
+        do {
+            tmp[n++] = '0' + whole % 10;
+            whole /= 10;
+        } while (whole > 0);
+        if (v < 0) {
+            tmp[n++] = '-';
+        }
+
+        for (uint8_t i = n; i < width; i++) {
+            append(' ');
+        }
+        while (n > 0) {
+            append(tmp[--n]);
+        }
+        return *this;
+    }
+
+    const char *c_str() const { return buf; }
+
+    size_t length() const { return len; }
+
+    static size_t capacity() { return N - 1; }
+
+   private:
+    char buf[N];
+    size_t len;
+};
+
+// Line of the 4 line status screen, 21 characters fit in one display line
+typedef FixedText<24> ScreenLine;
+
+#endif
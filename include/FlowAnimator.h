@@ -0,0 +1,82 @@
+#ifndef FLOW_ANIMATOR_H
+#define FLOW_ANIMATOR_H
+
+#include <Arduino.h>
+
+#include "FixedPoint.h"
+#include "SolarSnapshot.h"
+
+// Interval of the animation frames, 25 fps
+const uint32_t ANIMATION_FRAME_MILLIS = 40;
+
+// Time budget of one animation frame, the frame after an overrun is skipped
+const uint32_t FRAME_BUDGET_MICROS = 15000;
+
+// Power flow paths of screen 1 with a moving indicator
+enum FlowPath {
+    FlowSun,      // inverter to house
+    FlowBattery,  // battery charge or discharge
+    FlowMeter,    // grid export or import
+    FLOW_PATHS
+};
+
+// Positions of a flow indicator along its path, it starts over after the last
+const uint8_t FLOW_STEPS = 4;
+
+// Indicator speed in steps per second at the smallest power
+const uint16_t FLOW_MIN_STEPS_PER_SECOND = 2;
+
+// Indicator speed in steps per second from FLOW_FULL_SPEED_MILLIWATT on
+const uint16_t FLOW_MAX_STEPS_PER_SECOND = 25;
+
+// Power of a path which moves its indicator at full speed
+const milliwatt_t FLOW_FULL_SPEED_MILLIWATT = 5000000;
+
+// Duration of the transition from the values shown to a new snapshot
+const uint32_t TWEEN_MILLIS = 800;
+
+// Longest time step applied at once, e.g. after the animation was paused
+const uint32_t MAX_ANIMATION_STEP_MILLIS = 200;
+
+/**
+ * Time based state of the screen 1 animation, independent of the frame
+ * rate and of the drawing. Moves one indicator per power flow with a speed
+ * proportional to its power and interpolates the shown values linearly
+ * from the previous to the latest snapshot.
+ */
+class FlowAnimator {
+   public:
+    // Starts the transition to snapshot, a snapshot already shown or the first one is shown right away
+    void setTarget(const SolarSnapshot &snapshot, uint32_t now);
+
+    // Moves the indicators and the transition on to now, returns true if the shown values changed
+    bool advance(uint32_t now);
+
+    // Is there a snapshot to show?
+    bool hasTarget() const { return target.sequence != 0; }
+
+    // Values to show at the time of the last advance()
+    const SolarSnapshot &shown() const { return current; }
+
+    // Position 0..FLOW_STEPS-1 of the indicator of path
+    uint8_t step(FlowPath path) const { return (phase[path] >> 8) % FLOW_STEPS; }
+
+   private:
+    // Indicator speed for power in 1/256 steps per second
+    static uint32_t speed(milliwatt_t power);
+
+    // Value between from and to at progress 0..TWEEN_MILLIS
+    static int32_t tween(int32_t from, int32_t to, uint32_t progress);
+
+    SolarSnapshot start = {};
+    SolarSnapshot target = {};
+    SolarSnapshot current = {};
+    uint32_t tweenStart = 0;
+    bool tweening = false;
+
+    // 1/256 steps, wraps at a multiple of FLOW_STEPS
+    uint16_t phase[FLOW_PATHS] = {};
+    uint32_t lastAdvance = 0;
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef HEAP_MONITOR_H
+#define HEAP_MONITOR_H
+
+#include <Arduino.h>
+
+// Number of history samples kept, one per HEAP_HISTORY_INTERVAL_MILLIS
+const uint8_t HEAP_HISTORY_SIZE = 24;
+
+// Interval between two history samples
+const unsigned long HEAP_HISTORY_INTERVAL_MILLIS = 60UL * 60 * 1000;
+
+// One heap measurement
+struct HeapSample {
+    uint32_t freeHeap;
+    uint32_t maxFreeBlock;
+    uint8_t fragmentation;
+};
+
+/**
+ * Tracks free heap, largest free block and fragmentation over time. Keeps
+ * the extremes since boot and an hourly history, so a long run can show
+ * that the heap stays flat.
+ */
+class HeapMonitor {
+   public:
+    // Takes a measurement, to be called periodically
+    void sample();
+
+    // Last measurement
+    const HeapSample &current() const { return last; }
+
+    // Lowest free heap since boot
+    uint32_t minFreeHeap() const { return minFree; }
+
+    // Smallest largest free block since boot
+    uint32_t minMaxFreeBlock() const { return minBlock; }
+
+    // Highest fragmentation in percent since boot
+    uint8_t maxFragmentation() const { return maxFrag; }
+
+    // Number of history samples available
+    uint8_t historyCount() const { return count; }
+
+    // History sample i, 0 = oldest
+    const HeapSample &history(uint8_t i) const { return samples[(head + HEAP_HISTORY_SIZE - count + i) % HEAP_HISTORY_SIZE]; }
+
+    // Prints the current values, extremes and history to Serial
+    void print() const;
+
+   private:
+    HeapSample last = {};
+    uint32_t minFree = UINT32_MAX;
+    uint32_t minBlock = UINT32_MAX;
+    uint8_t maxFrag = 0;
+
+    HeapSample samples[HEAP_HISTORY_SIZE];
+    uint8_t head = 0;
+    uint8_t count = 0;
+    unsigned long lastHistoryMillis = 0;
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef LAYOUT_CACHE_H
+#define LAYOUT_CACHE_H
+
+#include <Arduino.h>
+
+#include "ModelDiscovery.h"
+
+// Inverters whose layout is remembered, the oldest is dropped for a new one
+const uint8_t MAX_CACHED_LAYOUTS = 3;
+
+// Discovered layouts kept in flash
+struct LayoutRecord {
+    uint32_t magic;
+
+    // inverter address and unit, the meters and batteries configured at the walk and its layout
+    struct Entry {
+        uint32_t remote;
+        uint16_t port;
+        uint8_t unit;
+        uint8_t meters;
+        uint8_t batteries;
+        uint8_t reserved[3];
+        DeviceLayout layout;
+    };
+
+    uint8_t count;
+    uint8_t reserved[3];
+    Entry entries[MAX_CACHED_LAYOUTS];
+
+    uint32_t crc;
+};
+
+/**
+ * Register layouts found by ModelDiscovery, kept in a small file on
+ * LittleFS so later boots read the metadata at the cached block bases
+ * right away. A layout is only found for the meters and batteries it was
+ * discovered with, so enabling one in the configuration walks the chain
+ * again. The file is only rewritten when a layout changed.
+ */
+class LayoutCache {
+   public:
+    // Loads the layouts from flash, returns false if there are none
+    bool begin();
+
+    // Looks up the layout of the inverter with unit at remote and port, discovered with the configured meters and batteries
+    bool find(const IPAddress &remote, uint16_t port, uint8_t unit, uint8_t meters, uint8_t batteries, DeviceLayout &layout) const;
+
+    // Remembers the layout of an inverter and its configured meters and batteries, written to flash if one of them changed
+    bool store(const IPAddress &remote, uint16_t port, uint8_t unit, uint8_t meters, uint8_t batteries, const DeviceLayout &layout);
+
+    // Number of flash writes since boot
+    uint32_t writes() const { return writeCount; }
+
+   private:
+    // Index of the entry of an inverter, -1 = none
+    int8_t indexOf(const IPAddress &remote, uint16_t port, uint8_t unit) const;
+
+    // Does the record carry a valid magic and CRC?
+    static bool isValid(const LayoutRecord &candidate);
+
+    LayoutRecord record = {};
+    uint32_t writeCount = 0;
+};
+
+#endif
@@ -0,0 +1,169 @@
+#ifndef MODBUS_PIPELINE_H
+#define MODBUS_PIPELINE_H
+
+#include <Arduino.h>
+#include <ModbusSolarEdge.h>
+
+#include "ReadPlanner.h"
+
+// Maximum number of block reads queued or in flight
+const uint8_t MAX_PIPELINE_REQUESTS = 16;
+
+// Maximum number of poll cycles queued at the same time
+const uint8_t MAX_PIPELINE_CYCLES = 4;
+
+// Default number of requests in flight, the library allows up to MODBUSIP_MAX_TRANSACIONS
+const uint8_t DEFAULT_PIPELINE_WINDOW = 4;
+
+// Default number of repeats of a timed out or busy rejected request
+const uint8_t DEFAULT_REQUEST_RETRIES = 2;
+
+// Called from task() once all block reads of a plan finished
+typedef void (*CycleCallback)(ReadPlanner &plan, bool success);
+
+/**
+ * Asynchronous request layer on top of the ModbusIP transaction callbacks.
+ * All block reads of a submitted plan are sent at once, up to window
+ * requests are in flight and responses are matched by transaction ID, so a
+ * poll cycle takes about one round trip instead of one per block.
+ * Requests that time out or are rejected as busy are sent again. A request
+ * times out when the library reports it after MODBUSIP_TIMEOUT, set in
+ * platformio.ini, so the library has released the transaction and its
+ * buffer before the read is repeated. Once all
+ * reads of a plan are finished the cycle callback is called from task(),
+ * never from within the library callback.
+ */
+class ModbusPipeline {
+   public:
+    explicit ModbusPipeline(ModbusIP &mb);
+
+    // Sets the device all following cycles are read from
+    void setTarget(const IPAddress &remote, uint8_t unit = MODBUSIP_UNIT);
+
+    // Sets the number of requests in flight, 1 = sequential
+    void setWindow(uint8_t size);
+
+    // Sets the repeats of a single request
+    void setRetries(uint8_t retries);
+
+    // Queues all block reads of a plan, returns false if the queue is full
+    bool submit(ReadPlanner &plan, CycleCallback callback) { return submit(plan, callback, unit); }
+
+    // Queues all block reads of a plan for another unit behind the same connection
+    bool submit(ReadPlanner &plan, CycleCallback callback, uint8_t cycleUnit);
+
+    // Sends queued requests, handles responses and timeouts, to be called every loop
+    void task();
+
+    /**
+     * Runs the library task of the client. Transaction IDs are only unique
+     * per ModbusIP, so with several clients the callbacks fired from here
+     * are matched to this pipeline only.
+     */
+    void clientTask();
+
+    // Are cycles queued or in flight?
+    bool busy() const { return cycleCount > 0; }
+
+    // Forgets all cycles without calling their callbacks, e.g. after a disconnect
+    void cancel();
+
+    // Number of cancel() calls since boot, a cycle submitted before a change never calls back
+    uint32_t cancels() const { return cancelCount; }
+
+    // Duration of the last finished cycle from submit to completion
+    uint32_t lastCycleMillis() const { return lastCycle; }
+
+    // Number of requests sent including repeats since boot
+    uint32_t requests() const { return requestCount; }
+
+    // Number of repeated requests since boot
+    uint32_t retries() const { return retryCount; }
+
+    // Number of requests which timed out since boot
+    uint32_t timeouts() const { return timeoutCount; }
+
+    // Number of responses of all pipelines which did not match a request in flight since boot
+    static uint32_t lateResponses() { return lateCount; }
+
+    // Highest number of requests in flight since boot
+    uint8_t maxInFlight() const { return maxFlight; }
+
+    // Result of the cycle whose callback runs, e.g. to tell a rejected address from a lost response
+    Modbus::ResultCode cycleResult() const { return reportedResult; }
+
+   private:
+    enum RequestState : uint8_t {
+        RequestFree,
+        RequestQueued,
+        RequestInFlight,
+        RequestDone,
+        RequestFailed
+    };
+
+    struct Request {
+        RequestState state;
+        uint8_t cycle;
+        uint8_t block;
+        uint8_t attempts;
+        uint16_t transaction;
+        Modbus::ResultCode result;
+    };
+
+    struct Cycle {
+        ReadPlanner *plan;
+        CycleCallback callback;
+        uint32_t submittedAt;
+        uint8_t unit;
+        uint8_t pending;
+        bool failed;
+
+        // of the first failed read
+        Modbus::ResultCode result;
+    };
+
+    // Routes a library callback to the pipeline owning the transaction
+    static bool onTransaction(Modbus::ResultCode event, uint16_t transactionId, void *data);
+
+    // Stores the result of a request in flight, returns false if none matches
+    bool complete(uint16_t transactionId, Modbus::ResultCode event);
+
+    // Sends a queued request
+    bool send(Request &request);
+
+    // Decides between repeat and failure of an unsuccessful request
+    void retryOrFail(Request &request);
+
+    // Finishes the oldest cycle if all of its requests are done
+    void finishCycles();
+
+    ModbusIP &mb;
+    IPAddress remote;
+    uint8_t unit = MODBUSIP_UNIT;
+
+    uint8_t window = DEFAULT_PIPELINE_WINDOW;
+    uint8_t maxRetries = DEFAULT_REQUEST_RETRIES;
+
+    Request requestSlots[MAX_PIPELINE_REQUESTS] = {};
+    uint8_t inFlight = 0;
+
+    // cycles form a ring, callbacks are called in submit order
+    Cycle cycles[MAX_PIPELINE_CYCLES] = {};
+    uint8_t firstCycle = 0;
+    uint8_t cycleCount = 0;
+    Modbus::ResultCode reportedResult = Modbus::EX_SUCCESS;
+
+    uint32_t lastCycle = 0;
+    uint32_t requestCount = 0;
+    uint32_t retryCount = 0;
+    uint32_t timeoutCount = 0;
+    uint32_t cancelCount = 0;
+    uint8_t maxFlight = 0;
+
+    static uint32_t lateCount;
+
+    // pipeline inside clientTask() or cancel(), callbacks outside of both count as late
+    static ModbusPipeline *active;
+};
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef MODEL_DISCOVERY_H
+#define MODEL_DISCOVERY_H
+
+#include <Arduino.h>
+
+#include "ReadPlanner.h"
+#include "SunSpecRegisters.h"
+
+// Start of the SunSpec model chain, marked with "SunS"
+const uint16_t SUNSPEC_BASE_ADDRESS = 40000;
+
+// Model ID which ends the chain
+const uint16_t SUNSPEC_END_MODEL = 0xFFFF;
+
+// Models walked at most, bounds the walk of a corrupt chain
+const uint8_t MAX_CHAIN_MODELS = 16;
+
+// Register layout of one inverter as found by walking its model chain
+struct DeviceLayout {
+    BlockBases bases;
+
+    // SunSpec model IDs, 0 = not found
+    uint16_t inverterModel;
+    uint16_t meterModel[MAX_METERS];
+
+    // meters (bit 0 = M1) and batteries (bit 0 = B1) found
+    uint8_t meters;
+    uint8_t batteries;
+
+    // address of the end marker header, 0 = the chain did not end with a marker
+    uint16_t chainEnd;
+
+    // CRC of all fields above, tells layouts apart in the log and the flash cache
+    uint32_t fingerprint;
+};
+
+/**
+ * Walks the SunSpec model chain of an inverter one read at a time: the
+ * "SunS" marker at SUNSPEC_BASE_ADDRESS, then the ID and length header of
+ * every model until the end marker. The first integer inverter model
+ * (101..103) and up to MAX_METERS integer meter models (201..204) give the
+ * block bases, meters in chain order. The SolarEdge battery info blocks
+ * are not part of the chain, they are probed at their fixed addresses and
+ * count as present if they report a manufacturer name. The reads are
+ * executed by the caller, e.g. through the device's pipeline.
+ *
+ * A cached layout is checked with the reads it cannot explain: the header
+ * at its end marker, which is another model if one was appended, and the
+ * probes of configured batteries it does not have. Either answer
+ * contradicts the layout and calls for a new walk.
+ */
+class ModelDiscovery {
+   public:
+    // Starts a new walk at the "SunS" marker
+    void start();
+
+    // Starts the check of a cached layout for the configured batteries, returns false if there is nothing to read
+    bool check(const DeviceLayout &cached, uint8_t batteries);
+
+    // Read to execute next
+    ReadPlanner &plan() { return probe; }
+
+    // Evaluates the executed read, returns true if another read is needed
+    bool next();
+
+    // The inverter rejected the address of the read: a battery probe counts as no battery, returns true if another read is needed
+    bool rejected();
+
+    // Did the finished walk find an inverter model, or the finished check confirm the layout?
+    bool found() const { return step == Done; }
+
+    // Did the finished check find a model or battery missing in the cached layout?
+    bool contradicted() const { return step == Contradicted; }
+
+    // Layout of the finished walk or check
+    const DeviceLayout &result() const { return layout; }
+
+    // Fills in the fingerprint of a layout
+    static void seal(DeviceLayout &target);
+
+   private:
+    enum Step : uint8_t {
+        Marker,
+        Header,
+        Battery,
+        EndCheck,
+        BatteryCheck,
+        Done,
+        Contradicted,
+        Failed
+    };
+
+    // Prepares the read of count registers at address
+    void readAt(uint16_t address, uint16_t count) { probe.setLayout(rangeLayout(address, count)); }
+
+    // Records the model with header at address
+    void record(uint16_t address, uint16_t id, uint16_t length);
+
+    // Ends the chain walk, continues with the battery probes if an inverter was found
+    bool endChain();
+
+    // Prepares the probe of the manufacturer name of the next battery in probeMask, returns false if none is left
+    bool probeNext();
+
+    // Records the probed battery, returns true if another battery is probed
+    bool probed(bool present);
+
+    // Ends the check, the cached layout does not explain what the inverter reported
+    bool contradict(const char *reason);
+
+    ReadPlanner probe;
+    DeviceLayout layout = {};
+    Step step = Failed;
+    uint16_t address = 0;
+    uint8_t models = 0;
+    uint8_t battery = 0;
+    uint8_t probeMask = 0;
+};
+
+#endif
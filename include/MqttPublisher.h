@@ -0,0 +1,141 @@
+#ifndef MQTT_PUBLISHER_H
+#define MQTT_PUBLISHER_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <PubSubClient.h>
+
+#include "FixedText.h"
+#include "SolarSnapshot.h"
+
+// Messages kept while the broker is not reachable, the oldest is dropped when full
+const uint8_t MQTT_QUEUE_LENGTH = 8;
+
+// Payload of one cycle, all fields fit
+const size_t MQTT_PAYLOAD_CAPACITY = 128;
+
+// Topic below the prefix, e.g. "solaredge/state"
+const size_t MQTT_TOPIC_CAPACITY = 64;
+
+// Every field is sent at least this often, so new subscribers get all values
+const unsigned long MQTT_FULL_STATE_MILLIS = 300000;
+
+// Delay of the first reconnect, doubled after every failure
+const unsigned long MQTT_MIN_RECONNECT_MILLIS = 5000;
+
+// Longest delay between reconnects
+const unsigned long MQTT_MAX_RECONNECT_MILLIS = 60000;
+
+// Bound of each blocking step of a broker connect: name lookup, TCP connect and the wait for CONNACK
+const unsigned long MQTT_CONNECT_TIMEOUT_MILLIS = 1000;
+
+// Messages published per task() call, keeps the loop short after an outage
+const uint8_t MQTT_PUBLISH_PER_TASK = 2;
+
+/**
+ * Publishes the fields of each snapshot which moved by more than their
+ * deadband as one JSON object per cycle to <prefix>/state, e.g.
+ * {"q":12,"sun":4322,"battery":-1000}. Powers are in W (positive grid =
+ * export, positive battery = charging), soe in %. Payloads go through a
+ * bounded queue: publish() only enqueues, task() connects with backoff and
+ * sends. During a broker outage the newest MQTT_QUEUE_LENGTH messages are
+ * kept. <prefix>/status is "online" or "offline" (last will), both retained.
+ */
+class MqttPublisher {
+   public:
+    MqttPublisher();
+
+    // Starts publishing to host:port, an empty host leaves the publisher off
+    void begin(const char *host, uint16_t port, const char *user, const char *password, const char *prefix, const char *clientId);
+
+    // Power change in mW which is sent, 0 sends every change
+    void setDeadband(milliwatt_t deadband) { powerDeadband = deadband; }
+
+    // Enqueues the fields which changed by more than their deadband
+    void publish(const SolarSnapshot &snapshot);
+
+    // Connects, keeps the connection alive and sends queued messages, to be called every loop
+    void task();
+
+    // Is publishing configured?
+    bool enabled() const { return host[0] != '\0'; }
+
+    // Is the broker connected?
+    bool connected() { return mqtt.connected(); }
+
+    // Messages sent since boot
+    uint32_t published() const { return publishedCount; }
+
+    // Messages dropped because the queue was full or the broker refused them
+    uint32_t dropped() const { return droppedCount; }
+
+    // Messages waiting for the broker
+    uint8_t queued() const { return queueCount; }
+
+    // Time from publish() to sending of the last message
+    unsigned long lastLatencyMillis() const { return lastLatency; }
+
+    // Longest time from publish() to sending since boot
+    unsigned long maxLatencyMillis() const { return maxLatency; }
+
+   private:
+    // Enqueued payload of one cycle
+    struct Message {
+        unsigned long enqueuedAt;
+        FixedText<MQTT_PAYLOAD_CAPACITY> payload;
+    };
+
+    // Appends a field if it moved by more than the deadband since it was sent
+    bool appendChanged(const char *name, int32_t value, int32_t &last, int32_t deadband, uint8_t decimals, bool full);
+
+    // Connects with last will, returns false before the reconnect delay has passed
+    bool reconnect();
+
+    // Looks up the broker address unless it is known, returns false if the lookup failed
+    bool resolve();
+
+    WiFiClient net;
+    PubSubClient mqtt;
+
+    char host[64] = "";
+    uint16_t port = 1883;
+
+    // address of host, looked up again after a failed connect
+    IPAddress brokerIp;
+    bool resolved = false;
+    const char *user = nullptr;
+    const char *password = nullptr;
+    const char *clientId = nullptr;
+
+    FixedText<MQTT_TOPIC_CAPACITY> stateTopic;
+    FixedText<MQTT_TOPIC_CAPACITY> statusTopic;
+
+    // payload of the current cycle, only enqueued if a field changed
+    FixedText<MQTT_PAYLOAD_CAPACITY> scratch;
+
+    milliwatt_t powerDeadband = 0;
+
+    // last sent values in W and 0.1 %
+    int32_t sentSun = 0;
+    int32_t sentHouse = 0;
+    int32_t sentGrid = 0;
+    int32_t sentBattery = 0;
+    int32_t sentSoe = 0;
+    bool hasSent = false;
+    unsigned long fullStateAt = 0;
+
+    // ring of messages, queueFirst is the oldest
+    Message queue[MQTT_QUEUE_LENGTH];
+    uint8_t queueFirst = 0;
+    uint8_t queueCount = 0;
+
+    unsigned long reconnectAt = 0;
+    unsigned long reconnectDelay = MQTT_MIN_RECONNECT_MILLIS;
+
+    uint32_t publishedCount = 0;
+    uint32_t droppedCount = 0;
+    unsigned long lastLatency = 0;
+    unsigned long maxLatency = 0;
+};
+
+#endif
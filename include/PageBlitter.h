@@ -0,0 +1,73 @@
+#ifndef PAGE_BLITTER_H
+#define PAGE_BLITTER_H
+
+#include <Adafruit_SSD1306.h>
+#include <Arduino.h>
+
+// Characters available in the glyph atlas
+const char GLYPH_CHARS[] = " 0123456789.-%kW?";
+
+// Number of glyphs in the atlas
+const uint8_t GLYPH_COUNT = sizeof(GLYPH_CHARS) - 1;
+
+// Width of a glyph of the default 5x7 font including spacing
+const uint8_t GLYPH_WIDTH = 6;
+
+// Maximum width of a sprite
+const uint8_t MAX_SPRITE_WIDTH = 8;
+
+/**
+ * Small image converted to the display's page layout: one byte per column,
+ * bit 0 is the bottom row, at most 8 rows high. Rows are stored bottom up
+ * because the display is mounted upside down (rotation 2).
+ */
+struct Sprite {
+    uint8_t width;
+    uint8_t height;
+    uint8_t cols[MAX_SPRITE_WIDTH];
+};
+
+/**
+ * Fast drawing directly into the SSD1306 page buffer for a display with
+ * rotation 2. Coordinates are logical screen coordinates like with
+ * Adafruit_GFX, but drawing works on whole column bytes: text is blitted
+ * from a glyph atlas rasterized once with the GFX default font, images are
+ * ORed in as sprites and rectangles are set or cleared with bit masks.
+ */
+class PageBlitter {
+   public:
+    PageBlitter(Adafruit_SSD1306 &display) : display(display) {}
+
+    // Rasterizes the glyph atlas using the display's GFX text path, clears the display buffer
+    void begin();
+
+    // Copies a page ordered frame template from PROGMEM into the display buffer
+    void loadTemplate(const uint8_t *pages);
+
+    // Draws text with its top left corner at x, y (transparent background)
+    void drawText(int16_t x, int16_t y, const char *text);
+
+    // Draws a sprite with its top left corner at x, y (transparent background)
+    void drawSprite(int16_t x, int16_t y, const Sprite &sprite);
+
+    // Sets (white) or clears (black) a rectangle
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+    // Copies a rectangle of a page ordered frame template from PROGMEM into the display buffer
+    void restoreRect(const uint8_t *pages, int16_t x, int16_t y, int16_t w, int16_t h);
+
+    // Converts a GFX bitmap (rows, MSB first) of at most 8x8 pixels to a sprite
+    static Sprite spriteFromBitmap(const uint8_t *bitmap, uint8_t w, uint8_t h);
+
+   private:
+    // Replaces the bits of a rectangle, color SSD1306_WHITE / SSD1306_BLACK or from a template if pages is set
+    void applyRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color, const uint8_t *pages);
+
+    // ORs column bytes of height h into the buffer
+    void blit(int16_t x, int16_t y, uint8_t h, const uint8_t *cols, uint8_t w);
+
+    Adafruit_SSD1306 &display;
+    uint8_t atlas[GLYPH_COUNT][GLYPH_WIDTH];
+};
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef PHASE_PROFILER_H
+#define PHASE_PROFILER_H
+
+#include <Arduino.h>
+
+// Phases of the refresh cycle which are timed with MONITOR_PROFILING
+enum Phase : uint8_t {
+    PhaseLoop,      // one loop() iteration
+    PhasePoll,      // Modbus cycle from submit to the last response of all devices
+    PhaseSnapshot,  // snapshot of a finished poll and its consumers
+    PhaseFormat,    // number formatting of screen 1
+    PhaseCompose,   // drawing a screen into the display buffer
+    PhaseFlush,     // I2C transfer of the changed display ranges
+    PhaseWeb,       // web server and configuration portal
+    PHASE_COUNT
+};
+
+#ifdef MONITOR_PROFILING
+
+#include "FixedText.h"
+
+// Histogram buckets per power of two, the bucket width is 1/4 of its lower bound
+const uint8_t PROFILE_SUB_BUCKETS = 4;
+
+// Number of buckets, the last one covers everything from 2^24 us (16.7 s)
+const uint8_t PROFILE_BUCKETS = PROFILE_SUB_BUCKETS * 24;
+
+// Capacity of the profile report, one line per phase
+const size_t PROFILE_TEXT_CAPACITY = 640;
+
+/**
+ * Log bucket histogram of durations in microseconds. Bucket counts are
+ * 16 bit and all of them are halved when one would overflow, which keeps
+ * the shape of the distribution. Count, sum and maximum are exact.
+ */
+class PhaseHistogram {
+   public:
+    PhaseHistogram() { reset(); }
+
+    // Adds one duration
+    void add(uint32_t micros);
+
+    // Percentile p (0..100) as upper bound of its bucket, never above maxMicros()
+    uint32_t percentile(uint8_t p) const;
+
+    // Number of durations added since the last reset()
+    uint32_t count() const { return total; }
+
+    // Longest duration since the last reset()
+    uint32_t maxMicros() const { return longest; }
+
+    // Average duration since the last reset()
+    uint32_t meanMicros() const { return total > 0 ? sum / total : 0; }
+
+    void reset();
+
+   private:
+    // Bucket of a duration
+    static uint8_t bucketOf(uint32_t micros);
+
+    // Largest duration falling into bucket
+    static uint32_t upperBound(uint8_t bucket);
+
+    uint16_t buckets[PROFILE_BUCKETS];
+    uint32_t total;
+    uint32_t longest;
+    uint64_t sum;
+};
+
+/**
+ * Per phase histograms in static RAM. Phases within one function are
+ * timed with PROFILE_SCOPE using the CPU cycle counter, phases ending in
+ * a callback with PROFILE_BEGIN / PROFILE_END using micros(). The report
+ * is printed with the serial command "prof" and served on /profile,
+ * "prof reset" starts a new measurement window.
+ */
+class PhaseProfiler {
+   public:
+    // Adds a duration to the histogram of phase
+    void record(Phase phase, uint32_t micros) { histograms[phase].add(micros); }
+
+    // Marks the start of a phase which ends somewhere else
+    void begin(Phase phase) { started[phase] = micros() | 1; }
+
+    // Records the phase started by begin(), ignored if it was not started
+    void end(Phase phase);
+
+    const PhaseHistogram &histogram(Phase phase) const { return histograms[phase]; }
+
+    // Name of phase as shown in the report
+    static const char *name(Phase phase);
+
+    // Table with count, mean, p50, p95 and max of every phase in us
+    const FixedText<PROFILE_TEXT_CAPACITY> &report();
+
+    // Clears all histograms
+    void reset();
+
+    // Reads serial commands without blocking, to be called from loop()
+    void handleSerial(Stream &serial);
+
+   private:
+    PhaseHistogram histograms[PHASE_COUNT];
+    uint32_t started[PHASE_COUNT] = {};
+
+    char command[16];
+    uint8_t commandLength = 0;
+
+    FixedText<PROFILE_TEXT_CAPACITY> text;
+};
+
+/**
+ * Records the time from construction to the end of the enclosing scope,
+ * measured with the CPU cycle counter. The counter wraps after 26 s at
+ * 160 MHz, far longer than any phase timed this way.
+ */
+class PhaseTimer {
+   public:
+    PhaseTimer(PhaseProfiler &profiler, Phase phase) : profiler(profiler), phase(phase), start(ESP.getCycleCount()) {}
+
+    ~PhaseTimer() { profiler.record(phase, (ESP.getCycleCount() - start) / ESP.getCpuFreqMHz()); }
+
+   private:
+    PhaseProfiler &profiler;
+    Phase phase;
+    uint32_t start;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+// Times the rest of the enclosing scope as phase, uses the global profiler
+#define PROFILE_SCOPE(phase) PhaseTimer PROFILE_CONCAT(phaseTimer, __LINE__)(profiler, phase)
+#define PROFILE_BEGIN(phase) profiler.begin(phase)
+#define PROFILE_END(phase) profiler.end(phase)
+
+#else
+
+// Without MONITOR_PROFILING no code is generated at all
+#define PROFILE_SCOPE(phase)
+#define PROFILE_BEGIN(phase)
+#define PROFILE_END(phase)
+
+#endif
+
+#endif
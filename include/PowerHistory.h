@@ -0,0 +1,106 @@
+#ifndef POWER_HISTORY_H
+#define POWER_HISTORY_H
+
+#include <Arduino.h>
+
+#include "FixedPoint.h"
+#include "SolarSnapshot.h"
+
+// Recorded power values
+enum HistoryChannel {
+    HistorySun,
+    HistoryHouse,
+    HistoryGrid,
+    HistoryBattery,
+    HISTORY_CHANNELS
+};
+
+// Resolution of the history
+const unsigned long HISTORY_MINUTE_MILLIS = 60000UL;
+
+// Minutes per quantized block
+const uint8_t HISTORY_BLOCK_MINUTES = 60;
+
+// Closed blocks kept, together with the open block they cover 24 hours
+const uint8_t HISTORY_CLOSED_BLOCKS = 23;
+
+// History samples are stored in 10 W units
+const milliwatt_t HISTORY_MILLIWATT_PER_UNIT = 10000;
+
+// Marks a minute without polls
+const int16_t HISTORY_GAP = INT16_MIN;
+
+/**
+ * Power history of the last 24 hours at 1 minute resolution for sun,
+ * house, grid and battery. Polls are averaged per minute. The current hour
+ * is kept as int16 (10 W units), every closed hour is quantized to 8 bit
+ * between its own min and max, so 24 hours of 4 channels take about 7 kB
+ * instead of 11.5 kB. Min, max and average of each hour are kept exactly
+ * and updated incrementally. All queries decode straight from the ring
+ * buffer.
+ */
+class PowerHistory {
+   public:
+    // Adds the values of a poll to the current minute
+    void add(const SolarSnapshot &snapshot);
+
+    // Closes finished minutes, to be called at least once per minute
+    void tick();
+
+    // Number of the current minute since boot, increases with every tick() of a new minute
+    uint32_t currentMinute() const { return minute; }
+
+    // First minute still stored
+    uint32_t oldestMinute() const;
+
+    // Value of a minute in 10 W units, HISTORY_GAP if there was no poll or it is not stored
+    int16_t value(HistoryChannel c, uint32_t m) const;
+
+    // Min and max of the minutes [first, first + count), returns false if all of them are gaps
+    bool range(HistoryChannel c, uint32_t first, uint16_t count, int16_t &lo, int16_t &hi) const;
+
+    // Min and max of all stored minutes, from the block summaries
+    bool extremes(HistoryChannel c, int16_t &lo, int16_t &hi) const;
+
+    // Average of all stored minutes in 10 W units
+    int16_t average(HistoryChannel c) const;
+
+   private:
+    // Summary of one hour, updated with every minute
+    struct Summary {
+        int16_t min;
+        int16_t max;
+        int32_t sum;
+        uint8_t count;
+    };
+
+    // Closed hour: 8 bit samples between summary min and max, 255 = gap
+    struct ClosedBlock {
+        Summary summary[HISTORY_CHANNELS];
+        uint8_t samples[HISTORY_CHANNELS][HISTORY_BLOCK_MINUTES];
+    };
+
+    // Stores the average of the finished minute in the open block
+    void closeMinute();
+
+    // Quantizes the open block into the ring
+    void closeBlock();
+
+    static void addToSummary(Summary &summary, int16_t v);
+
+    // polls of the current minute
+    int32_t minuteSum[HISTORY_CHANNELS] = {};
+    uint16_t minuteCount = 0;
+    unsigned long minuteStart = 0;
+    uint32_t minute = 0;
+
+    // open hour in full resolution
+    int16_t open[HISTORY_CHANNELS][HISTORY_BLOCK_MINUTES];
+    Summary openSummary[HISTORY_CHANNELS] = {};
+    bool openInitialized = false;
+
+    ClosedBlock closed[HISTORY_CLOSED_BLOCKS];
+    uint8_t closedCount = 0;
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+
+// Longest single sleep, the web and Modbus servers answer within this time
+const uint32_t LOW_POWER_MAX_SLEEP_MILLIS = 500;
+
+// Sleep is split into slices of this length to react to the button interrupt
+const uint32_t LOW_POWER_SLICE_MILLIS = 50;
+
+// Shorter sleeps count as awake, the SDK does not enter light sleep for a few beacon intervals
+const uint32_t LIGHT_SLEEP_MIN_MILLIS = 100;
+
+// Beacon intervals the WiFi modem sleeps between two wakes in light sleep
+const uint8_t LIGHT_SLEEP_LISTEN_INTERVAL = 3;
+
+// Estimated supply current while the CPU runs and the modem is awake, without the OLED
+const uint16_t AWAKE_CURRENT_MILLIAMPS = 70;
+
+// Estimated average supply current in automatic light sleep, including the beacon wakes
+const uint16_t LIGHT_SLEEP_CURRENT_MILLIAMPS = 3;
+
+/**
+ * Low power mode while nobody looks at the display. The WiFi modem is put
+ * into light sleep, which the SDK enters automatically while loop() waits
+ * in delay(), so the station stays associated and all servers keep
+ * working with a higher latency. A rising edge on the button pin sets a
+ * flag from an interrupt, which replaces the OneButton polling while in
+ * low power mode. Measures the share of time awake and estimates the
+ * average current from it: only sleeps of at least LIGHT_SLEEP_MIN_MILLIS
+ * count as light sleep, everything else, including short sleeps, as awake.
+ * The number of wakes shows how often the loop actually ran.
+ */
+class PowerManager {
+   public:
+    // Attaches the wake interrupt to the active HIGH button at pin
+    void begin(uint8_t pin);
+
+    // Enters or leaves low power mode, ignored if unchanged
+    void setLowPower(bool enabled);
+
+    // Is low power mode active?
+    bool lowPower() const { return active; }
+
+    // Sleeps up to maxMillis, at most LOW_POWER_MAX_SLEEP_MILLIS, ends early when the button is pressed
+    void sleep(uint32_t maxMillis);
+
+    // Was the button pressed since low power mode was entered? Clears the flag
+    bool takeWake();
+
+    // Share of time not spent in light sleep since the last resetStats(), in 0.1 %
+    uint16_t dutyCyclePermille() const;
+
+    // Number of sleeps ended since the last resetStats()
+    uint32_t wakes() const { return wakeCount; }
+
+    // Estimated average supply current since the last resetStats()
+    uint16_t averageCurrentMilliamps() const;
+
+    // Starts a new measurement window
+    void resetStats();
+
+   private:
+    static void IRAM_ATTR onButton();
+
+    static volatile bool pressed;
+
+    bool active = false;
+    uint32_t windowStart = 0;
+    uint32_t sleptMillis = 0;
+    uint32_t wakeCount = 0;
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef READ_PLANNER_H
+#define READ_PLANNER_H
+
+#include <Arduino.h>
+
+#include "FixedPoint.h"
+#include "SunSpecRegisters.h"
+
+/**
+ * Holds the block reads of a PlanLayout and decodes fields from the
+ * returned registers. The reads are executed by a ModbusPipeline, all
+ * values of one execution come from the same poll cycle.
+ */
+class ReadPlanner {
+   public:
+    ReadPlanner() = default;
+    explicit ReadPlanner(const PlanLayout &layout) : layout(layout) {}
+
+    // Replaces the layout, e.g. after block bases changed
+    void setLayout(const PlanLayout &newLayout);
+
+    // Is the layout executable?
+    bool valid() const { return layout.valid && layout.blockCount > 0; }
+
+    // Is the field part of the layout?
+    bool contains(Field f) const { return layout.slot[f] >= 0; }
+
+    // Raw first register of a field from the last execution
+    uint16_t uint16(Field f) const;
+
+    // Signed first register of a field from the last execution
+    int16_t int16(Field f) const { return (int16_t)uint16(f); }
+
+    // Two register field in the word order of its type
+    uint32_t uint32(Field f) const;
+
+    /**
+     * Decodes a field as fixed point round(value * scale) according to its
+     * type. For integer registers the scale factor sf is applied, floats
+     * carry their own exponent.
+     */
+    int32_t fixed(Field f, int32_t scale, int16_t sf = 0) const;
+
+    // Number of blocks (= Modbus transactions) per execution
+    uint8_t blockCount() const { return layout.blockCount; }
+
+    // Start address and size of a block
+    uint16_t blockStart(uint8_t i) const { return layout.start[i]; }
+    uint16_t blockSize(uint8_t i) const { return layout.count[i]; }
+
+    // Registers of a block from the last execution
+    const uint16_t *blockValues(uint8_t i) const { return &buffer[layout.bufferOffset[i]]; }
+
+    // Destination of the registers of a block
+    uint16_t *blockBuffer(uint8_t i) { return &buffer[layout.bufferOffset[i]]; }
+
+   protected:
+    PlanLayout layout = {};
+
+   private:
+    uint16_t buffer[MAX_PLAN_REGS];
+};
+
+/**
+ * Read plan for a fixed set of fields whose block layout is computed at
+ * compile time. Accessing a field outside the set fails to compile.
+ */
+template <uint64_t Mask>
+class BlockPlan : public ReadPlanner {
+   public:
+    static constexpr PlanLayout LAYOUT = planFields(Mask);
+    static_assert(LAYOUT.valid, "fields do not fit into the block and buffer limits");
+
+    BlockPlan() : ReadPlanner(LAYOUT) {}
+
+    // Recomputes the layout for other block bases
+    void rebase(const BlockBases &bases) { setLayout(planFields(Mask, bases)); }
+
+    template <Field F>
+    uint16_t uint16() const {
+        static_assert(Mask & fieldBit(F), "field is not part of this plan");
+        return ReadPlanner::uint16(F);
+    }
+
+    template <Field F>
+    int16_t int16() const {
+        static_assert(Mask & fieldBit(F), "field is not part of this plan");
+        return ReadPlanner::int16(F);
+    }
+
+    template <Field F>
+    int32_t fixed(int32_t scale, int16_t sf = 0) const {
+        static_assert(Mask & fieldBit(F), "field is not part of this plan");
+        static_assert(SUNSPEC_REGISTERS[F].type != RegType::ScaleFactor, "scale factors are read with int16()");
+        return ReadPlanner::fixed(F, scale, sf);
+    }
+};
+
+template <uint64_t Mask>
+constexpr PlanLayout BlockPlan<Mask>::LAYOUT;
+
+#endif
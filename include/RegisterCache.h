@@ -0,0 +1,85 @@
+#ifndef REGISTER_CACHE_H
+#define REGISTER_CACHE_H
+
+#include <Arduino.h>
+
+#include "FixedPoint.h"
+#include "ReadPlanner.h"
+
+// Fields of a device read once per connection, meters and batteries are bit masks (bit 0 = M1 / B1)
+constexpr uint64_t metadataFields(uint8_t meters, uint8_t batteries) {
+    uint64_t mask = fieldBit(F_I_MODEL_ID);
+    for (uint8_t i = 0; i < MAX_METERS; i++) {
+        if (meters & (1 << i)) {
+            mask |= fieldBit(METER_MODEL_ID[i]);
+        }
+    }
+    for (uint8_t i = 0; i < MAX_BATTERIES; i++) {
+        if (batteries & (1 << i)) {
+            mask |= fieldBit(BATTERY_RATED_ENERGY[i]) | fieldBit(BATTERY_MAX_CHARGE_POWER[i]) | fieldBit(BATTERY_MAX_DISCHARGE_POWER[i]);
+        }
+    }
+    return mask;
+}
+
+// Metadata of a device with all meters and batteries
+constexpr uint64_t ALL_METADATA_FIELDS = metadataFields(0x07, 0x03);
+
+static_assert(planFields(ALL_METADATA_FIELDS).valid, "metadata of all meters and batteries must fit into one plan");
+
+// Powers above this are considered a decoding error
+const milliwatt_t MAX_PLAUSIBLE_MILLIWATT = 100000000L;
+
+/**
+ * Register values of one device which do not change while connected:
+ * SunSpec model IDs and the battery nameplates. Filled once per connection
+ * from a metadata read plan and invalidated on disconnect or when a poll
+ * fails the sanity check. Scale factors are not cached, SolarEdge
+ * inverters change them from poll to poll.
+ */
+class RegisterCache {
+   public:
+    // Fills the cache from the fields of an executed plan, returns false if the values are not plausible
+    bool load(const ReadPlanner &plan);
+
+    // Drops all cached values
+    void invalidate();
+
+    // Are the cached values usable?
+    bool isValid() const { return valid; }
+
+    // Counts a poll checked against the cached values
+    void countHit() { hitCount++; }
+
+    // Returns false if an inverter or meter power is out of any range
+    bool plausiblePower(milliwatt_t power) const;
+
+    // Returns false if a battery power contradicts the nameplate of battery i
+    bool plausibleBattery(uint8_t battery, milliwatt_t power) const;
+
+    uint16_t inverterModelId() const { return inverterModel; }
+    uint16_t meterModelId(uint8_t meter) const { return meterModel[meter]; }
+    int32_t batteryRatedEnergyWh(uint8_t battery) const { return ratedEnergyWh[battery]; }
+    milliwatt_t batteryMaxChargePower(uint8_t battery) const { return maxCharge[battery]; }
+    milliwatt_t batteryMaxDischargePower(uint8_t battery) const { return maxDischarge[battery]; }
+
+    // Number of polls checked against the cache
+    uint32_t hits() const { return hitCount; }
+
+    // Number of times the cache had to be (re)filled
+    uint32_t misses() const { return missCount; }
+
+   private:
+    bool valid = false;
+
+    uint16_t inverterModel = 0;
+    uint16_t meterModel[MAX_METERS] = {};
+    int32_t ratedEnergyWh[MAX_BATTERIES] = {};
+    milliwatt_t maxCharge[MAX_BATTERIES] = {};
+    milliwatt_t maxDischarge[MAX_BATTERIES] = {};
+
+    uint32_t hitCount = 0;
+    uint32_t missCount = 0;
+};
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef REGISTER_MIRROR_H
+#define REGISTER_MIRROR_H
+
+#include <Arduino.h>
+#include <ModbusSolarEdge.h>
+
+#include "ModbusPipeline.h"
+#include "ReadPlanner.h"
+#include "SunSpecRegisters.h"
+
+// Number of register ranges served by the mirror
+const uint8_t MIRROR_RANGE_COUNT = 4;
+
+// Default maximum age of served registers
+const uint32_t DEFAULT_MIRROR_MAX_AGE_MILLIS = 5000;
+
+// A range is kept fresh this long after the last client read
+const uint32_t MIRROR_DEMAND_WINDOW_MILLIS = 60000;
+
+// Number of client reads which can wait for an upstream read at the same time
+const uint8_t MIRROR_HELD_READS = 4;
+
+// A waiting read is answered "target failed to respond" after this time, covers a request with its retries
+const uint32_t MIRROR_HOLD_MILLIS = 3000;
+
+/**
+ * Local Modbus TCP server answering holding register reads of the
+ * inverter, meter 1 and battery 1 blocks from a cache, so any number of
+ * clients cost the inverter one connection and one read per range and
+ * max age. A read of a range that is older than the max age waits for the
+ * range to be fetched upstream once, no matter how many clients asked, and
+ * is then answered from the cache through the library's raw response. Only
+ * one read per client IP can wait, as the library sends a raw response to
+ * the first connection of that IP; further reads are rejected with "slave
+ * device busy" like when all MIRROR_HELD_READS are taken.
+ * Ranges read by clients are refreshed ahead of expiry for
+ * MIRROR_DEMAND_WINDOW_MILLIS, so periodic clients usually hit the cache.
+ * The mirror is read only, writes are rejected.
+ */
+class RegisterMirror {
+   public:
+    RegisterMirror(ModbusIP &server, ModbusPipeline &upstream);
+
+    // Adds the ranges for the block bases and starts the server on port
+    void begin(uint16_t port, uint32_t maxAgeMillis, const BlockBases &bases = DEFAULT_BLOCK_BASES);
+
+    // Moves the ranges to new block bases, e.g. after a discovery, once no upstream read is pending
+    void rebase(const BlockBases &bases);
+
+    // Serves clients and fetches requested ranges while upstream is connected, to be called every loop
+    void task(bool upstreamReady);
+
+    // Is the server running?
+    bool enabled() const { return running; }
+
+    // Number of reads answered from the cache since boot
+    uint32_t hits() const { return hitCount; }
+
+    // Number of reads which were held or rejected as busy because the range was too old since boot
+    uint32_t misses() const { return missCount; }
+
+    // Number of upstream reads since boot
+    uint32_t fetches() const { return fetchCount; }
+
+   private:
+    struct Range {
+        uint16_t start;
+        uint16_t count;
+        uint32_t fetchedAt;
+        uint32_t requestedAt;
+        bool fetched;
+        bool wanted;
+    };
+
+    // Client read waiting for an upstream read
+    struct HeldRead {
+        IPAddress client;
+        uint16_t transaction;
+        uint16_t first;
+        uint16_t count;
+        uint32_t heldAt;
+        uint8_t unit;
+        bool used;
+    };
+
+    // ModbusIP: checks a client request before the library processes it
+    static Modbus::ResultCode onRequest(Modbus::FunctionCode fc, const Modbus::RequestData data);
+
+    // ModbusIP: sees a request PDU before onRequest, may hold it back
+    static Modbus::ResultCode onRaw(uint8_t *data, uint8_t length, void *custom);
+
+    // Pipeline: upstream read of fetchPlan finished
+    static void onFetched(ReadPlanner &plan, bool success);
+
+    // Is the range younger than the max age?
+    bool fresh(const Range &range, uint32_t now) const;
+
+    // Do the ranges hold all registers of a read?
+    bool covers(uint16_t first, uint16_t count) const;
+
+    // Are all ranges of a read younger than the max age?
+    bool freshRead(uint16_t first, uint16_t count, uint32_t now) const;
+
+    // Marks the ranges of a read as requested and the outdated ones for an upstream read, returns true if one is outdated
+    bool request(uint16_t first, uint16_t count, uint32_t now);
+
+    // Answers from the cache or marks the requested ranges for an upstream read
+    Modbus::ResultCode check(Modbus::FunctionCode fc, const Modbus::RequestData &data);
+
+    // Holds a read of outdated ranges until they are fetched, returns EX_PASSTHROUGH to leave it to check()
+    Modbus::ResultCode hold(const uint8_t *pdu, uint8_t length, const Modbus::frame_arg_t &header);
+
+    // Answers the held reads whose ranges are fresh, fails those touching failedRange, not covered anymore or too old
+    void answerHeld(int8_t failedRange);
+
+    // Copies a fetched range into the server registers
+    void stored(bool success);
+
+    // Replaces the ranges and their server registers, unless they already start at bases
+    void setRanges(const BlockBases &bases);
+
+    ModbusIP &server;
+    ModbusPipeline &upstream;
+
+    Range ranges[MIRROR_RANGE_COUNT] = {};
+    uint32_t maxAge = DEFAULT_MIRROR_MAX_AGE_MILLIS;
+    bool running = false;
+    bool upstreamUp = false;
+
+    // one upstream read at a time, -1 = none; a cancel() of upstream since fetchCancels drops it
+    ReadPlanner fetchPlan;
+    int8_t fetching = -1;
+    uint32_t fetchCancels = 0;
+
+    HeldRead held[MIRROR_HELD_READS] = {};
+
+    // bases applied by the next task() without a pending read
+    BlockBases pendingBases = {};
+    bool rebasing = false;
+
+    uint32_t hitCount = 0;
+    uint32_t missCount = 0;
+    uint32_t fetchCount = 0;
+
+    // mirror which receives the static callbacks
+    static RegisterMirror *instance;
+};
+
+#endif
@@ -0,0 +1,154 @@
+#ifndef SAMPLE_LOG_H
+#define SAMPLE_LOG_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+
+#include "FixedPoint.h"
+#include "SolarSnapshot.h"
+
+// Size of a block on flash, one chunk of a download
+const uint16_t SAMPLE_BLOCK_SIZE = 512;
+
+// Blocks in the ring, 512 kB hold several days of 5 s polls
+const uint16_t SAMPLE_LOG_BLOCKS = 1024;
+
+// Blocks per segment file, the ring drops the oldest segment as a whole
+const uint16_t SAMPLE_SEGMENT_BLOCKS = 16;
+
+// Segment files in the ring
+const uint8_t SAMPLE_LOG_SEGMENTS = SAMPLE_LOG_BLOCKS / SAMPLE_SEGMENT_BLOCKS;
+
+// Columns of a sample: time (s since 1970), sun, house, grid, battery (W), state of energy (0.1 %)
+const uint8_t SAMPLE_COLUMNS = 6;
+
+// Block header as stored on flash, followed by the encoded columns
+struct SampleBlockHeader {
+    // SAMPLE_BLOCK_MAGIC
+    uint16_t magic;
+    // number of samples
+    uint8_t count;
+    // number of columns, SAMPLE_COLUMNS
+    uint8_t columns;
+    // increases with every block written, 0 = free slot
+    uint32_t sequence;
+    // time of the first sample
+    uint32_t firstTime;
+    // bytes of encoded columns after the header
+    uint16_t length;
+    uint16_t reserved;
+};
+
+// Encoded columns per block
+const uint16_t SAMPLE_PAYLOAD_SIZE = SAMPLE_BLOCK_SIZE - sizeof(SampleBlockHeader);
+
+/**
+ * Raw samples on flash for offline analysis. Samples are collected in RAM
+ * as rows of zigzag varint deltas to the previous sample. When a block is
+ * full, the rows are transposed into columns, so every column of a block
+ * is one run of small deltas, and the block is appended by task() to the
+ * newest of a ring of segment files on LittleFS. A block is never
+ * rewritten: LittleFS copies a file from the changed position to its end,
+ * so the ring deletes its oldest segment file when it needs a new one. The
+ * block headers at fixed offsets of a segment are its index for the lookup
+ * of a time range.
+ *
+ * A download streams the blocks of a time range straight from flash with
+ * chunked transfer encoding, one block per chunk and only as fast as the
+ * socket takes them. tools/decode_samples.py decodes the blocks.
+ */
+class SampleLog {
+   public:
+    // Opens the ring and finds the newest block, the file system must be mounted
+    bool begin();
+
+    // Adds a sample, only copies it into RAM
+    void add(uint32_t time, const SolarSnapshot &snapshot);
+
+    // Writes a full block and continues downloads, to be called every loop
+    void task();
+
+    // Writes the samples collected in RAM, e.g. before a restart
+    void flush();
+
+    // Takes over the client of the current request and streams the blocks from `from` to `to`, false if busy
+    bool download(WiFiClient &client, uint32_t from, uint32_t to);
+
+    // Is a download being streamed?
+    bool downloadActive() const { return downloading; }
+
+    // Number of blocks stored on flash
+    uint16_t blocks() const { return blockCount; }
+
+    // Number of blocks written since boot
+    uint32_t writes() const { return writeCount; }
+
+    // Number of full blocks dropped because the previous one was not written yet or writing failed
+    uint32_t dropped() const { return droppedCount; }
+
+   private:
+    // Index entry of a block
+    struct IndexEntry {
+        uint32_t sequence;
+        uint32_t firstTime;
+    };
+
+    // Transposes the collected rows into a block
+    void seal(uint8_t *block, uint32_t sequence) const;
+
+    // Appends the sealed block to the newest segment
+    bool writeBlock();
+
+    // Starts a new segment file, deletes the oldest one if the ring is full
+    void startSegment();
+
+    // Reads the block at position i (0 = oldest), only the header if size is the header size
+    bool readBlock(uint16_t i, uint8_t *block, size_t size);
+
+    // Index entry of the i-th oldest block
+    bool readIndex(uint16_t i, IndexEntry &entry);
+
+    // Slot of the oldest segment
+    uint8_t oldestSegment() const { return (headSegment + SAMPLE_LOG_SEGMENTS + 1 - segments) % SAMPLE_LOG_SEGMENTS; }
+
+    // Sends the next chunk of the download, false when the socket is full or the download ended
+    bool sendNext();
+
+    // Sends a block as one chunk
+    void sendChunk(const uint8_t *block);
+
+    // Ends the download with the block being collected and the last chunk
+    void endDownload();
+
+    bool ready = false;
+
+    // rows of the block being collected
+    uint8_t rows[SAMPLE_PAYLOAD_SIZE];
+    uint16_t rowsLength = 0;
+    uint8_t rowCount = 0;
+    uint32_t firstTime = 0;
+    int32_t previous[SAMPLE_COLUMNS] = {};
+
+    // block waiting for task()
+    uint8_t sealed[SAMPLE_BLOCK_SIZE];
+    bool sealedPending = false;
+
+    // ring state: segments in use, the newest is appended to
+    uint8_t segments = 0;
+    uint8_t headSegment = 0;
+    uint16_t headBlocks = 0;
+    uint16_t blockCount = 0;
+    uint32_t sequence = 0;
+
+    // download state, position of the next block counted from the oldest
+    WiFiClient client;
+    bool downloading = false;
+    uint16_t downloadBlock = 0;
+    uint32_t downloadSequence = 0;
+    uint32_t downloadTo = 0;
+
+    uint32_t writeCount = 0;
+    uint32_t droppedCount = 0;
+};
+
+#endif
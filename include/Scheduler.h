@@ -0,0 +1,66 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+
+// Maximum number of tasks the scheduler can hold
+const uint8_t MAX_TASKS = 16;
+
+// A task step, must return within a few milliseconds
+typedef void (*TaskCallback)();
+
+/**
+ * Minimal cooperative scheduler. Every task is a millis based state machine
+ * whose step is called from loop() when its interval has elapsed. The
+ * scheduler also measures the time between two calls of run(), which is the
+ * duration of one loop() iteration unless the loop slept in between.
+ */
+class Scheduler {
+   public:
+    // Adds a task which is run every intervalMs milliseconds, 0 = every loop; a pausable task is skipped while paused
+    bool addTask(const char *name, TaskCallback callback, uint32_t intervalMs, bool pausable = false);
+
+    // Pauses or resumes the pausable tasks, e.g. the display tasks while the display is off
+    void setPaused(bool pause) { paused = pause; }
+
+    // Runs all due tasks, to be called once per loop()
+    void run();
+
+    // Time until the next running task with an interval is due, 0 if one is overdue, UINT32_MAX if there is none
+    uint32_t millisUntilDue() const;
+
+    // Worst case loop() iteration time in microseconds since the last resetLatency()
+    uint32_t maxLoopMicros() const { return maxLoop; }
+
+    // Worst case single task step in microseconds since the last resetLatency()
+    uint32_t maxTaskMicros() const { return maxTask; }
+
+    // Name of the task which caused maxTaskMicros()
+    const char *slowestTask() const { return slowest; }
+
+    // Starts a new measurement window
+    void resetLatency();
+
+    // Starts the next loop() measurement now, e.g. after a sleep which is no loop latency
+    void markAwake() { lastRunMicros = micros(); }
+
+   private:
+    struct Task {
+        const char *name;
+        TaskCallback callback;
+        uint32_t intervalMs;
+        uint32_t lastRunMs;
+        bool pausable;
+    };
+
+    Task tasks[MAX_TASKS];
+    uint8_t taskCount = 0;
+    bool paused = false;
+
+    uint32_t lastRunMicros = 0;
+    uint32_t maxLoop = 0;
+    uint32_t maxTask = 0;
+    const char *slowest = "";
+};
+
+#endif
@@ -0,0 +1,220 @@
+#ifndef SOLAR_SITE_H
+#define SOLAR_SITE_H
+
+#include <Arduino.h>
+#include <ModbusSolarEdge.h>
+
+#include "FixedPoint.h"
+#include "LayoutCache.h"
+#include "ModbusPipeline.h"
+#include "ModelDiscovery.h"
+#include "ReadPlanner.h"
+#include "RegisterCache.h"
+#include "SolarSnapshot.h"
+
+// Inverters polled together, e.g. a leader and its followers
+const uint8_t MAX_DEVICES = 3;
+
+static_assert(MAX_DEVICES <= MAX_CACHED_LAYOUTS, "the layouts of all devices must fit into the flash cache");
+
+// Failed metadata reads in a row after which a cached layout is walked again, e.g. when the inverter rejects its addresses
+const uint8_t LAYOUT_RETRY_FAILURES = 3;
+
+// Fields of a device read on every poll, each power with the scale factor next to it in the same block
+constexpr uint64_t usageFields(uint8_t meters, uint8_t batteries) {
+    uint64_t mask = fieldMask({F_I_AC_POWER, F_I_AC_POWER_SF});
+    for (uint8_t i = 0; i < MAX_METERS; i++) {
+        if (meters & (1 << i)) {
+            mask |= fieldBit(METER_AC_POWER[i]) | fieldBit(METER_AC_POWER_SF[i]);
+        }
+    }
+    for (uint8_t i = 0; i < MAX_BATTERIES; i++) {
+        if (batteries & (1 << i)) {
+            mask |= fieldBit(BATTERY_POWER[i]) | fieldBit(BATTERY_STATE_OF_ENERGY[i]);
+        }
+    }
+    return mask;
+}
+
+// Inverter, M1 and B1 take one read per block; further meters and batteries add one read each
+static_assert(planFields(usageFields(0x01, 0x01)).blockCount == 3, "usage poll must stay at one read per block");
+static_assert(planFields(usageFields(0x07, 0x03)).valid, "usage of all meters and batteries must fit into one plan");
+
+// Address and equipment of one inverter
+struct DeviceConfig {
+    IPAddress remote;
+    uint16_t port;
+    uint8_t unit;
+
+    // meters (bit 0 = M1) and batteries (bit 0 = B1) reported by the inverter
+    uint8_t meters;
+    uint8_t batteries;
+};
+
+/**
+ * All inverters of an installation with their meters and batteries. Each
+ * address gets its own ModbusIP connection and pipeline, inverters behind
+ * the same address (e.g. followers reached through the leader) share it
+ * and are told apart by unit ID. A poll cycle submits the reads of all
+ * devices at once, so it takes about as long as the slowest device. The
+ * cycle succeeds only if every device answered with plausible values, the
+ * screens show the totals of all devices. Each power is decoded with the
+ * scale factor read in the same block, SolarEdge inverters change the
+ * factors from poll to poll.
+ *
+ * The block bases of a device come from its SunSpec model chain. A device
+ * without a known layout walks the chain in its metadata cycle before the
+ * metadata is read; the layout is cached in flash, so later boots read the
+ * metadata at the cached bases right away. Each metadata cycle of a known
+ * layout first checks what it cannot explain (a model appended to the
+ * chain, a configured battery it lacks), and the metadata read doubles as
+ * validation of the model IDs it has. If either disagrees, the chain is
+ * walked again within the same cycle; after LAYOUT_RETRY_FAILURES failed
+ * reads in a row, in the next metadata cycle. Configured meters and
+ * batteries which the discovery did not find are left out of the reads.
+ */
+class SolarSite {
+   public:
+    // Adds an inverter, the first one is the leader, returns false if the list is full
+    bool addDevice(const DeviceConfig &config);
+
+    // Number of configured inverters
+    uint8_t deviceCount() const { return devices; }
+
+    // Number of distinct addresses
+    uint8_t connectionCount() const { return connections; }
+
+    // Configuration of inverter i
+    const DeviceConfig &device(uint8_t i) const { return deviceList[i].config; }
+
+    // Pipeline of the leader, e.g. for the local Modbus server
+    ModbusPipeline &leaderPipeline() { return connectionList[0].pipeline; }
+
+    // Switches all connections to client mode and applies the layouts cached in flash
+    void begin();
+
+    // Connects all disconnected addresses (blocking, bounded by the WiFiClient timeout), returns the number connected
+    uint8_t connect();
+
+    // Are all addresses connected?
+    bool isConnected();
+
+    // Forgets all cycles without calling their callbacks
+    void cancel();
+
+    // Drops the cached metadata of all inverters
+    void invalidate();
+
+    // Is the metadata of all inverters cached?
+    bool metadataValid() const;
+
+    // Submits the discovery or metadata reads of inverters without cache, or else the usage reads of all, false if one failed
+    bool submit(CycleCallback callback);
+
+    // Handles the completion of one device read, returns true when the whole cycle is finished
+    bool finish(ReadPlanner &plan, bool success);
+
+    // Did all devices of the finished cycle succeed?
+    bool cycleSucceeded() const { return !cycleFailed; }
+
+    // Totals of the last usage cycle: inverter, grid and battery power, state of energy
+    void aggregate(SolarSnapshot &snapshot) const;
+
+    // Sends requests and handles responses of all connections, to be called every loop
+    void task();
+
+    // Block bases of the leader, e.g. for the local Modbus server
+    const BlockBases &leaderBases() const { return devices > 0 ? deviceList[0].layout.bases : DEFAULT_BLOCK_BASES; }
+
+    // Is the layout of inverter i known, from flash or discovery?
+    bool hasLayout(uint8_t i) const { return deviceList[i].layoutKnown; }
+
+    // Number of model chain walks since boot
+    uint32_t discoveries() const { return discoveryCount; }
+
+    // Flash cache of the discovered layouts
+    const LayoutCache &layoutCache() const { return layouts; }
+
+    // Duration of the last cycle from submit until the slowest device finished
+    uint32_t lastCycleMillis() const { return lastCycle; }
+
+    // Counters of all pipelines since boot
+    uint32_t requests() const;
+    uint32_t retries() const;
+    uint32_t timeouts() const;
+    uint32_t lateResponses() const { return ModbusPipeline::lateResponses(); }
+    uint8_t maxInFlight() const;
+
+    // Counters of all register caches since boot
+    uint32_t cacheHits() const;
+    uint32_t cacheMisses() const;
+
+   private:
+    // One address with its client and pipeline
+    struct Connection {
+        Connection() : pipeline(mb) {}
+
+        ModbusIP mb;
+        ModbusPipeline pipeline;
+        IPAddress remote;
+        uint16_t port;
+        uint8_t unit;
+    };
+
+    // One inverter with its plans and the values of its last poll
+    struct Device {
+        DeviceConfig config;
+        uint8_t connection;
+
+        // block bases and the configured meters and batteries which were found
+        DeviceLayout layout = {};
+        bool layoutKnown = false;
+        bool rediscovered = false;
+        uint8_t metadataFailures = 0;
+        uint8_t meters = 0;
+        uint8_t batteries = 0;
+
+        ModelDiscovery discovery;
+        ReadPlanner usage;
+        ReadPlanner metadata;
+        RegisterCache cache;
+
+        milliwatt_t inverterPower;
+        milliwatt_t meterPower;
+        milliwatt_t batteryPower[MAX_BATTERIES];
+        decipercent_t batteryStateOfEnergy[MAX_BATTERIES];
+    };
+
+    // Decodes the last usage read of a device, returns false if a value is missing or not plausible
+    bool decode(Device &device);
+
+    // Plans the reads of a device for its layout
+    void applyLayout(Device &device, const DeviceLayout &layout);
+
+    // Do the model IDs of the metadata match the layout of the device?
+    bool matchesLayout(const Device &device) const;
+
+    // Starts the walk of the model chain of a device
+    void startDiscovery(Device &device);
+
+    // Submits a read of the current cycle for a device, the cycle is cancelled if it does not fit
+    bool resubmit(Device &device, ReadPlanner &plan);
+
+    Connection connectionList[MAX_DEVICES];
+    uint8_t connections = 0;
+
+    Device deviceList[MAX_DEVICES];
+    uint8_t devices = 0;
+
+    LayoutCache layouts;
+    uint32_t discoveryCount = 0;
+
+    // cycle in progress
+    CycleCallback cycleCallback = nullptr;
+    uint8_t pending = 0;
+    bool cycleFailed = false;
+    uint32_t cycleStartedAt = 0;
+    uint32_t lastCycle = 0;
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef SOLAR_SNAPSHOT_H
+#define SOLAR_SNAPSHOT_H
+
+#include <Arduino.h>
+
+#include "FixedPoint.h"
+
+/**
+ * Normalized values of one poll. All values are taken from the same set of
+ * block reads and kept in fixed point, powers are in mW.
+ */
+struct SolarSnapshot {
+    // Incremented with every acquisition, 0 = no data yet
+    uint32_t sequence;
+
+    // millis() when the poll finished
+    unsigned long acquiredAt;
+
+    // AC power of the inverter, scale factor applied
+    milliwatt_t inverterPower;
+
+    // Power at meter M1, positive = export to grid, negative = import
+    milliwatt_t meterPower;
+
+    // Battery B1 power, positive = charging, negative = discharging
+    milliwatt_t batteryPower;
+
+    // Battery B1 state of energy
+    decipercent_t batteryStateOfEnergy;
+
+    // (A) power produced by the solar panels
+    milliwatt_t sunPower;
+
+    // (B) power used by the house
+    milliwatt_t houseUsage;
+};
+
+/**
+ * Double buffered snapshot store. Acquisition fills the back buffer and
+ * publishes it with commit(), renderers only read latest(), so they never
+ * see a half written snapshot.
+ */
+class SnapshotStore {
+   public:
+    // Returns the back buffer to be filled by acquisition
+    SolarSnapshot &beginWrite() { return buffers[front ^ 1]; }
+
+    // Publishes the back buffer as the latest snapshot
+    void commit() {
+        SolarSnapshot &back = buffers[front ^ 1];
+        back.sequence = buffers[front].sequence + 1;
+        back.acquiredAt = millis();
+        front ^= 1;
+    }
+
+    // Latest published snapshot, sequence is 0 if nothing was acquired yet
+    const SolarSnapshot &latest() const { return buffers[front]; }
+
+    // Returns true if there is data
+    bool hasData() const { return buffers[front].sequence != 0; }
+
+    // Age of the latest snapshot in milliseconds
+    unsigned long age() const { return millis() - buffers[front].acquiredAt; }
+
+    // Returns true if the latest snapshot is older than maxAgeMillis
+    bool isStale(unsigned long maxAgeMillis) const { return age() > maxAgeMillis; }
+
+   private:
+    SolarSnapshot buffers[2] = {};
+    uint8_t front = 0;
+};
+
+#endif
@@ -0,0 +1,305 @@
+#ifndef SUNSPEC_REGISTERS_H
+#define SUNSPEC_REGISTERS_H
+
+#include <Arduino.h>
+#include <ModbusSolarEdge.h>
+
+#include <initializer_list>
+
+// Maximum number of holding registers a single Modbus read may request
+const uint16_t MAX_BLOCK_REGS = 125;
+
+// Number of unused registers tolerated between two fields before a new block is started
+const uint16_t MAX_BLOCK_GAP = 16;
+
+// Maximum number of blocks a plan can be split into, metadata of three meters and two batteries takes 9
+const uint8_t MAX_PLAN_BLOCKS = 10;
+
+// Size of the register buffer shared by all blocks of a plan
+const uint16_t MAX_PLAN_REGS = 128;
+
+// Register blocks with a fixed start address per installation
+enum RegisterBlockId : uint8_t {
+    InverterBlock,
+    Meter1Block,
+    Battery1Block,
+    Meter2Block,
+    Meter3Block,
+    Battery2Block,
+    BLOCK_COUNT
+};
+
+// Distance between the models of two meters (common block plus meter model)
+const uint16_t SUNSPEC_METER_SPACING = 174;
+
+// Distance between the info blocks of two batteries
+const uint16_t SOLAREDGE_BATTERY_SPACING = 0x100;
+
+// Start addresses of the blocks, anchored to the address convention of the ModbusSolarEdge helper
+struct BlockBases {
+    uint16_t base[BLOCK_COUNT];
+};
+
+constexpr BlockBases DEFAULT_BLOCK_BASES = {{
+    I_AC_POWER - 14,                                           // inverter model C_SunSpec_DID (40069)
+    M1_AC_POWER - 18,                                          // meter 1 model C_SunSpec_DID (40188)
+    B1_INSTANTANEOUS_POWER - 0x74,                             // battery 1 info block (0xE100)
+    M1_AC_POWER - 18 + SUNSPEC_METER_SPACING,                  // meter 2 model (40362)
+    M1_AC_POWER - 18 + 2 * SUNSPEC_METER_SPACING,              // meter 3 model (40536)
+    B1_INSTANTANEOUS_POWER - 0x74 + SOLAREDGE_BATTERY_SPACING  // battery 2 info block (0xE200)
+}};
+
+// Encoding of a register value
+enum class RegType : uint8_t {
+    Int16,
+    Uint16,
+    ScaleFactor,
+    Acc32,      // SunSpec accumulator, high word first
+    Float32Le,  // SolarEdge battery float, low word first
+    Uint32Le    // SolarEdge battery integer, low word first
+};
+
+// Physical unit of a register value after applying its scale factor
+enum class Unit : uint8_t {
+    None,
+    Watt,
+    WattHour,
+    Volt,
+    Percent
+};
+
+// All known fields, index into SUNSPEC_REGISTERS
+enum Field : uint8_t {
+    F_I_MODEL_ID,
+    F_I_AC_VOLTAGE_AN,
+    F_I_AC_VOLTAGE_SF,
+    F_I_AC_POWER,
+    F_I_AC_POWER_SF,
+    F_I_AC_ENERGY_WH,
+    F_I_AC_ENERGY_WH_SF,
+    F_I_DC_POWER,
+    F_I_DC_POWER_SF,
+    F_I_STATUS,
+
+    F_M1_MODEL_ID,
+    F_M1_AC_POWER,
+    F_M1_AC_POWER_SF,
+    F_M1_EXPORTED_WH,
+    F_M1_IMPORTED_WH,
+    F_M1_ENERGY_WH_SF,
+
+    F_B1_RATED_ENERGY,
+    F_B1_MAX_CHARGE_POWER,
+    F_B1_MAX_DISCHARGE_POWER,
+    F_B1_INSTANTANEOUS_POWER,
+    F_B1_STATE_OF_ENERGY,
+    F_B1_STATUS,
+
+    F_M2_MODEL_ID,
+    F_M2_AC_POWER,
+    F_M2_AC_POWER_SF,
+
+    F_M3_MODEL_ID,
+    F_M3_AC_POWER,
+    F_M3_AC_POWER_SF,
+
+    F_B2_RATED_ENERGY,
+    F_B2_MAX_CHARGE_POWER,
+    F_B2_MAX_DISCHARGE_POWER,
+    F_B2_INSTANTANEOUS_POWER,
+    F_B2_STATE_OF_ENERGY,
+
+    FIELD_COUNT,
+    NO_FIELD = 0xff
+};
+
+static_assert(FIELD_COUNT <= 64, "field masks are 64 bit");
+
+// Description of one field
+struct RegisterDesc {
+    RegisterBlockId block;
+    uint16_t offset;      // from the block base
+    uint8_t width;        // in registers
+    RegType type;
+    Field scaleFactor;    // field holding the scale factor or NO_FIELD
+    Unit unit;
+};
+
+// Register map, offsets from the SolarEdge SunSpec implementation note, sorted by block and offset
+constexpr RegisterDesc SUNSPEC_REGISTERS[FIELD_COUNT] = {
+    {InverterBlock, 0, 1, RegType::Uint16, NO_FIELD, Unit::None},                         // F_I_MODEL_ID
+    {InverterBlock, 10, 1, RegType::Uint16, F_I_AC_VOLTAGE_SF, Unit::Volt},               // F_I_AC_VOLTAGE_AN
+    {InverterBlock, 13, 1, RegType::ScaleFactor, NO_FIELD, Unit::None},                   // F_I_AC_VOLTAGE_SF
+    {InverterBlock, 14, 1, RegType::Int16, F_I_AC_POWER_SF, Unit::Watt},                  // F_I_AC_POWER
+    {InverterBlock, 15, 1, RegType::ScaleFactor, NO_FIELD, Unit::None},                   // F_I_AC_POWER_SF
+    {InverterBlock, 24, 2, RegType::Acc32, F_I_AC_ENERGY_WH_SF, Unit::WattHour},          // F_I_AC_ENERGY_WH
+    {InverterBlock, 26, 1, RegType::ScaleFactor, NO_FIELD, Unit::None},                   // F_I_AC_ENERGY_WH_SF
+    {InverterBlock, 31, 1, RegType::Int16, F_I_DC_POWER_SF, Unit::Watt},                  // F_I_DC_POWER
+    {InverterBlock, 32, 1, RegType::ScaleFactor, NO_FIELD, Unit::None},                   // F_I_DC_POWER_SF
+    {InverterBlock, 38, 1, RegType::Uint16, NO_FIELD, Unit::None},                        // F_I_STATUS
+
+    {Meter1Block, 0, 1, RegType::Uint16, NO_FIELD, Unit::None},                           // F_M1_MODEL_ID
+    {Meter1Block, 18, 1, RegType::Int16, F_M1_AC_POWER_SF, Unit::Watt},                  // F_M1_AC_POWER
+    {Meter1Block, 22, 1, RegType::ScaleFactor, NO_FIELD, Unit::None},                     // F_M1_AC_POWER_SF
+    {Meter1Block, 38, 2, RegType::Acc32, F_M1_ENERGY_WH_SF, Unit::WattHour},              // F_M1_EXPORTED_WH
+    {Meter1Block, 46, 2, RegType::Acc32, F_M1_ENERGY_WH_SF, Unit::WattHour},              // F_M1_IMPORTED_WH
+    {Meter1Block, 54, 1, RegType::ScaleFactor, NO_FIELD, Unit::None},                     // F_M1_ENERGY_WH_SF
+
+    {Battery1Block, 0x42, 2, RegType::Float32Le, NO_FIELD, Unit::WattHour},               // F_B1_RATED_ENERGY
+    {Battery1Block, 0x44, 2, RegType::Float32Le, NO_FIELD, Unit::Watt},                   // F_B1_MAX_CHARGE_POWER
+    {Battery1Block, 0x46, 2, RegType::Float32Le, NO_FIELD, Unit::Watt},                   // F_B1_MAX_DISCHARGE_POWER
+    {Battery1Block, 0x74, 2, RegType::Float32Le, NO_FIELD, Unit::Watt},                   // F_B1_INSTANTANEOUS_POWER
+    {Battery1Block, 0x84, 2, RegType::Float32Le, NO_FIELD, Unit::Percent},                // F_B1_STATE_OF_ENERGY
+    {Battery1Block, 0x86, 2, RegType::Uint32Le, NO_FIELD, Unit::None},                    // F_B1_STATUS
+
+    {Meter2Block, 0, 1, RegType::Uint16, NO_FIELD, Unit::None},                           // F_M2_MODEL_ID
+    {Meter2Block, 18, 1, RegType::Int16, F_M2_AC_POWER_SF, Unit::Watt},                  // F_M2_AC_POWER
+    {Meter2Block, 22, 1, RegType::ScaleFactor, NO_FIELD, Unit::None},                     // F_M2_AC_POWER_SF
+
+    {Meter3Block, 0, 1, RegType::Uint16, NO_FIELD, Unit::None},                           // F_M3_MODEL_ID
+    {Meter3Block, 18, 1, RegType::Int16, F_M3_AC_POWER_SF, Unit::Watt},                  // F_M3_AC_POWER
+    {Meter3Block, 22, 1, RegType::ScaleFactor, NO_FIELD, Unit::None},                     // F_M3_AC_POWER_SF
+
+    {Battery2Block, 0x42, 2, RegType::Float32Le, NO_FIELD, Unit::WattHour},               // F_B2_RATED_ENERGY
+    {Battery2Block, 0x44, 2, RegType::Float32Le, NO_FIELD, Unit::Watt},                   // F_B2_MAX_CHARGE_POWER
+    {Battery2Block, 0x46, 2, RegType::Float32Le, NO_FIELD, Unit::Watt},                   // F_B2_MAX_DISCHARGE_POWER
+    {Battery2Block, 0x74, 2, RegType::Float32Le, NO_FIELD, Unit::Watt},                   // F_B2_INSTANTANEOUS_POWER
+    {Battery2Block, 0x84, 2, RegType::Float32Le, NO_FIELD, Unit::Percent},                // F_B2_STATE_OF_ENERGY
+};
+
+// Meters and batteries a SolarEdge inverter can report
+const uint8_t MAX_METERS = 3;
+const uint8_t MAX_BATTERIES = 2;
+
+// Fields of meter i (0 = M1)
+constexpr Field METER_MODEL_ID[MAX_METERS] = {F_M1_MODEL_ID, F_M2_MODEL_ID, F_M3_MODEL_ID};
+constexpr Field METER_AC_POWER[MAX_METERS] = {F_M1_AC_POWER, F_M2_AC_POWER, F_M3_AC_POWER};
+constexpr Field METER_AC_POWER_SF[MAX_METERS] = {F_M1_AC_POWER_SF, F_M2_AC_POWER_SF, F_M3_AC_POWER_SF};
+
+// Fields of battery i (0 = B1)
+constexpr Field BATTERY_RATED_ENERGY[MAX_BATTERIES] = {F_B1_RATED_ENERGY, F_B2_RATED_ENERGY};
+constexpr Field BATTERY_MAX_CHARGE_POWER[MAX_BATTERIES] = {F_B1_MAX_CHARGE_POWER, F_B2_MAX_CHARGE_POWER};
+constexpr Field BATTERY_MAX_DISCHARGE_POWER[MAX_BATTERIES] = {F_B1_MAX_DISCHARGE_POWER, F_B2_MAX_DISCHARGE_POWER};
+constexpr Field BATTERY_POWER[MAX_BATTERIES] = {F_B1_INSTANTANEOUS_POWER, F_B2_INSTANTANEOUS_POWER};
+constexpr Field BATTERY_STATE_OF_ENERGY[MAX_BATTERIES] = {F_B1_STATE_OF_ENERGY, F_B2_STATE_OF_ENERGY};
+
+// Bit of a field in a field mask
+constexpr uint64_t fieldBit(Field f) {
+    return (uint64_t)1 << f;
+}
+
+// Mask of several fields
+constexpr uint64_t fieldMask(std::initializer_list<Field> fields) {
+    uint64_t mask = 0;
+    for (Field f : fields) {
+        mask |= fieldBit(f);
+    }
+    return mask;
+}
+
+// Absolute register address of a field
+constexpr uint16_t fieldAddress(Field f, const BlockBases &bases = DEFAULT_BLOCK_BASES) {
+    return bases.base[SUNSPEC_REGISTERS[f].block] + SUNSPEC_REGISTERS[f].offset;
+}
+
+// Block reads and buffer layout for a set of fields
+struct PlanLayout {
+    // false if the fields do not fit into MAX_PLAN_BLOCKS blocks or MAX_PLAN_REGS registers
+    bool valid;
+
+    uint8_t blockCount;
+    uint16_t start[MAX_PLAN_BLOCKS];
+    uint16_t count[MAX_PLAN_BLOCKS];
+    uint16_t bufferOffset[MAX_PLAN_BLOCKS];
+    uint16_t totalRegs;
+
+    // index of the field's first register in the buffer, -1 = not part of the plan
+    int16_t slot[FIELD_COUNT];
+};
+
+/**
+ * Merges the fields of mask into the minimal number of contiguous block
+ * reads (gaps up to MAX_BLOCK_GAP, at most MAX_BLOCK_REGS per read). Usable
+ * at compile time for fixed plans and at runtime for discovered block bases.
+ */
+constexpr PlanLayout planFields(uint64_t mask, const BlockBases &bases = DEFAULT_BLOCK_BASES) {
+    PlanLayout layout = {};
+    layout.valid = true;
+    for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+        layout.slot[f] = -1;
+    }
+
+    // selected fields sorted by address
+    uint8_t order[FIELD_COUNT] = {};
+    uint8_t n = 0;
+    for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+        if ((mask & fieldBit((Field)f)) == 0) {
+            continue;
+        }
+        uint8_t i = n++;
+        while (i > 0 && fieldAddress((Field)order[i - 1], bases) > fieldAddress((Field)f, bases)) {
+            order[i] = order[i - 1];
+            i--;
+        }
+        order[i] = f;
+    }
+
+    for (uint8_t i = 0; i < n; i++) {
+        uint16_t start = fieldAddress((Field)order[i], bases);
+        uint16_t end = start + SUNSPEC_REGISTERS[order[i]].width;  // exclusive
+
+        if (layout.blockCount > 0) {
+            uint8_t b = layout.blockCount - 1;
+            uint16_t lastEnd = layout.start[b] + layout.count[b];
+            if (start <= lastEnd + MAX_BLOCK_GAP && end - layout.start[b] <= MAX_BLOCK_REGS) {
+                if (end > lastEnd) {
+                    layout.count[b] = end - layout.start[b];
+                }
+                continue;
+            }
+        }
+
+        if (layout.blockCount >= MAX_PLAN_BLOCKS) {
+            layout.valid = false;
+            return layout;
+        }
+        layout.start[layout.blockCount] = start;
+        layout.count[layout.blockCount] = end - start;
+        layout.blockCount++;
+    }
+
+    for (uint8_t b = 0; b < layout.blockCount; b++) {
+        layout.bufferOffset[b] = layout.totalRegs;
+        layout.totalRegs += layout.count[b];
+    }
+    if (layout.totalRegs > MAX_PLAN_REGS) {
+        layout.valid = false;
+        return layout;
+    }
+
+    for (uint8_t i = 0; i < n; i++) {
+        uint16_t address = fieldAddress((Field)order[i], bases);
+        for (uint8_t b = 0; b < layout.blockCount; b++) {
+            if (address >= layout.start[b] && address < layout.start[b] + layout.count[b]) {
+                layout.slot[order[i]] = layout.bufferOffset[b] + (address - layout.start[b]);
+            }
+        }
+    }
+    return layout;
+}
+
+// Layout of a single raw register range without fields, e.g. for mirroring
+constexpr PlanLayout rangeLayout(uint16_t start, uint16_t count) {
+    PlanLayout layout = {};
+    layout.valid = count > 0 && count <= MAX_BLOCK_REGS && count <= MAX_PLAN_REGS;
+    layout.blockCount = 1;
+    layout.start[0] = start;
+    layout.count[0] = count;
+    layout.totalRegs = count;
+    for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+        layout.slot[f] = -1;
+    }
+    return layout;
+}
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef WEB_API_H
+#define WEB_API_H
+
+#include <Arduino.h>
+
+#include "FixedText.h"
+#include "SolarSnapshot.h"
+
+// Capacity of the /api/live response
+const size_t LIVE_JSON_CAPACITY = 768;
+
+// Capacity of the /metrics response, with room for all counters at full width
+const size_t METRICS_TEXT_CAPACITY = 3584;
+
+// A built response is reused for requests within this time if the snapshot did not change
+const unsigned long WEB_API_CACHE_MILLIS = 1000;
+
+// Device health values exported next to the solar values
+struct DeviceHealth {
+    uint32_t uptimeMillis;
+    uint32_t freeHeap;
+    uint32_t maxFreeBlock;
+    uint8_t heapFragmentation;
+    int32_t rssi;
+    uint32_t loopMaxMicros;
+    uint32_t cycleMillis;
+    uint32_t pollIntervalMillis;
+    uint32_t requests;
+    uint32_t retries;
+    uint32_t timeouts;
+    uint32_t pollFailures;
+    uint32_t mqttPublished;
+    uint32_t mqttDropped;
+    uint32_t mqttLatencyMillis;
+    uint32_t bootMillis;
+    uint16_t dutyCyclePermille;
+    uint16_t currentMilliamps;
+};
+
+/**
+ * Builds the /api/live JSON and /metrics Prometheus responses from the
+ * latest snapshot into preallocated buffers. Requests never trigger a
+ * Modbus read, and a response is rebuilt only when the snapshot changed
+ * or WEB_API_CACHE_MILLIS passed, so frequent scraping costs a buffer
+ * copy to the socket.
+ */
+class WebApi {
+   public:
+    // JSON document with the latest values, powers in W, null before the first poll
+    const FixedText<LIVE_JSON_CAPACITY> &live(const SnapshotStore &snapshots, unsigned long staleAfterMillis, const DeviceHealth &health);
+
+    // Prometheus text exposition of the latest values and device health
+    const FixedText<METRICS_TEXT_CAPACITY> &metrics(const SnapshotStore &snapshots, const DeviceHealth &health);
+
+    // Number of responses built, the rest were served from the cache
+    uint32_t builds() const { return buildCount; }
+
+   private:
+    // Is a response built at builtAt for builtSequence still valid?
+    static bool cached(const SnapshotStore &snapshots, uint32_t builtSequence, unsigned long builtAt, bool built);
+
+    // Appends one Prometheus sample, value in fixed point with decimals
+    void metric(const char *name, const char *labels, int32_t value, uint8_t decimals = 0);
+
+    // Appends HELP and TYPE lines of a metric family
+    void family(const char *name, const char *type, const char *help);
+
+    FixedText<LIVE_JSON_CAPACITY> json;
+    uint32_t jsonSequence = 0;
+    unsigned long jsonBuiltAt = 0;
+    bool jsonBuilt = false;
+
+    FixedText<METRICS_TEXT_CAPACITY> text;
+    uint32_t textSequence = 0;
+    unsigned long textBuiltAt = 0;
+    bool textBuilt = false;
+
+    uint32_t buildCount = 0;
+};
+
+#endif
@@ -0,0 +1,67 @@
+#include "AdaptivePoller.h"
+
+void AdaptivePoller::setIdle(bool isIdle) {
+    if (idle && !isIdle && failureCount == 0) {
+        // display switched on, do not wait for the rest of the idle interval
+        nextAt = lastStart + currentInterval;
+    }
+    idle = isIdle;
+}
+
+bool AdaptivePoller::due() const {
+    return (int32_t)(millis() - nextAt) >= 0;
+}
+
+uint32_t AdaptivePoller::millisUntilDue() const {
+    int32_t left = nextAt - millis();
+    return left > 0 ? left : 0;
+}
+
+void AdaptivePoller::started() {
+    lastStart = millis();
+    nextAt = lastStart + interval();
+}
+
+void AdaptivePoller::succeeded(const SolarSnapshot &snapshot) {
+    failureCount = 0;
+    backoff = 0;
+
+    if (hasLast && maxChange(snapshot, last) > deadband) {
+        currentInterval = max(MIN_POLL_MILLIS, currentInterval / 2);
+        flatPolls = 0;
+    } else if (++flatPolls >= FLAT_POLLS_BEFORE_STRETCH) {
+        currentInterval = min(MAX_POLL_MILLIS, currentInterval + currentInterval / 2);
+        flatPolls = 0;
+    }
+
+    last = snapshot;
+    hasLast = true;
+    nextAt = lastStart + interval();
+}
+
+void AdaptivePoller::failed() {
+    failureCount++;
+    failureTotal++;
+
+    // 1 s, 2 s, 4 s ... up to MAX_BACKOFF_MILLIS, plus up to a quarter of jitter
+    uint8_t shift = min<uint16_t>(failureCount - 1, 16);
+    backoff = min(MAX_BACKOFF_MILLIS, MIN_BACKOFF_MILLIS << shift);
+    backoff += random(backoff / 4 + 1);
+
+    nextAt = millis() + backoff;
+}
+
+void AdaptivePoller::reset() {
+    currentInterval = baseInterval;
+    flatPolls = 0;
+    hasLast = false;
+    nextAt = millis();
+}
+
+milliwatt_t AdaptivePoller::maxChange(const SolarSnapshot &a, const SolarSnapshot &b) {
+    milliwatt_t change = abs(a.sunPower - b.sunPower);
+    change = max(change, abs(a.houseUsage - b.houseUsage));
+    change = max(change, abs(a.batteryPower - b.batteryPower));
+    change = max(change, abs(a.meterPower - b.meterPower));
+    return change;
+}
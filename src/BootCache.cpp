@@ -0,0 +1,91 @@
+#include "BootCache.h"
+
+#include <ESP8266WiFi.h>
+#include <LittleFS.h>
+
+#include "EnergyLog.h"
+
+// Marks a record, changes with the record layout
+static const uint32_t BOOT_RECORD_MAGIC = 0x42544331;  // "BTC1"
+
+// Flash copy of the record
+static const char *BOOT_CACHE_FILE = "/boot.bin";
+
+// First 32 bit block of the record in the RTC user memory
+static const uint32_t BOOT_RTC_OFFSET = 0;
+
+bool BootCache::begin() {
+    // the RTC memory holds garbage after a power cut, the CRC tells
+    if (ESP.rtcUserMemoryRead(BOOT_RTC_OFFSET, (uint32_t *)&record, sizeof(record)) && isValid(record)) {
+        bootSource = BootFromRtc;
+        return true;
+    }
+
+    // the energy log mounts the file system again later, which is a no-op
+    if (LittleFS.begin()) {
+        File file = LittleFS.open(BOOT_CACHE_FILE, "r");
+        bool ok = file && file.read((uint8_t *)&record, sizeof(record)) == sizeof(record) && isValid(record);
+        file.close();
+        if (ok) {
+            bootSource = BootFromFlash;
+            writeRtc();
+            return true;
+        }
+    }
+
+    record = {};
+    bootSource = BootCold;
+    return false;
+}
+
+void BootCache::saveNetwork() {
+    BootRecord updated = record;
+    memcpy(updated.bssid, WiFi.BSSID(), sizeof(updated.bssid));
+    updated.channel = WiFi.channel();
+    updated.ip = WiFi.localIP();
+    updated.gateway = WiFi.gatewayIP();
+    updated.subnet = WiFi.subnetMask();
+    updated.dns = WiFi.dnsIP();
+
+    // the network rarely changes, the file is only rewritten when it does
+    bool changed = memcmp(updated.bssid, record.bssid, offsetof(BootRecord, snapshot) - offsetof(BootRecord, bssid)) != 0;
+    record = updated;
+    writeRtc();
+    if (changed) {
+        persist();
+    }
+}
+
+void BootCache::forgetNetwork() {
+    memset(record.bssid, 0, sizeof(record.bssid));
+    record.channel = 0;
+    record.ip = 0;
+    writeRtc();
+    persist();
+}
+
+void BootCache::saveSnapshot(const SolarSnapshot &snapshot) {
+    record.snapshot = snapshot;
+    writeRtc();
+}
+
+bool BootCache::persist() {
+    writeRtc();
+    File file = LittleFS.open(BOOT_CACHE_FILE, "w");
+    bool ok = file && file.write((const uint8_t *)&record, sizeof(record)) == sizeof(record);
+    file.close();
+    if (ok) {
+        writeCount++;
+    }
+    return ok;
+}
+
+void BootCache::writeRtc() {
+    record.magic = BOOT_RECORD_MAGIC;
+    record.crc = EnergyLog::crc32((const uint8_t *)&record, offsetof(BootRecord, crc));
+    ESP.rtcUserMemoryWrite(BOOT_RTC_OFFSET, (uint32_t *)&record, sizeof(record));
+}
+
+bool BootCache::isValid(const BootRecord &candidate) {
+    return candidate.magic == BOOT_RECORD_MAGIC && candidate.crc == EnergyLog::crc32((const uint8_t *)&candidate, offsetof(BootRecord, crc));
+}
@@ -0,0 +1,33 @@
+#include "BootTimeline.h"
+
+void BootTimeline::mark(const char *step) {
+    if (done || count >= MAX_BOOT_MARKS) {
+        return;
+    }
+    marks[count++] = {step, millis()};
+}
+
+void BootTimeline::finish(bool warm) {
+    if (done) {
+        return;
+    }
+    mark("first live frame");
+    done = true;
+    firstFrame = millis();
+
+    Serial.print(warm ? "warm" : "cold");
+    Serial.println(" boot timeline (ms since power on):");
+    for (uint8_t i = 0; i < count; i++) {
+        Serial.print("  ");
+        Serial.print(marks[i].at);
+        Serial.print(" ");
+        Serial.println(marks[i].step);
+    }
+
+    // a cold boot waits for the access point window and DHCP, only warm boots have a target
+    if (warm && firstFrame > WARM_BOOT_TARGET_MILLIS) {
+        Serial.print("warm boot missed the target of ");
+        Serial.print(WARM_BOOT_TARGET_MILLIS);
+        Serial.println(" ms");
+    }
+}
@@ -0,0 +1,91 @@
+#include "DisplayFlusher.h"
+
+// Data bytes per I2C transmission, leaves room for the control byte in the Wire buffer
+static const uint8_t CHUNK_SIZE = 31;
+
+DisplayFlusher::DisplayFlusher(Adafruit_SSD1306 &display, TwoWire &wire, uint8_t address, uint32_t clkDuring, uint32_t clkAfter)
+    : display(display), wire(wire), address(address), clkDuring(clkDuring), clkAfter(clkAfter) {
+}
+
+uint16_t DisplayFlusher::flush() {
+    const uint8_t *frame = display.getBuffer();
+    uint16_t bytes = 0;
+
+    wire.setClock(clkDuring);
+
+    for (uint8_t page = 0; page < FLUSH_PAGES; page++) {
+        const uint8_t *now = &frame[page * FLUSH_COLUMNS];
+        uint8_t *last = &lastFrame[page * FLUSH_COLUMNS];
+
+        // collect ranges of changed columns, close ones are merged
+        uint8_t from[MAX_RANGES_PER_PAGE];
+        uint8_t to[MAX_RANGES_PER_PAGE];
+        uint8_t ranges = 0;
+
+        for (uint8_t col = 0; col < FLUSH_COLUMNS; col++) {
+            if (valid && now[col] == last[col]) {
+                continue;
+            }
+
+            if (ranges > 0 && (col - to[ranges - 1] <= RANGE_MERGE_GAP || ranges == MAX_RANGES_PER_PAGE)) {
+                to[ranges - 1] = col;
+            } else {
+                from[ranges] = col;
+                to[ranges] = col;
+                ranges++;
+            }
+        }
+
+        for (uint8_t r = 0; r < ranges; r++) {
+            bytes += sendRange(page, from[r], to[r]);
+        }
+        memcpy(last, now, FLUSH_COLUMNS);
+    }
+
+    wire.setClock(clkAfter);
+
+    valid = true;
+    lastBytes = bytes;
+    sumBytes += bytes;
+    frameCount++;
+    return bytes;
+}
+
+uint16_t DisplayFlusher::sendRange(uint8_t page, uint8_t from, uint8_t to) {
+    uint16_t bytes = 0;
+
+    // restrict the GDDRAM write window to the changed range
+    wire.beginTransmission(address);
+    wire.write((uint8_t)0x00);  // Co = 0, D/C = 0: command stream
+    wire.write((uint8_t)SSD1306_PAGEADDR);
+    wire.write(page);
+    wire.write(page);
+    wire.write((uint8_t)SSD1306_COLUMNADDR);
+    wire.write(from);
+    wire.write(to);
+    wire.endTransmission();
+    bytes += 7;
+
+    const uint8_t *data = &display.getBuffer()[page * FLUSH_COLUMNS + from];
+    uint8_t remaining = to - from + 1;
+
+    while (remaining > 0) {
+        uint8_t chunk = remaining < CHUNK_SIZE ? remaining : CHUNK_SIZE;
+
+        wire.beginTransmission(address);
+        wire.write((uint8_t)0x40);  // Co = 0, D/C = 1: data stream
+        wire.write(data, chunk);
+        wire.endTransmission();
+
+        bytes += 1 + chunk;
+        data += chunk;
+        remaining -= chunk;
+    }
+
+    return bytes;
+}
+
+void DisplayFlusher::resetStats() {
+    sumBytes = 0;
+    frameCount = 0;
+}
@@ -0,0 +1,117 @@
+#include "EnergyLog.h"
+
+#include <LittleFS.h>
+
+// Marks a record, changes with the record layout
+static const uint32_t ENERGY_RECORD_MAGIC = 0x45474C31;  // "EGL1"
+
+// The two log files
+static const char *const ENERGY_LOG_FILES[2] = {"/energy0.log", "/energy1.log"};
+
+bool EnergyLog::begin(EnergyState &restored) {
+    // formats an unformatted or broken file system
+    mounted = LittleFS.begin();
+    if (!mounted) {
+        return false;
+    }
+
+    Record latest = {};
+    bool found = false;
+    for (uint8_t f = 0; f < 2; f++) {
+        Record record;
+        uint16_t count;
+        if (lastRecord(f, record, count) && (!found || (int32_t)(record.sequence - latest.sequence) > 0)) {
+            latest = record;
+            found = true;
+            current = f;
+            currentCount = count;
+        }
+    }
+
+    if (found) {
+        restored = latest.state;
+        sequence = latest.sequence;
+    }
+    return found;
+}
+
+bool EnergyLog::append(const EnergyState &state) {
+    if (!mounted) {
+        return false;
+    }
+
+    const char *mode = "a";
+    if (currentCount >= ENERGY_LOG_RECORDS_PER_FILE) {
+        // the full file keeps the latest checkpoint until the first record of the other one is written
+        current = 1 - current;
+        currentCount = 0;
+        mode = "w";
+    }
+
+    File file = LittleFS.open(ENERGY_LOG_FILES[current], mode);
+    if (!file) {
+        return false;
+    }
+
+    // drop a torn record of a power cut, appends stay aligned
+    size_t size = file.size();
+    if (size % sizeof(Record) != 0) {
+        file.truncate(size - size % sizeof(Record));
+        file.seek(0, SeekEnd);
+    }
+
+    Record record;
+    memset(&record, 0, sizeof(record));
+    record.magic = ENERGY_RECORD_MAGIC;
+    record.sequence = sequence + 1;
+    record.state = state;
+    record.crc = recordCrc(record);
+
+    size_t written = file.write((const uint8_t *)&record, sizeof(record));
+    file.close();
+    if (written != sizeof(record)) {
+        return false;
+    }
+
+    sequence = record.sequence;
+    currentCount++;
+    writeCount++;
+    return true;
+}
+
+bool EnergyLog::lastRecord(uint8_t f, Record &record, uint16_t &count) {
+    File file = LittleFS.open(ENERGY_LOG_FILES[f], "r");
+    if (!file) {
+        return false;
+    }
+
+    uint16_t complete = file.size() / sizeof(Record);
+    count = complete;
+
+    // the last record may be torn or corrupt, the one before it is the fallback
+    bool found = false;
+    for (uint8_t back = 1; back <= 2 && back <= complete && !found; back++) {
+        file.seek((complete - back) * sizeof(Record), SeekSet);
+        found = file.read((uint8_t *)&record, sizeof(record)) == sizeof(record) &&
+                record.magic == ENERGY_RECORD_MAGIC && record.crc == recordCrc(record);
+    }
+
+    file.close();
+    return found;
+}
+
+uint32_t EnergyLog::recordCrc(const Record &record) {
+    return crc32((const uint8_t *)&record, offsetof(Record, crc));
+}
+
+uint32_t EnergyLog::crc32(const uint8_t *data, size_t length) {
+    // bitwise CRC-32, a few hundred bytes per checkpoint need no table
+    uint32_t crc = 0xFFFFFFFF;
+    while (length--) {
+        crc ^= *data++;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
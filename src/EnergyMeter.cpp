@@ -0,0 +1,50 @@
+#include "EnergyMeter.h"
+
+void EnergyMeter::add(const SolarSnapshot &snapshot) {
+    milliwatt_t power[ENERGY_COUNTERS];
+    flows(snapshot, power);
+
+    unsigned long dt = snapshot.acquiredAt - lastAt;
+    if (hasLast && dt <= MAX_INTEGRATION_GAP_MILLIS) {
+        for (uint8_t c = 0; c < ENERGY_COUNTERS; c++) {
+            // trapezoid between the previous and this poll in mW * ms
+            uint64_t energy = ((uint64_t)lastPower[c] + power[c]) * dt / 2 + rest[c];
+            milliwatthour_t whole = energy / MILLIWATT_MILLIS_PER_MILLIWATTHOUR;
+            rest[c] = energy % MILLIWATT_MILLIS_PER_MILLIWATTHOUR;
+
+            state.lifetime[c] += whole;
+            state.today[c] += whole;
+        }
+    }
+
+    for (uint8_t c = 0; c < ENERGY_COUNTERS; c++) {
+        lastPower[c] = power[c];
+    }
+    lastAt = snapshot.acquiredAt;
+    hasLast = true;
+}
+
+bool EnergyMeter::setDay(uint32_t day) {
+    if (day == state.day) {
+        return false;
+    }
+
+    // the first known date after boot adopts counters of an unknown day
+    bool newDay = state.day != 0;
+    if (newDay) {
+        for (uint8_t c = 0; c < ENERGY_COUNTERS; c++) {
+            state.today[c] = 0;
+        }
+    }
+    state.day = day;
+    return newDay;
+}
+
+void EnergyMeter::flows(const SolarSnapshot &snapshot, milliwatt_t (&power)[ENERGY_COUNTERS]) {
+    power[EnergyProduction] = max<milliwatt_t>(snapshot.sunPower, 0);
+    power[EnergyConsumption] = max<milliwatt_t>(snapshot.houseUsage, 0);
+    power[EnergyImport] = max<milliwatt_t>(-snapshot.meterPower, 0);
+    power[EnergyExport] = max<milliwatt_t>(snapshot.meterPower, 0);
+    power[EnergyCharge] = max<milliwatt_t>(snapshot.batteryPower, 0);
+    power[EnergyDischarge] = max<milliwatt_t>(-snapshot.batteryPower, 0);
+}
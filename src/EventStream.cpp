@@ -0,0 +1,119 @@
+#include "EventStream.h"
+
+// Response header of the stream, the connection stays open
+static const char EVENT_STREAM_HEADER[] PROGMEM =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/event-stream\r\n"
+    "Cache-Control: no-cache\r\n"
+    "Connection: keep-alive\r\n"
+    "Access-Control-Allow-Origin: *\r\n"
+    "\r\n"
+    "retry: 5000\n\n";
+
+// Sent instead of an event while nothing changes
+static const char EVENT_KEEPALIVE[] = ": ka\n\n";
+
+bool EventStream::subscribe(WiFiClient &client) {
+    for (uint8_t i = 0; i < MAX_EVENT_SUBSCRIBERS; i++) {
+        if (active[i] && !clients[i].connected()) {
+            clients[i].stop();
+            active[i] = false;
+        }
+    }
+
+    for (uint8_t i = 0; i < MAX_EVENT_SUBSCRIBERS; i++) {
+        if (active[i]) {
+            continue;
+        }
+
+        // the copy keeps the connection open after the web server releases the request
+        clients[i] = client;
+        clients[i].setNoDelay(true);
+        clients[i].setSync(false);
+        active[i] = true;
+
+        char header[sizeof(EVENT_STREAM_HEADER)];
+        memcpy_P(header, EVENT_STREAM_HEADER, sizeof(EVENT_STREAM_HEADER));
+        send(i, header, sizeof(EVENT_STREAM_HEADER) - 1);
+
+        if (hasLast && active[i]) {
+            build(lastSent, true);
+            send(i, event.c_str(), event.length());
+        }
+        return active[i];
+    }
+    return false;
+}
+
+void EventStream::publish(const SolarSnapshot &snapshot) {
+    build(snapshot, !hasLast);
+    lastSent = snapshot;
+    hasLast = true;
+
+    for (uint8_t i = 0; i < MAX_EVENT_SUBSCRIBERS; i++) {
+        if (active[i]) {
+            send(i, event.c_str(), event.length());
+        }
+    }
+    lastKeepAlive = millis();
+}
+
+void EventStream::task() {
+    bool keepAlive = millis() - lastKeepAlive >= EVENT_KEEPALIVE_MILLIS;
+    if (keepAlive) {
+        lastKeepAlive = millis();
+    }
+
+    for (uint8_t i = 0; i < MAX_EVENT_SUBSCRIBERS; i++) {
+        if (!active[i]) {
+            continue;
+        }
+        if (!clients[i].connected()) {
+            clients[i].stop();
+            active[i] = false;
+        } else if (keepAlive) {
+            send(i, EVENT_KEEPALIVE, sizeof(EVENT_KEEPALIVE) - 1);
+        }
+    }
+}
+
+uint8_t EventStream::subscribers() const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < MAX_EVENT_SUBSCRIBERS; i++) {
+        count += active[i] ? 1 : 0;
+    }
+    return count;
+}
+
+void EventStream::send(uint8_t i, const char *data, size_t length) {
+    // never block the loop for a slow browser, it reconnects and gets all values again
+    if (!clients[i].connected() || (size_t)clients[i].availableForWrite() < length) {
+        clients[i].stop();
+        active[i] = false;
+        droppedCount++;
+        return;
+    }
+    clients[i].write((const uint8_t *)data, length);
+}
+
+void EventStream::build(const SolarSnapshot &snapshot, bool full) {
+    event.clear();
+    event.append("data: q=").appendUInt(snapshot.sequence);
+
+    if (full || snapshot.sunPower != lastSent.sunPower) {
+        event.append(";s=").appendInt(snapshot.sunPower);
+    }
+    if (full || snapshot.houseUsage != lastSent.houseUsage) {
+        event.append(";h=").appendInt(snapshot.houseUsage);
+    }
+    if (full || snapshot.meterPower != lastSent.meterPower) {
+        event.append(";g=").appendInt(snapshot.meterPower);
+    }
+    if (full || snapshot.batteryPower != lastSent.batteryPower) {
+        event.append(";b=").appendInt(snapshot.batteryPower);
+    }
+    if (full || snapshot.batteryStateOfEnergy != lastSent.batteryStateOfEnergy) {
+        event.append(";e=").appendInt(snapshot.batteryStateOfEnergy);
+    }
+    event.append("\n\n");
+}
@@ -0,0 +1,79 @@
+#include "FixedPoint.h"
+
+static int32_t saturate(int64_t v) {
+    if (v > INT32_MAX) {
+        return INT32_MAX;
+    }
+    if (v < INT32_MIN) {
+        return INT32_MIN;
+    }
+    return (int32_t)v;
+}
+
+int32_t divRound(int64_t numerator, int32_t denominator) {
+    if (denominator < 0) {
+        numerator = -numerator;
+        denominator = -denominator;
+    }
+    int64_t half = denominator / 2;
+    int64_t q = numerator >= 0 ? (numerator + half) / denominator : (numerator - half) / denominator;
+    return saturate(q);
+}
+
+int32_t scaledToFixed(int64_t value, int16_t scaleFactor, int32_t scale) {
+    // SunSpec scale factors are within -10..10
+    if (scaleFactor > 10 || scaleFactor < -10) {
+        return 0;
+    }
+
+    int64_t pow10 = 1;
+    for (int16_t i = 0; i < (scaleFactor < 0 ? -scaleFactor : scaleFactor); i++) {
+        pow10 *= 10;
+    }
+
+    int64_t v = value * scale;
+    if (scaleFactor >= 0) {
+        if (v > INT32_MAX || v < INT32_MIN) {
+            return saturate(v);
+        }
+        return saturate(v * pow10);
+    }
+    if (pow10 > INT32_MAX) {
+        return 0;
+    }
+    return divRound(v, (int32_t)pow10);
+}
+
+milliwatt_t scaledToMilliwatt(int16_t value, int16_t scaleFactor) {
+    return scaledToFixed(value, scaleFactor, 1000);
+}
+
+int32_t ieee754ToFixed(uint32_t raw, int32_t scale) {
+    bool negative = (raw >> 31) != 0;
+    int16_t exponent = (raw >> 23) & 0xff;
+    uint32_t mantissa = raw & 0x7fffff;
+
+    // zero, denormals (far below the fixed point resolution), NaN and infinity
+    if (exponent == 0 || exponent == 0xff) {
+        return 0;
+    }
+
+    // value = (1.mantissa) * 2^(exponent - 127) = (mantissa | 2^23) * 2^(exponent - 150)
+    uint64_t m = (uint64_t)(mantissa | 0x800000) * (uint64_t)(scale < 0 ? -scale : scale);
+    int16_t shift = exponent - 150;
+
+    int64_t v;
+    if (shift >= 0) {
+        v = shift > 24 ? INT64_MAX : (int64_t)(m << shift);
+    } else if (shift < -62) {
+        v = 0;
+    } else {
+        // round half away from zero
+        v = (int64_t)((m + ((uint64_t)1 << (-shift - 1))) >> -shift);
+    }
+
+    if (negative != (scale < 0)) {
+        v = -v;
+    }
+    return saturate(v);
+}
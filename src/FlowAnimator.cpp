@@ -0,0 +1,61 @@
+#include "FlowAnimator.h"
+
+void FlowAnimator::setTarget(const SolarSnapshot &snapshot, uint32_t now) {
+    if (snapshot.sequence == target.sequence) {
+        return;
+    }
+
+    // a new snapshot during a transition continues from the values shown
+    start = hasTarget() ? current : snapshot;
+    target = snapshot;
+    tweenStart = now;
+    tweening = true;
+    if (lastAdvance == 0) {
+        lastAdvance = now;
+    }
+}
+
+bool FlowAnimator::advance(uint32_t now) {
+    uint32_t elapsed = min(now - lastAdvance, MAX_ANIMATION_STEP_MILLIS);
+    lastAdvance = now;
+
+    const milliwatt_t powers[FLOW_PATHS] = {current.inverterPower, current.batteryPower, current.meterPower};
+    for (uint8_t i = 0; i < FLOW_PATHS; i++) {
+        phase[i] += speed(powers[i]) * elapsed / 1000;
+    }
+
+    if (!tweening) {
+        return false;
+    }
+
+    uint32_t progress = now - tweenStart;
+    if (progress >= TWEEN_MILLIS) {
+        current = target;
+        tweening = false;
+        return true;
+    }
+
+    current = target;
+    current.inverterPower = tween(start.inverterPower, target.inverterPower, progress);
+    current.meterPower = tween(start.meterPower, target.meterPower, progress);
+    current.batteryPower = tween(start.batteryPower, target.batteryPower, progress);
+    current.batteryStateOfEnergy = tween(start.batteryStateOfEnergy, target.batteryStateOfEnergy, progress);
+    current.sunPower = tween(start.sunPower, target.sunPower, progress);
+    current.houseUsage = tween(start.houseUsage, target.houseUsage, progress);
+    return true;
+}
+
+uint32_t FlowAnimator::speed(milliwatt_t power) {
+    if (power == 0) {
+        return 0;
+    }
+    uint32_t magnitude = power < 0 ? -(int64_t)power : power;
+    magnitude = min<uint32_t>(magnitude, FLOW_FULL_SPEED_MILLIWATT);
+
+    return FLOW_MIN_STEPS_PER_SECOND * 256 +
+           (uint64_t)(FLOW_MAX_STEPS_PER_SECOND - FLOW_MIN_STEPS_PER_SECOND) * 256 * magnitude / FLOW_FULL_SPEED_MILLIWATT;
+}
+
+int32_t FlowAnimator::tween(int32_t from, int32_t to, uint32_t progress) {
+    return from + divRound(((int64_t)to - from) * progress, TWEEN_MILLIS);
+}
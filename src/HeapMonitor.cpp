@@ -0,0 +1,38 @@
+#include "HeapMonitor.h"
+
+void HeapMonitor::sample() {
+    last.freeHeap = ESP.getFreeHeap();
+    last.maxFreeBlock = ESP.getMaxFreeBlockSize();
+    last.fragmentation = ESP.getHeapFragmentation();
+
+    if (last.freeHeap < minFree) {
+        minFree = last.freeHeap;
+    }
+    if (last.maxFreeBlock < minBlock) {
+        minBlock = last.maxFreeBlock;
+    }
+    if (last.fragmentation > maxFrag) {
+        maxFrag = last.fragmentation;
+    }
+
+    if (count == 0 || millis() - lastHistoryMillis >= HEAP_HISTORY_INTERVAL_MILLIS) {
+        samples[head] = last;
+        head = (head + 1) % HEAP_HISTORY_SIZE;
+        if (count < HEAP_HISTORY_SIZE) {
+            count++;
+        }
+        lastHistoryMillis = millis();
+    }
+}
+
+void HeapMonitor::print() const {
+    Serial.printf("heap free: %u, max block: %u, frag: %u%% (min free: %u, min block: %u, max frag: %u%%)\n",
+                  last.freeHeap, last.maxFreeBlock, last.fragmentation, minFree, minBlock, maxFrag);
+
+    Serial.print("heap history (free/block/frag):");
+    for (uint8_t i = 0; i < count; i++) {
+        const HeapSample &h = history(i);
+        Serial.printf(" %u/%u/%u", h.freeHeap, h.maxFreeBlock, h.fragmentation);
+    }
+    Serial.println();
+}
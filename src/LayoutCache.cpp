@@ -0,0 +1,79 @@
+#include "LayoutCache.h"
+
+#include <LittleFS.h>
+
+#include "EnergyLog.h"
+
+// Marks a record, changes with the record layout
+static const uint32_t LAYOUT_RECORD_MAGIC = 0x4c595432;  // "LYT2"
+
+// Flash copy of the record
+static const char *LAYOUT_CACHE_FILE = "/layout.bin";
+
+bool LayoutCache::begin() {
+    // the file system is mounted by the energy log
+    File file = LittleFS.open(LAYOUT_CACHE_FILE, "r");
+    bool ok = file && file.read((uint8_t *)&record, sizeof(record)) == sizeof(record) && isValid(record);
+    file.close();
+    if (!ok) {
+        record = {};
+    }
+    return ok && record.count > 0;
+}
+
+bool LayoutCache::find(const IPAddress &remote, uint16_t port, uint8_t unit, uint8_t meters, uint8_t batteries, DeviceLayout &layout) const {
+    int8_t i = indexOf(remote, port, unit);
+    if (i < 0 || record.entries[i].meters != meters || record.entries[i].batteries != batteries) {
+        return false;
+    }
+    layout = record.entries[i].layout;
+    return true;
+}
+
+bool LayoutCache::store(const IPAddress &remote, uint16_t port, uint8_t unit, uint8_t meters, uint8_t batteries, const DeviceLayout &layout) {
+    int8_t i = indexOf(remote, port, unit);
+    if (i >= 0 && record.entries[i].layout.fingerprint == layout.fingerprint && record.entries[i].meters == meters &&
+        record.entries[i].batteries == batteries) {
+        return true;
+    }
+
+    if (i < 0) {
+        if (record.count == MAX_CACHED_LAYOUTS) {
+            memmove(&record.entries[0], &record.entries[1], sizeof(LayoutRecord::Entry) * (MAX_CACHED_LAYOUTS - 1));
+            record.count--;
+        }
+        i = record.count++;
+        record.entries[i] = {};
+        record.entries[i].remote = (uint32_t)remote;
+        record.entries[i].port = port;
+        record.entries[i].unit = unit;
+    }
+    record.entries[i].meters = meters;
+    record.entries[i].batteries = batteries;
+    record.entries[i].layout = layout;
+
+    record.magic = LAYOUT_RECORD_MAGIC;
+    record.crc = EnergyLog::crc32((const uint8_t *)&record, offsetof(LayoutRecord, crc));
+    File file = LittleFS.open(LAYOUT_CACHE_FILE, "w");
+    bool ok = file && file.write((const uint8_t *)&record, sizeof(record)) == sizeof(record);
+    file.close();
+    if (ok) {
+        writeCount++;
+    }
+    return ok;
+}
+
+int8_t LayoutCache::indexOf(const IPAddress &remote, uint16_t port, uint8_t unit) const {
+    for (uint8_t i = 0; i < record.count; i++) {
+        const LayoutRecord::Entry &entry = record.entries[i];
+        if (entry.remote == (uint32_t)remote && entry.port == port && entry.unit == unit) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool LayoutCache::isValid(const LayoutRecord &candidate) {
+    return candidate.magic == LAYOUT_RECORD_MAGIC && candidate.count <= MAX_CACHED_LAYOUTS &&
+           candidate.crc == EnergyLog::crc32((const uint8_t *)&candidate, offsetof(LayoutRecord, crc));
+}
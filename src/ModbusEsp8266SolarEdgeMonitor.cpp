@@ -11,6 +11,35 @@
 #include <OneButton.h>
 #include <SPI.h>
 #include <Wire.h>
+#include <time.h>
+
+#include "AdaptivePoller.h"
+#include "BootCache.h"
+#include "BootTimeline.h"
+#include "DashboardPage.h"
+#include "DisplayFlusher.h"
+#include "EnergyLog.h"
+#include "EnergyMeter.h"
+#include "EventStream.h"
+#include "FixedPoint.h"
+#include "FixedText.h"
+#include "FlowAnimator.h"
+#include "HeapMonitor.h"
+#include "ModbusPipeline.h"
+#include "MqttPublisher.h"
+#include "PageBlitter.h"
+#include "PhaseProfiler.h"
+#include "PowerManager.h"
+#include "PowerHistory.h"
+#include "ReadPlanner.h"
+#include "RegisterCache.h"
+#include "RegisterMirror.h"
+#include "SampleLog.h"
+#include "Scheduler.h"
+#include "SolarSite.h"
+#include "SolarSnapshot.h"
+#include "SunSpecRegisters.h"
+#include "WebApi.h"
 
 
 
@@ -24,17 +53,100 @@ DNSServer dnsServer;
 // Web server
 WebServer server(80);
 
-// IP of the SolarEdge inverter
-IPAddress remote;
+// Builds the /api/live and /metrics responses
+WebApi webApi;
 
-// Modbus port of the SolarEdge inverter
-int port = -1;
+// Web server: latest values as JSON
+void handleApiLive();
 
-// ModbusIP object
-ModbusIP mb;
+// Web server: latest values and device health in Prometheus format
+void handleMetrics();
 
-// Modbus SolarEdge helper
-ModbusSolarEdge mbse;
+// Pushes new snapshots to the dashboard
+EventStream events;
+
+// Web server: live dashboard page
+void handleDashboard();
+
+// Web server: Server-Sent Events stream for the dashboard
+void handleEvents();
+
+// Web server: raw samples of a time range from flash
+void handleSamples();
+
+#ifdef MONITOR_PROFILING
+// Web server: timing histograms of the refresh cycle phases, ?reset=1 clears them afterwards
+void handleProfile();
+#endif
+
+// Leader inverter and followers with their meters and batteries, polled concurrently
+SolarSite site;
+
+// Adds the configured inverters to the site
+void configureSite();
+
+// Latest normalized values, written by acquisition and read by the screens
+SnapshotStore snapshots;
+
+// Minute averages of the last 24 hours for the history screen
+PowerHistory history;
+
+// Daily and lifetime kWh integrated from the polls
+EnergyMeter energy;
+
+// Checkpoints of the energy counters on flash
+EnergyLog energyLog;
+
+// Time of the last energy checkpoint
+unsigned long energyCheckpointAt = 0;
+
+// NTP server for the local date of the daily energy counters
+const char *NTP_SERVER = "pool.ntp.org";
+
+// Writes the energy counters to flash
+void checkpointEnergy();
+
+// Clock values before this are not set by NTP yet (seconds since 1970)
+const time_t MIN_VALID_TIME = 1600000000;
+
+// Raw samples on flash for offline analysis
+SampleLog sampleLog;
+
+// Pushes the changed values of every poll to an MQTT broker
+MqttPublisher mqttPublisher;
+
+// State of the Modbus connection and polling state machine
+enum ModbusState {
+    MbDisconnected,
+    MbShowInit,
+    MbShowResult,
+    MbMetadata,
+    MbIdle,
+    MbPolling
+};
+
+ModbusState modbusState = MbDisconnected;
+
+// Time the current Modbus state was entered
+unsigned long modbusStateSince = 0;
+
+// Time the init and result screens of the Modbus connect are shown
+const int MODBUS_INIT_SCREEN_MILLIS = 2000;
+
+// Time the init and result screens are shown, none while the boot frame is shown
+unsigned long modbusScreenMillis();
+
+// Local Modbus TCP server for other clients
+ModbusIP mbServer;
+
+// Answers mbServer reads from cached blocks of the leader, fetched through its pipeline
+RegisterMirror mirror(mbServer, site.leaderPipeline());
+
+// Is the upstream connection ready for reads?
+boolean modbusReady();
+
+// Pipeline: read of one device finished
+void onSiteRead(ReadPlanner &plan, bool success);
 
 
 // ### IotWebConf #############################################################
@@ -43,9 +155,42 @@ ModbusSolarEdge mbse;
 // Is a reset required?
 boolean needReset = false;
 
+// Time the reset was requested, restart follows after RESTART_DELAY_MILLIS
+unsigned long needResetSince = 0;
+
+// Delay between reset request and restart
+const int RESTART_DELAY_MILLIS = 1000;
+
 // Is wifi connected?
 boolean connected = false;
 
+// Network and last snapshot of the previous run
+BootCache bootCache;
+
+// Times of the boot steps up to the first live frame
+BootTimeline bootTimeline;
+
+// Is the cached network tried on this boot?
+boolean fastBoot = false;
+
+// Is the next WiFi connect the one with the cached access point?
+boolean fastConnectPending = false;
+
+// Is the cached lease configured as static address? DHCP takes over once connected
+boolean cachedLeaseApplied = false;
+
+// Timeout of a WiFi connect with full scan (IotWebConf default)
+const unsigned long WIFI_CONNECT_TIMEOUT_MILLIS = 30000;
+
+// Credentials of the full scan after the fast connect failed
+iotwebconf::WifiAuthInfo wifiRetryAuth;
+
+// IotWebConf: connects with the cached access point, channel and lease on a warm boot
+void connectWifi(const char *ssid, const char *password);
+
+// IotWebConf: retries once with a full scan after the fast connect failed
+iotwebconf::WifiAuthInfo *onWifiConnectionFailed();
+
 // IotWebConf: Modifying the config version will probably cause a loss of the existig configuration. Be careful!
 const char *CONFIG_VERSION = "1.0.2";
 
@@ -76,10 +221,117 @@ IotWebConfParameterGroup groupModbus = IotWebConfParameterGroup("groupModbus", "
 char inverterIpAddressParamValue[15] = {""};
 IotWebConfTextParameter inverterIpAddressParam = IotWebConfTextParameter("Inverter IP", "inverterIpParam", inverterIpAddressParamValue, 15, "192.168.0.1");
 
+// Modbus TCP port of SolarEdge inverters
+const long DEFAULT_INVERTER_PORT = 1502;
+
 // Parameter for Modbus TCP port
 char inverterPortParamValue[32];
 IotWebConfNumberParameter inverterPortParam = IotWebConfNumberParameter("Inverter Port", "inverterPort", inverterPortParamValue, 32, "1502", "1..65535", "min='1' max='65535' step='1'");
 
+// Parameter for the change in watts which polls faster
+char pollDeadbandParamValue[8];
+IotWebConfNumberParameter pollDeadbandParam = IotWebConfNumberParameter("Poll deadband (W)", "pollDeadband", pollDeadbandParamValue, 8, "50", "0..5000", "min='0' max='5000' step='1'");
+
+// Parameter for the port of the local Modbus TCP server, 0 = off
+char serverPortParamValue[8];
+IotWebConfNumberParameter serverPortParam = IotWebConfNumberParameter("Server Port (0 = off)", "serverPort", serverPortParamValue, 8, "0", "0..65535", "min='0' max='65535' step='1'");
+
+// Parameter for the maximum age of registers served by the local server
+char serverMaxAgeParamValue[8];
+IotWebConfNumberParameter serverMaxAgeParam = IotWebConfNumberParameter("Server max age (ms)", "serverMaxAge", serverMaxAgeParamValue, 8, "5000", "500..60000", "min='500' max='60000' step='100'");
+
+// Parameter group for the energy counters
+IotWebConfParameterGroup groupEnergy = IotWebConfParameterGroup("groupEnergy", "Energy Settings");
+
+// Default time zone: central Europe with daylight saving time
+const char *DEFAULT_TIME_ZONE = "CET-1CEST,M3.5.0,M10.5.0/3";
+
+// Parameter for the POSIX time zone, the daily counters start at local midnight
+char timeZoneParamValue[48];
+IotWebConfTextParameter timeZoneParam = IotWebConfTextParameter("Time zone (POSIX TZ)", "timeZone", timeZoneParamValue, 48, DEFAULT_TIME_ZONE);
+
+// Parameter group for the power management
+IotWebConfParameterGroup groupPower = IotWebConfParameterGroup("groupPower", "Power Settings");
+
+// Parameter for the low power mode while the display is off
+char lowPowerParamValue[8];
+IotWebConfCheckboxParameter lowPowerParam = IotWebConfCheckboxParameter("Low power while display is off", "lowPower", lowPowerParamValue, 8, false);
+
+// Parameter group for the MQTT broker
+IotWebConfParameterGroup groupMqtt = IotWebConfParameterGroup("groupMqtt", "MQTT Settings");
+
+// Parameter for the broker host name or IP, empty = off
+char mqttHostParamValue[64];
+IotWebConfTextParameter mqttHostParam = IotWebConfTextParameter("MQTT broker (empty = off)", "mqttHost", mqttHostParamValue, 64, "");
+
+// Parameter for the broker port
+char mqttPortParamValue[8];
+IotWebConfNumberParameter mqttPortParam = IotWebConfNumberParameter("MQTT port", "mqttPort", mqttPortParamValue, 8, "1883", "1..65535", "min='1' max='65535' step='1'");
+
+// Parameter for the broker user, empty = anonymous
+char mqttUserParamValue[32];
+IotWebConfTextParameter mqttUserParam = IotWebConfTextParameter("MQTT user", "mqttUser", mqttUserParamValue, 32, "");
+
+// Parameter for the broker password
+char mqttPasswordParamValue[32];
+IotWebConfPasswordParameter mqttPasswordParam = IotWebConfPasswordParameter("MQTT password", "mqttPassword", mqttPasswordParamValue, 32, "");
+
+// Parameter for the topic prefix
+char mqttTopicParamValue[32];
+IotWebConfTextParameter mqttTopicParam = IotWebConfTextParameter("MQTT topic prefix", "mqttTopic", mqttTopicParamValue, 32, "solaredge");
+
+// Parameter for the change in watts which is published
+char mqttDeadbandParamValue[8];
+IotWebConfNumberParameter mqttDeadbandParam = IotWebConfNumberParameter("MQTT deadband (W)", "mqttDeadband", mqttDeadbandParamValue, 8, "20", "0..5000", "min='0' max='5000' step='1'");
+
+// Parameter group for the meters, batteries and followers of the site
+IotWebConfParameterGroup groupDevices = IotWebConfParameterGroup("groupDevices", "Device Settings");
+
+// Parameter for the unit ID of the inverter at "Inverter IP"
+char leaderUnitParamValue[4];
+IotWebConfNumberParameter leaderUnitParam = IotWebConfNumberParameter("Inverter unit ID", "leaderUnit", leaderUnitParamValue, 4, "255", "1..255", "min='1' max='255' step='1'");
+
+// Parameter for the meters of the inverter, e.g. "12" for M1 and M2, "0" = none
+char leaderMetersParamValue[4];
+IotWebConfTextParameter leaderMetersParam = IotWebConfTextParameter("Inverter meters (e.g. 12)", "leaderMeters", leaderMetersParamValue, 4, "1");
+
+// Parameter for the batteries of the inverter, e.g. "12" for B1 and B2, "0" = none
+char leaderBatteriesParamValue[4];
+IotWebConfTextParameter leaderBatteriesParam = IotWebConfTextParameter("Inverter batteries (e.g. 12)", "leaderBatteries", leaderBatteriesParamValue, 4, "1");
+
+// Parameters of the first follower, an empty IP = off, the IP of the leader reaches it through the leader
+char follower1IpParamValue[16];
+IotWebConfTextParameter follower1IpParam = IotWebConfTextParameter("Follower 1 IP (empty = off)", "follower1Ip", follower1IpParamValue, 16, "");
+char follower1PortParamValue[8];
+IotWebConfNumberParameter follower1PortParam = IotWebConfNumberParameter("Follower 1 port", "follower1Port", follower1PortParamValue, 8, "1502", "1..65535", "min='1' max='65535' step='1'");
+char follower1UnitParamValue[4];
+IotWebConfNumberParameter follower1UnitParam = IotWebConfNumberParameter("Follower 1 unit ID", "follower1Unit", follower1UnitParamValue, 4, "2", "1..255", "min='1' max='255' step='1'");
+char follower1MetersParamValue[4];
+IotWebConfTextParameter follower1MetersParam = IotWebConfTextParameter("Follower 1 meters", "follower1Meters", follower1MetersParamValue, 4, "0");
+char follower1BatteriesParamValue[4];
+IotWebConfTextParameter follower1BatteriesParam = IotWebConfTextParameter("Follower 1 batteries", "follower1Batteries", follower1BatteriesParamValue, 4, "0");
+
+// Parameters of the second follower
+char follower2IpParamValue[16];
+IotWebConfTextParameter follower2IpParam = IotWebConfTextParameter("Follower 2 IP (empty = off)", "follower2Ip", follower2IpParamValue, 16, "");
+char follower2PortParamValue[8];
+IotWebConfNumberParameter follower2PortParam = IotWebConfNumberParameter("Follower 2 port", "follower2Port", follower2PortParamValue, 8, "1502", "1..65535", "min='1' max='65535' step='1'");
+char follower2UnitParamValue[4];
+IotWebConfNumberParameter follower2UnitParam = IotWebConfNumberParameter("Follower 2 unit ID", "follower2Unit", follower2UnitParamValue, 4, "3", "1..255", "min='1' max='255' step='1'");
+char follower2MetersParamValue[4];
+IotWebConfTextParameter follower2MetersParam = IotWebConfTextParameter("Follower 2 meters", "follower2Meters", follower2MetersParamValue, 4, "0");
+char follower2BatteriesParamValue[4];
+IotWebConfTextParameter follower2BatteriesParam = IotWebConfTextParameter("Follower 2 batteries", "follower2Batteries", follower2BatteriesParamValue, 4, "0");
+
+// Parses a number parameter, an empty or out of range value, e.g. from an older config, gives the default
+long parseNumberParam(const char *value, long min, long max, long defaultValue);
+
+// Parses a list of numbers 1..count, e.g. "13" for the first and third, into a bit mask; "0" = none
+uint8_t parseMaskParam(const char *value, uint8_t count, uint8_t defaultMask);
+
+// Adds a follower if its IP is set and valid
+void addFollower(const char *ip, const char *port, const char *unit, const char *meters, const char *batteries, uint8_t defaultUnit);
+
 
 // ### Screens ################################################################
 // ############################################################################
@@ -92,43 +344,137 @@ IotWebConfNumberParameter inverterPortParam = IotWebConfNumberParameter("Inverte
 #define SCREEN_ADDRESS 0x3C  ///< See datasheet for Address; 0x3D for 128x64, 0x3C for 128x32
 Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
 
+// Sends only the changed parts of the display buffer to the display
+DisplayFlusher flusher(display, Wire, SCREEN_ADDRESS);
+
+// Fast page based drawing of screen 1
+PageBlitter blitter(display);
+
+// Define to compare the page blitter with the GFX drawing of screen 1 at boot
+// #define SCREEN1_BENCHMARK
+
 // which screen is currently shown
 enum CurrentScreen {
     None,
     WifiState,
     Solar1,
-    Solar2
+    Solar2,
+    History,
+    Energy
 };
 
 // At boot time no screen is shown
 CurrentScreen lastScreen = None;
 
+// Is the last snapshot of the previous run shown, until the first poll replaces it?
+boolean bootFrameShown = false;
+
+// The boot frame gives way to the WiFi and Modbus screens if the first poll takes longer
+const unsigned long BOOT_FRAME_MAX_MILLIS = 15000;
+
+// Is the boot frame still shown? Drops it after BOOT_FRAME_MAX_MILLIS
+boolean showingBootFrame();
+
 // Time since display is on
 long displayOnSince;
 
 // Turn display off after this time in minutes to reduce OLED wearing, 0 = always on
 const int DISPLAY_OFF_AFTER_MINS = 15;
 
-// Time since last display update
-long lastDisplayUpdateTime = 0;
-
-// Update interval for display
+// Base update interval for display, adapted by the poller
 const int DISPLAY_UPDATE_INTERVAL_SECS = 5;
 
+// Decides when the inverter is polled and delays attempts after failures
+AdaptivePoller poller(DISPLAY_UPDATE_INTERVAL_SECS * 1000UL);
+
 // Is the display on?
 boolean displayOn = true;
 
+// Request a redraw of the solar screen from the latest snapshot
+boolean renderRequested = false;
+
+// Sequence of the snapshot currently shown
+uint32_t renderedSequence = 0;
+
+// Was the snapshot currently shown stale?
+boolean renderedStale = false;
+
+// Moving power flow arrows and value transitions of screen 1
+FlowAnimator animator;
+
+// Is screen 1 with live values shown and animated by animateTask()?
+boolean animating = false;
+
+// Are the values of the animated screen 1 stale?
+boolean animatedStale = false;
+
+// Is the next animation frame skipped after an overrun?
+boolean skipFrame = false;
+
+// Animation frames drawn and frames over budget since the last metrics
+uint32_t animationFrames = 0;
+uint32_t frameOverruns = 0;
+
+// Formatted values and power flow directions of screen 1
+struct Screen1Values {
+    FixedText<8> sunPower;
+    FixedText<8> houseUsagePower;
+    FixedText<8> batteryPower;
+    FixedText<8> batteryLevelOfEnergy;
+    FixedText<8> meterPower;
+
+    // width of the battery charge level bar in pixels
+    int batteryBarWidth;
+
+    // power flows, 0 = none, 1 = into the battery / to the grid, -1 = out of the battery / from the grid
+    boolean sunFlow;
+    int8_t batteryFlow;
+    int8_t meterFlow;
+};
+
 // Print graphical screen with solar power, battery power, house usage and grid consumption
-void printStateScreen1(char *sunPowerStr, char *houseUsagePower, char *meterPower = nullptr, char *batteryPower = nullptr, char *batteryLevelOfEnergy = nullptr, float batteryLevelOfEnergyPct = 0.0f, float sunPowerPowerKw = 0.0f, float meterPowerKw = 0.0f, float houseUsagePowerKw = 0.0f, float batteryPowerKw = 0.0f, float i_ac_power_norm = 0.0f);
+void printStateScreen1(const SolarSnapshot &snapshot, boolean stale = false);
+
+// Formats the values of screen 1 from a snapshot
+void formatStateScreen1(const SolarSnapshot &snapshot, Screen1Values &values);
+
+// Composes screen 1 into the display buffer using the frame template and the page blitter
+void composeStateScreen1(const Screen1Values &values, boolean stale);
+
+// Draws the power flow arrows of screen 1 at their animated positions or at rest
+void drawFlowArrows(const Screen1Values &values, boolean animated);
+
+// Draws the next animation frame of screen 1, all of it if full, otherwise only what moved or changed
+void animateFrame(boolean full);
+
+#ifdef SCREEN1_BENCHMARK
+// Composes screen 1 with the generic GFX functions, reference for the benchmark
+void composeStateScreen1Gfx(const Screen1Values &values, boolean stale);
+
+// Measures the time to compose screen 1 with both implementations
+void benchmarkScreen1();
+#endif
 
 // Prints a simple 4 lined screen used for multiple purposes
-void printStateScreen2(char *line1, char *line2, char *line3 = nullptr, char *line4 = nullptr);
+void printStateScreen2(const char *line1, const char *line2, const char *line3 = nullptr, const char *line4 = nullptr);
+
+// Sends the changes of the display buffer to the display
+void flushDisplay();
 
 // Print wifi state screen
 void printWifiState();
 
-// Main method for printing solar system usage values
-void printUsage();
+// Print sparklines of the last 24 hours
+void printHistoryScreen();
+
+// Print the energy totals of today
+void printEnergyScreen();
+
+// Main method for printing solar system usage values from a snapshot
+void printUsage(const SolarSnapshot &snapshot, boolean stale);
+
+// Stores the totals of the last site poll as a new snapshot
+void acquireSnapshot();
 
 
 // ### OneButton ##############################################################
@@ -143,20 +489,105 @@ void handleDoubleClick();
 // OneButton: Handle long press stop
 void handleLongPressStop();
 
+// Input pin of the button
+const uint8_t BUTTON_PIN = D5;
+
 OneButton btn = OneButton(
-    D5,     // Input pin for the button
-    false,  // Button is active LOW
-    false   // Enable internal pull-up resistor
+    BUTTON_PIN,  // Input pin for the button
+    false,       // Button is active HIGH
+    false        // Enable internal pull-up resistor
 );
 
 // Count how many times the button was pressed for a long time
 int longPressCount = 0;
 
+// State of the configuration reset dialog
+enum ResetDialogState {
+    ResetNone,
+    ResetConfirm,
+    ResetStarted,
+    ResetErased
+};
+
+ResetDialogState resetDialog = ResetNone;
+
+// Time the current reset dialog state was entered
+unsigned long resetDialogSince = 0;
+
+
+// ### Scheduler ##############################################################
+// ############################################################################
+
+// Cooperative scheduler running all periodic work from loop()
+Scheduler scheduler;
+
+// Free heap and fragmentation telemetry
+HeapMonitor heapMonitor;
+
+// Light sleep and button wake while the display is off
+PowerManager powerManager;
+
+// Time the loop may sleep in low power mode, 0 while work is pending
+uint32_t idleMillis();
+
+// Leaves low power mode after the button woke the monitor
+void wakeUp();
+
+#ifdef MONITOR_PROFILING
+// Timing histograms of the refresh cycle phases
+PhaseProfiler profiler;
+#endif
+
+// Interval for printing metrics
+const unsigned long METRICS_INTERVAL_MILLIS = 60000;
+
+// Task: Modbus connect and poll state machine
+void modbusTask();
+
+// Task: local Modbus server and its upstream reads
+void mirrorTask();
+
+// Task: redraw the solar screen when a new snapshot arrives or the screen changes
+void renderTask();
+
+// Task: switch display off and on
+void displayTask();
+
+// Task: next frame of the animated screen 1
+void animateTask();
+
+// Task: configuration reset dialog and restart
+void resetTask();
+
+// Task: local date of the energy counters and periodic checkpoints
+void energyTask();
+
+// Task: write full sample blocks and continue downloads
+void samplesTask();
+
+// Task: MQTT connection and queued messages
+void mqttTask();
+
+// Task: close finished minutes of the power history
+void historyTask();
+
+// Task: sample heap usage
+void heapTask();
+
+// Task: dashboard keep-alives and closed connections
+void eventsTask();
+
+// Task: print loop latency, display flush and heap metrics
+void metricsTask();
+
 // ### Other method declarations ##############################################
 // ############################################################################
 
-// Helper method for rounding
-float hlpRound(float f);
+// Converts mW to the 0.01 kW units shown on the screens
+int32_t toCentiKw(milliwatt_t mw);
+
+// Gathers heap, WiFi and Modbus health values for the web API
+DeviceHealth collectHealth();
 
 
 // ### Images #################################################################
@@ -229,6 +660,73 @@ const unsigned char img_background[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
+// img_background converted to the display's page layout, rotated by 180 degrees (rotation 2)
+const unsigned char img_background_pages[] PROGMEM = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x20, 0x60, 0xa0, 0x60, 0xa0, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0xa0, 0x60, 0xa0, 0x60, 0x20, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x0c, 0x39, 0xe2, 0xa4, 0x28, 0x30, 0x28,
+    0xa4, 0xe2, 0x39, 0x0c, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xe0, 0x30, 0x18, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08,
+    0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0xf8, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1c, 0x10, 0x3c, 0x28, 0x48, 0x9f, 0x18, 0xb5, 0x52, 0xb5,
+    0x18, 0x9f, 0x48, 0x28, 0x3c, 0x10, 0x1c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x06, 0x0c, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08,
+    0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x81, 0x82, 0x84, 0x82,
+    0x81, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0xff, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xe0, 0x20, 0x20, 0x20, 0x20, 0xe0, 0x20, 0x20,
+    0x20, 0xe0, 0x20, 0x20, 0x20, 0x20, 0xe0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0x00, 0x1f, 0x10, 0x10,
+    0x10, 0x1f, 0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x80, 0x80, 0x80, 0x80, 0x91, 0x02, 0xc4, 0x30, 0x09, 0x08, 0x04, 0x07,
+    0x04, 0x08, 0x09, 0x30, 0xc4, 0x02, 0x91, 0x80, 0x80, 0x80, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0xfc, 0x09, 0x12, 0xe4, 0x48, 0x90, 0x22, 0x45,
+    0x22, 0x90, 0x48, 0x24, 0x12, 0x09, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x44, 0x20, 0x11, 0x06, 0x48, 0x08, 0x10, 0xf0,
+    0x10, 0x08, 0x48, 0x06, 0x11, 0x20, 0x44, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x01, 0x02,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
 const unsigned char img_arr_right_3x7[] PROGMEM = {
     0x00, 0x80, 0xc0, 0xe0, 0xc0, 0x80, 0x00};
 
@@ -240,6 +738,11 @@ const unsigned char img_arr_up_7x3[] PROGMEM = {
 const unsigned char img_arr_down_7x3[] PROGMEM = {
     0x7c, 0x38, 0x10};
 
+// Arrows converted for the page blitter
+const Sprite sprite_arr_right_3x7 = PageBlitter::spriteFromBitmap(img_arr_right_3x7, 3, 7);
+const Sprite sprite_arr_up_7x3 = PageBlitter::spriteFromBitmap(img_arr_up_7x3, 7, 3);
+const Sprite sprite_arr_down_7x3 = PageBlitter::spriteFromBitmap(img_arr_down_7x3, 7, 3);
+
 
 // ### Setup ##################################################################
 // ############################################################################
@@ -259,28 +762,161 @@ void setup() {
     display.setRotation(2);
     display.clearDisplay();
 
+    blitter.begin();
+    bootTimeline.mark("display ready");
+
+    // values of the previous run, marked stale, until the first poll
+    if (bootCache.begin() && bootCache.hasSnapshot()) {
+        printStateScreen1(bootCache.cached().snapshot, true);
+        bootFrameShown = true;
+        bootTimeline.mark("last frame restored");
+    }
+
+#ifdef SCREEN1_BENCHMARK
+    benchmarkScreen1();
+#endif
+
     displayOnSince = millis();
 
     // -- Initializing the configuration.
     groupModbus.addItem(&inverterIpAddressParam);
     groupModbus.addItem(&inverterPortParam);
+    groupModbus.addItem(&pollDeadbandParam);
+    groupModbus.addItem(&serverPortParam);
+    groupModbus.addItem(&serverMaxAgeParam);
     iotWebConf.addParameterGroup(&groupModbus);
+    groupEnergy.addItem(&timeZoneParam);
+    iotWebConf.addParameterGroup(&groupEnergy);
+    groupPower.addItem(&lowPowerParam);
+    iotWebConf.addParameterGroup(&groupPower);
+    groupMqtt.addItem(&mqttHostParam);
+    groupMqtt.addItem(&mqttPortParam);
+    groupMqtt.addItem(&mqttUserParam);
+    groupMqtt.addItem(&mqttPasswordParam);
+    groupMqtt.addItem(&mqttTopicParam);
+    groupMqtt.addItem(&mqttDeadbandParam);
+    iotWebConf.addParameterGroup(&groupMqtt);
+    groupDevices.addItem(&leaderUnitParam);
+    groupDevices.addItem(&leaderMetersParam);
+    groupDevices.addItem(&leaderBatteriesParam);
+    groupDevices.addItem(&follower1IpParam);
+    groupDevices.addItem(&follower1PortParam);
+    groupDevices.addItem(&follower1UnitParam);
+    groupDevices.addItem(&follower1MetersParam);
+    groupDevices.addItem(&follower1BatteriesParam);
+    groupDevices.addItem(&follower2IpParam);
+    groupDevices.addItem(&follower2PortParam);
+    groupDevices.addItem(&follower2UnitParam);
+    groupDevices.addItem(&follower2MetersParam);
+    groupDevices.addItem(&follower2BatteriesParam);
+    iotWebConf.addParameterGroup(&groupDevices);
 
     iotWebConf.setWifiConnectionCallback(&wifiConnected);
+    iotWebConf.setWifiConnectionHandler(connectWifi);
+    iotWebConf.setWifiConnectionFailedHandler(onWifiConnectionFailed);
     iotWebConf.setConfigSavedCallback(&configSaved);
     iotWebConf.setStatusPin(LED_BUILTIN);
     //iotWebConf.setConfigPin(D5);
     iotWebConf.init();
 
+    // a known network skips the access point window at boot, it still opens if the connect fails
+    fastBoot = bootCache.hasNetwork();
+    fastConnectPending = fastBoot;
+    if (fastBoot) {
+        iotWebConf.skipApStartup();
+    }
+    bootTimeline.mark("config loaded");
+
     // -- Set up required URL handlers on the web server.
     server.on("/", [] { iotWebConf.handleConfig(); });
+    server.on("/api/live", handleApiLive);
+    server.on("/metrics", handleMetrics);
+    server.on("/dashboard", handleDashboard);
+    server.on("/events", handleEvents);
+    server.on("/api/samples", handleSamples);
+#ifdef MONITOR_PROFILING
+    server.on("/profile", handleProfile);
+#endif
     server.onNotFound([]() { iotWebConf.handleNotFound(); });
 
-    mb.client();
+    // an empty or out of range value, e.g. from an older config, keeps the default
+    int deadbandWatt = atoi(pollDeadbandParamValue);
+    if (pollDeadbandParamValue[0] != '\0' && deadbandWatt >= 0 && deadbandWatt <= 5000) {
+        poller.setDeadband(deadbandWatt * 1000L);
+    }
+
+    // an empty value, e.g. from an older config, keeps the default
+    if (timeZoneParamValue[0] == '\0') {
+        strncpy(timeZoneParamValue, DEFAULT_TIME_ZONE, sizeof(timeZoneParamValue) - 1);
+        timeZoneParamValue[sizeof(timeZoneParamValue) - 1] = '\0';
+    }
+
+    EnergyState savedEnergy;
+    if (energyLog.begin(savedEnergy)) {
+        energy.restore(savedEnergy);
+        Serial.print("energy counters restored, day ");
+        Serial.println(savedEnergy.day);
+    } else {
+        Serial.println("no energy checkpoint found");
+    }
+    energyCheckpointAt = millis();
+
+    int mqttPort = atoi(mqttPortParamValue);
+    int mqttDeadbandWatt = atoi(mqttDeadbandParamValue);
+    if (mqttDeadbandParamValue[0] != '\0' && mqttDeadbandWatt >= 0 && mqttDeadbandWatt <= 5000) {
+        mqttPublisher.setDeadband(mqttDeadbandWatt * 1000L);
+    }
+    if (mqttHostParamValue[0] != '\0' && mqttPort > 0 && mqttPort <= 65535) {
+        const char *prefix = mqttTopicParamValue[0] != '\0' ? mqttTopicParamValue : "solaredge";
+        mqttPublisher.begin(mqttHostParamValue, mqttPort, mqttUserParamValue, mqttPasswordParamValue, prefix, iotWebConf.getThingName());
+        Serial.print("MQTT broker ");
+        Serial.println(mqttHostParamValue);
+    }
+
+    // the file system is mounted by energyLog
+    if (!sampleLog.begin()) {
+        Serial.println("sample log not available");
+    }
+
+    // applies the register layouts cached in flash
+    configureSite();
+    site.begin();
+
+    int serverPort = atoi(serverPortParamValue);
+    long serverMaxAge = atol(serverMaxAgeParamValue);
+    if (serverMaxAge < 500 || serverMaxAge > 60000) {
+        serverMaxAge = DEFAULT_MIRROR_MAX_AGE_MILLIS;
+    }
+    if (serverPort > 0 && serverPort <= 65535) {
+        mirror.begin(serverPort, serverMaxAge, site.leaderBases());
+        Serial.print("Modbus server on port ");
+        Serial.println(serverPort);
+    }
+
+    Serial.print("devices: ");
+    Serial.print(site.deviceCount());
+    Serial.print(", connections: ");
+    Serial.println(site.connectionCount());
 
     btn.attachClick(handleClick);
     btn.attachDoubleClick(handleDoubleClick);
     btn.attachLongPressStop(handleLongPressStop);
+    powerManager.begin(BUTTON_PIN);
+
+    scheduler.addTask("modbus", modbusTask, 0);
+    scheduler.addTask("mirror", mirrorTask, 0);
+    // the display tasks are paused in low power mode, they would cut every sleep short
+    scheduler.addTask("render", renderTask, 50, true);
+    scheduler.addTask("animate", animateTask, ANIMATION_FRAME_MILLIS, true);
+    scheduler.addTask("display", displayTask, 200, true);
+    scheduler.addTask("reset", resetTask, 100, true);
+    scheduler.addTask("heap", heapTask, 10000);
+    scheduler.addTask("history", historyTask, 1000);
+    scheduler.addTask("energy", energyTask, 1000);
+    scheduler.addTask("samples", samplesTask, 0);
+    scheduler.addTask("mqtt", mqttTask, 0);
+    scheduler.addTask("metrics", metricsTask, METRICS_INTERVAL_MILLIS);
+    scheduler.addTask("events", eventsTask, 1000);
 
     Serial.println("setup done");
 }
@@ -290,68 +926,600 @@ void setup() {
 // ############################################################################
 
 void loop() {
-    if (needReset) {
-        // config changes require reset
-        Serial.println("restart in 1 sec");
-        delay(1000);
-        ESP.restart();
+    PROFILE_SCOPE(PhaseLoop);
+
+    // low power is only entered with the display off and no dialog; a lost WiFi or a pending restart needs the display and reset tasks
+    scheduler.setPaused(powerManager.lowPower() && connected && !needReset);
+    scheduler.run();
+
+    site.task();
+    {
+        PROFILE_SCOPE(PhaseWeb);
+        iotWebConf.doLoop();
+    }
+    if (!powerManager.lowPower()) {
+        btn.tick();
+    } else if (powerManager.takeWake()) {
+        wakeUp();
+    } else {
+        // the button interrupt ends the sleep, OneButton is not polled
+        powerManager.sleep(idleMillis());
+        scheduler.markAwake();
     }
 
+#ifdef MONITOR_PROFILING
+    profiler.handleSerial(Serial);
+#endif
+}
+
+// Shows the Modbus init screen with the configured connection and a status line
+void printModbusInitScreen(const char *status) {
+    if (resetDialog != ResetNone || showingBootFrame()) {
+        return;
+    }
+
+    ScreenLine line2("IP: ");
+    line2.append(inverterIpAddressParamValue);
+    ScreenLine line3("Port: ");
+    line3.append(inverterPortParamValue);
+
+    printStateScreen2("Init Modbus client", line2.c_str(), line3.c_str(), status);
+}
+
+void setModbusState(ModbusState state) {
+    modbusState = state;
+    modbusStateSince = millis();
+}
+
+unsigned long modbusScreenMillis() {
+    // on a warm boot the connect starts right after the WiFi, behind the boot frame
+    return showingBootFrame() ? 0 : MODBUS_INIT_SCREEN_MILLIS;
+}
+
+void modbusTask() {
     if (!connected) {
-        printWifiState();
+        if (resetDialog == ResetNone && !showingBootFrame()) {
+            printWifiState();
+        }
+        return;
     }
 
-    if (connected) {
-        if (!mb.isConnected(remote)) {
+    unsigned long inState = millis() - modbusStateSince;
+
+    switch (modbusState) {
+        case MbDisconnected: {
+            // connect attempts after failures are delayed by the backoff
+            if (!poller.due()) {
+                break;
+            }
+            poller.started();
+
             Serial.print("Inverter IP address: ");
             Serial.println(inverterIpAddressParamValue);
             Serial.print("Inverter TCP port: ");
             Serial.println(inverterPortParamValue);
 
-            String line1 = "Init Modbus client";
-            String ipStr(inverterIpAddressParamValue);
-            String line2 = "IP: " + ipStr;
-            String portStr(inverterPortParamValue);
-            String line3 = "Port: " + portStr;
-            String line4 = "";
+            site.invalidate();
+
+            printModbusInitScreen("");
+            setModbusState(MbShowInit);
+            break;
+        }
+
+        case MbShowInit: {
+            if (inState < modbusScreenMillis()) {
+                break;
+            }
+
+            if (site.deviceCount() == 0) {
+                printModbusInitScreen("> IP is invalid");
+            } else if (site.connectionCount() == 1) {
+                // single blocking TCP connect, bounded by the WiFiClient timeout
+                boolean connected = site.connect() == 1;
+                bootTimeline.mark("modbus connected");
+                printModbusInitScreen(connected ? "> Modbus connected" : "> Modbus conn. failed");
+            } else {
+                // one blocking connect per address
+                ScreenLine status("> ");
+                status.appendUInt(site.connect()).append('/').appendUInt(site.connectionCount()).append(" connected");
+                bootTimeline.mark("modbus connected");
+                printModbusInitScreen(status.c_str());
+            }
+            setModbusState(MbShowResult);
+            break;
+        }
 
-            port = atoi(inverterPortParamValue);
+        case MbShowResult: {
+            if (inState >= modbusScreenMillis()) {
+                if (site.isConnected()) {
+                    poller.reset();
+                    setModbusState(MbIdle);
+                } else {
+                    // show the connect screens from now on
+                    bootFrameShown = false;
+                    poller.failed();
+                    setModbusState(MbDisconnected);
+                }
+            }
+            break;
+        }
 
-            boolean valid = remote.fromString(inverterIpAddressParamValue);
-            if (!valid) {
-                line4 = "> IP is invalid";
+        case MbIdle: {
+            if (!site.isConnected()) {
+                site.cancel();
+                setModbusState(MbDisconnected);
+                break;
             }
-            printStateScreen2(&line1[0], &line2[0], &line3[0], &line4[0]);
-            delay(2000);
-
-            if (valid) {
-                boolean connected = mb.connect(remote, port);
-                line4 = connected ? "> Modbus connected" : "> Modbus conn. failed";
-                printStateScreen2(&line1[0], &line2[0], &line3[0], &line4[0]);
-                delay(2000);
+
+            if (poller.due()) {
+                poller.started();
+                boolean metadata = !site.metadataValid();
+                if (site.submit(onSiteRead)) {
+                    // metadata cycles read more blocks, only plain polls are timed
+                    if (!metadata) {
+                        PROFILE_BEGIN(PhasePoll);
+                    }
+                    setModbusState(metadata ? MbMetadata : MbPolling);
+                } else {
+                    poller.failed();
+                }
             }
+            break;
+        }
+
+        case MbMetadata:
+        case MbPolling: {
+            // completion is reported by onSiteRead()
+            if (!site.isConnected()) {
+                site.cancel();
+                poller.failed();
+                setModbusState(MbDisconnected);
+            }
+            break;
+        }
+    }
+}
+
+void onSiteRead(ReadPlanner &plan, bool success) {
+    // the cycle ends with the slowest device
+    if (!site.finish(plan, success)) {
+        return;
+    }
+
+    if (modbusState == MbMetadata) {
+        // a discovery in this cycle may have moved the blocks of the leader
+        if (site.cycleSucceeded()) {
+            mirror.rebase(site.leaderBases());
+        }
+
+        // poll right away once all caches are filled, otherwise retry after the backoff
+        if (site.cycleSucceeded() && site.metadataValid() && site.submit(onSiteRead)) {
+            PROFILE_BEGIN(PhasePoll);
+            setModbusState(MbPolling);
         } else {
-            if ((int)millis() > lastDisplayUpdateTime + DISPLAY_UPDATE_INTERVAL_SECS * 1000 && displayOn) {
-                // init to Solar1
-                lastScreen = lastScreen == None || lastScreen == WifiState ? Solar1 : lastScreen;
+            poller.failed();
+            setModbusState(MbIdle);
+        }
+        return;
+    }
+
+    PROFILE_END(PhasePoll);
 
-                printUsage();
+    if (site.cycleSucceeded()) {
+        PROFILE_SCOPE(PhaseSnapshot);
 
-                lastDisplayUpdateTime = millis();
+        if (!snapshots.hasData()) {
+            bootTimeline.mark("first poll");
+        }
+        acquireSnapshot();
+        bootCache.saveSnapshot(snapshots.latest());
+        poller.succeeded(snapshots.latest());
+        events.publish(snapshots.latest());
+        mqttPublisher.publish(snapshots.latest());
+        history.add(snapshots.latest());
+        energy.add(snapshots.latest());
+
+        // samples without a valid time could not be found by a download
+        time_t now = time(nullptr);
+        if (now > MIN_VALID_TIME) {
+            sampleLog.add(now, snapshots.latest());
+        }
+    } else {
+        poller.failed();
+    }
+
+    setModbusState(MbIdle);
+}
+
+boolean modbusReady() {
+    return modbusState == MbIdle || modbusState == MbPolling || modbusState == MbMetadata;
+}
+
+void mirrorTask() {
+    mirror.task(modbusReady());
+}
+
+void renderTask() {
+    if (!connected || resetDialog != ResetNone || !snapshots.hasData()) {
+        return;
+    }
+
+    // keep Modbus init screens until polling starts
+    if (!modbusReady()) {
+        return;
+    }
+
+    const SolarSnapshot &snapshot = snapshots.latest();
+    boolean stale = snapshots.isStale(poller.staleAfterMillis());
+
+    if (!renderRequested && snapshot.sequence == renderedSequence && stale == renderedStale) {
+        return;
+    }
+
+    // init to Solar1
+    lastScreen = lastScreen == None || lastScreen == WifiState ? Solar1 : lastScreen;
+
+    printUsage(snapshot, stale);
+    bootFrameShown = false;
+    bootTimeline.finish(fastBoot);
+
+    renderRequested = false;
+    renderedSequence = snapshot.sequence;
+    renderedStale = stale;
+}
+
+void animateTask() {
+    // nobody sees the animation with the display off
+    if (!animating || !displayOn || resetDialog != ResetNone) {
+        return;
+    }
+
+    // leave the loop to the web server and the button after a frame over budget
+    if (skipFrame) {
+        skipFrame = false;
+        return;
+    }
+
+    animateFrame(false);
+}
+
+void displayTask() {
+    if (DISPLAY_OFF_AFTER_MINS != 0 && (int)millis() > displayOnSince + DISPLAY_OFF_AFTER_MINS * 60 * 1000) {
+        if (displayOn) {
+            display.ssd1306_command(SSD1306_DISPLAYOFF);
+            displayOn = false;
+        }
+    } else if (!displayOn) {
+        display.ssd1306_command(SSD1306_DISPLAYON);
+        displayOn = true;
+    }
+
+    // nobody looks at the values, poll rarely and sleep in between
+    poller.setIdle(!displayOn);
+    powerManager.setLowPower(lowPowerParam.isChecked() && connected && !displayOn && resetDialog == ResetNone);
+}
+
+uint32_t idleMillis() {
+    // responses, dialogs and streams need the loop at full speed
+    if (modbusState != MbIdle || site.leaderPipeline().busy() || needReset || events.subscribers() > 0 || sampleLog.downloadActive()) {
+        return 0;
+    }
+    return min(scheduler.millisUntilDue(), poller.millisUntilDue());
+}
+
+void wakeUp() {
+    Serial.println("woken by button");
+    displayOnSince = millis();
+    powerManager.setLowPower(false);
+
+    // display on and polling at the normal rate right away
+    displayTask();
+    renderRequested = true;
+}
+
+void resetTask() {
+    unsigned long inState = millis() - resetDialogSince;
+
+    switch (resetDialog) {
+        case ResetNone:
+            break;
+
+        case ResetConfirm:
+            if (inState >= 5000) {
+                resetDialog = ResetNone;
+                renderRequested = true;  // redraw solar screen
+                if (lastScreen == WifiState) {
+                    lastScreen = None;  // redraw wifi screen
+                }
+            }
+            break;
+
+        case ResetStarted:
+            if (inState >= 2000) {
+                printStateScreen2("Reset configuration", "Config erased", "Rebooting");
+
+                resetDialog = ResetErased;
+                resetDialogSince = millis();
             }
+            break;
 
-            if (DISPLAY_OFF_AFTER_MINS != 0 && (int)millis() > displayOnSince + DISPLAY_OFF_AFTER_MINS * 60 * 1000) {
-                display.ssd1306_command(SSD1306_DISPLAYOFF);
-                displayOn = false;
-            } else if (!displayOn) {
-                display.ssd1306_command(SSD1306_DISPLAYON);
-                displayOn = true;
+        case ResetErased:
+            if (inState >= 5000) {
+                needReset = true;
             }
+            break;
+    }
+
+    if (needReset) {
+        // config changes require reset
+        if (needResetSince == 0) {
+            Serial.println("restart in 1 sec");
+            needResetSince = millis();
+        } else if (millis() - needResetSince >= RESTART_DELAY_MILLIS) {
+            // keep the energy since the last checkpoint and the samples in RAM
+            checkpointEnergy();
+            sampleLog.flush();
+            ESP.restart();
         }
     }
+}
 
-    iotWebConf.doLoop();
-    btn.tick();
+void eventsTask() {
+    events.task();
+}
+
+void energyTask() {
+    time_t now = time(nullptr);
+
+    // before the first NTP sync the clock starts at 1970, keep the day of the last checkpoint
+    if (now > MIN_VALID_TIME) {
+        struct tm local;
+        localtime_r(&now, &local);
+        uint32_t day = (local.tm_year + 1900) * 10000UL + (local.tm_mon + 1) * 100 + local.tm_mday;
+        if (energy.setDay(day)) {
+            Serial.print("new energy day ");
+            Serial.println(day);
+            checkpointEnergy();
+            if (lastScreen == Energy) {
+                renderRequested = true;
+            }
+        }
+    }
+
+    if (millis() - energyCheckpointAt >= ENERGY_CHECKPOINT_MILLIS) {
+        checkpointEnergy();
+    }
+}
+
+void checkpointEnergy() {
+    if (!energyLog.append(energy.current())) {
+        Serial.println("energy checkpoint failed");
+    }
+
+    // the last snapshot for the boot frame after a power cut
+    bootCache.persist();
+    energyCheckpointAt = millis();
+}
+
+void samplesTask() {
+    sampleLog.task();
+}
+
+void mqttTask() {
+    // the broker is only reachable through the WiFi
+    if (connected) {
+        mqttPublisher.task();
+    }
+}
+
+void historyTask() {
+    uint32_t minute = history.currentMinute();
+    history.tick();
+
+    // the history screen changes once per minute, not with every poll
+    if (lastScreen == History && history.currentMinute() != minute) {
+        renderRequested = true;
+    }
+}
+
+void heapTask() {
+    heapMonitor.sample();
+}
+
+void metricsTask() {
+    Serial.print("loop max us: ");
+    Serial.print(scheduler.maxLoopMicros());
+    Serial.print(", slowest task: ");
+    Serial.print(scheduler.slowestTask());
+    Serial.print(" ");
+    Serial.print(scheduler.maxTaskMicros());
+    Serial.println(" us");
+
+    Serial.print("display frames: ");
+    Serial.print(flusher.frames());
+    Serial.print(", last frame bytes: ");
+    Serial.print(flusher.lastFrameBytes());
+    Serial.print(", avg frame bytes: ");
+    Serial.print(flusher.frames() > 0 ? flusher.totalBytes() / flusher.frames() : 0);
+    Serial.print(" (full frame ");
+    Serial.print(FULL_FRAME_BYTES);
+    Serial.println(")");
+
+    heapMonitor.print();
+
+    Serial.print("register cache hits: ");
+    Serial.print(site.cacheHits());
+    Serial.print(", misses: ");
+    Serial.println(site.cacheMisses());
+
+    Serial.print("layout discoveries: ");
+    Serial.print(site.discoveries());
+    Serial.print(", flash writes: ");
+    Serial.println(site.layoutCache().writes());
+
+    Serial.print("modbus cycle ms: ");
+    Serial.print(site.lastCycleMillis());
+    Serial.print(", requests: ");
+    Serial.print(site.requests());
+    Serial.print(", retries: ");
+    Serial.print(site.retries());
+    Serial.print(", timeouts: ");
+    Serial.print(site.timeouts());
+    Serial.print(", late: ");
+    Serial.print(site.lateResponses());
+    Serial.print(", max in flight: ");
+    Serial.println(site.maxInFlight());
+
+    if (mirror.enabled()) {
+        Serial.print("modbus server hits: ");
+        Serial.print(mirror.hits());
+        Serial.print(", misses: ");
+        Serial.print(mirror.misses());
+        Serial.print(", upstream reads: ");
+        Serial.println(mirror.fetches());
+    }
+
+    Serial.print("dashboard subscribers: ");
+    Serial.print(events.subscribers());
+    Serial.print(", dropped: ");
+    Serial.println(events.dropped());
+
+    Serial.print("energy checkpoints: ");
+    Serial.print(energyLog.writes());
+    Serial.print(", today production Wh: ");
+    Serial.print((unsigned long)(energy.today(EnergyProduction) / 1000));
+    Serial.print(", consumption Wh: ");
+    Serial.println((unsigned long)(energy.today(EnergyConsumption) / 1000));
+
+    Serial.print("sample blocks: ");
+    Serial.print(sampleLog.blocks());
+    Serial.print(", written: ");
+    Serial.print(sampleLog.writes());
+    Serial.print(", dropped: ");
+    Serial.println(sampleLog.dropped());
+
+    if (mqttPublisher.enabled()) {
+        Serial.print("mqtt connected: ");
+        Serial.print(mqttPublisher.connected() ? "yes" : "no");
+        Serial.print(", published: ");
+        Serial.print(mqttPublisher.published());
+        Serial.print(", dropped: ");
+        Serial.print(mqttPublisher.dropped());
+        Serial.print(", queued: ");
+        Serial.print(mqttPublisher.queued());
+        Serial.print(", latency ms: ");
+        Serial.print(mqttPublisher.lastLatencyMillis());
+        Serial.print(", max: ");
+        Serial.println(mqttPublisher.maxLatencyMillis());
+    }
+
+    Serial.print("poll interval ms: ");
+    Serial.print(poller.interval());
+    Serial.print(", backoff ms: ");
+    Serial.print(poller.backoffMillis());
+    Serial.print(", failures in a row: ");
+    Serial.println(poller.failures());
+
+    Serial.print("animation frames: ");
+    Serial.print(animationFrames);
+    Serial.print(", over budget: ");
+    Serial.println(frameOverruns);
+
+    Serial.print("low power: ");
+    Serial.print(powerManager.lowPower() ? "on" : "off");
+    Serial.print(", duty cycle %: ");
+    Serial.print(powerManager.dutyCyclePermille() / 10.0, 1);
+    Serial.print(", wakes: ");
+    Serial.print(powerManager.wakes());
+    Serial.print(", est. current mA: ");
+    Serial.println(powerManager.averageCurrentMilliamps());
+
+    scheduler.resetLatency();
+    flusher.resetStats();
+    powerManager.resetStats();
+    animationFrames = 0;
+    frameOverruns = 0;
+}
+
+DeviceHealth collectHealth() {
+    DeviceHealth health;
+    health.uptimeMillis = millis();
+    health.freeHeap = ESP.getFreeHeap();
+    health.maxFreeBlock = ESP.getMaxFreeBlockSize();
+    health.heapFragmentation = ESP.getHeapFragmentation();
+    health.rssi = WiFi.RSSI();
+    health.loopMaxMicros = scheduler.maxLoopMicros();
+    health.cycleMillis = site.lastCycleMillis();
+    health.pollIntervalMillis = poller.interval();
+    health.requests = site.requests();
+    health.retries = site.retries();
+    health.timeouts = site.timeouts();
+    health.pollFailures = poller.totalFailures();
+    health.mqttPublished = mqttPublisher.published();
+    health.mqttDropped = mqttPublisher.dropped();
+    health.mqttLatencyMillis = mqttPublisher.lastLatencyMillis();
+    health.bootMillis = bootTimeline.firstFrameMillis();
+    health.dutyCyclePermille = powerManager.dutyCyclePermille();
+    health.currentMilliamps = powerManager.averageCurrentMilliamps();
+    return health;
+}
+
+void handleApiLive() {
+    // answered from the snapshot store, never reads from the inverter
+    const FixedText<LIVE_JSON_CAPACITY> &body = webApi.live(snapshots, poller.staleAfterMillis(), collectHealth());
+    server.sendHeader("Cache-Control", "no-cache");
+    server.send(200, "application/json", body.c_str(), body.length());
+}
+
+void handleMetrics() {
+    const FixedText<METRICS_TEXT_CAPACITY> &body = webApi.metrics(snapshots, collectHealth());
+    server.send(200, "text/plain; version=0.0.4", body.c_str(), body.length());
+}
+
+void handleDashboard() {
+    server.send_P(200, "text/html", DASHBOARD_PAGE);
+}
+
+#ifdef MONITOR_PROFILING
+void handleProfile() {
+    const FixedText<PROFILE_TEXT_CAPACITY> &body = profiler.report();
+    server.sendHeader("Cache-Control", "no-cache");
+    server.send(200, "text/plain", body.c_str(), body.length());
+    if (server.hasArg("reset")) {
+        profiler.reset();
+    }
+}
+#endif
+
+void handleEvents() {
+    WiFiClient client = server.client();
+    if (!events.subscribe(client)) {
+        server.send(503, "text/plain", "too many subscribers");
+        return;
+    }
+
+    // like the ServerSentEvents example of the web server: the payload goes on forever
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+}
+
+void handleSamples() {
+    // seconds since 1970, without limits the whole ring
+    uint32_t from = server.hasArg("from") ? strtoul(server.arg("from").c_str(), nullptr, 10) : 0;
+    uint32_t to = server.hasArg("to") ? strtoul(server.arg("to").c_str(), nullptr, 10) : UINT32_MAX;
+
+    if (from > to) {
+        server.send(400, "text/plain", "from after to");
+        return;
+    }
+
+    WiFiClient client = server.client();
+    if (!sampleLog.download(client, from, to)) {
+        server.send(503, "text/plain", "download running");
+        return;
+    }
+
+    // the blocks are sent by samplesTask(), like the events the response goes on after the handler
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
 }
 
 void handleClick() {
@@ -366,39 +1534,33 @@ void handleDoubleClick() {
     if (lastScreen == Solar1) {
         lastScreen = Solar2;
     } else if (lastScreen == Solar2) {
+        lastScreen = History;
+    } else if (lastScreen == History) {
+        lastScreen = Energy;
+    } else if (lastScreen == Energy) {
         lastScreen = Solar1;
     }
 
-    lastDisplayUpdateTime = 0;
+    // redraw from the latest snapshot, no Modbus reads required
+    renderRequested = true;
 }
 
 
 void handleLongPressStop() {
     longPressCount++;
 
-    String line1 = "Reset configuration";
-    String line2 = "";
-    String line3 = "";
-
     if (longPressCount == 1) {
-        line2 = "Press again to reset";
-        printStateScreen2(&line1[0], &line2[0], &line3[0]);
-        delay(5000);
+        printStateScreen2("Reset configuration", "Press again to reset", "");
+        resetDialog = ResetConfirm;
     }
     else {
-        line2 = "Reset started";
-        printStateScreen2(&line1[0], &line2[0], &line3[0]);
+        printStateScreen2("Reset configuration", "Reset started", "");
         iotWebConf.getSystemParameterGroup()->applyDefaultValue();
         iotWebConf.saveConfig();
-        needReset = true;
-        delay(2000);
-
-        line2 = "Config erased";
-        line3 = "Rebooting";
-        printStateScreen2(&line1[0], &line2[0], &line3[0]);
-        delay(5000);
+        resetDialog = ResetStarted;
     }
 
+    resetDialogSince = millis();
 }
 
 void configSaved() {
@@ -406,18 +1568,128 @@ void configSaved() {
     needReset = true;
 }
 
+long parseNumberParam(const char *value, long min, long max, long defaultValue) {
+    char *end;
+    long number = strtol(value, &end, 10);
+    if (value[0] == '\0' || *end != '\0' || number < min || number > max) {
+        return defaultValue;
+    }
+    return number;
+}
+
+uint8_t parseMaskParam(const char *value, uint8_t count, uint8_t defaultMask) {
+    if (value[0] == '\0') {
+        return defaultMask;
+    }
+    if (strcmp(value, "0") == 0) {
+        return 0;
+    }
+
+    uint8_t mask = 0;
+    for (const char *c = value; *c != '\0'; c++) {
+        if (*c < '1' || *c >= '1' + count) {
+            return defaultMask;
+        }
+        mask |= 1 << (*c - '1');
+    }
+    return mask;
+}
+
+void addFollower(const char *ip, const char *port, const char *unit, const char *meters, const char *batteries, uint8_t defaultUnit) {
+    DeviceConfig follower;
+    if (ip[0] == '\0' || !follower.remote.fromString(ip)) {
+        return;
+    }
+    follower.port = parseNumberParam(port, 1, 65535, DEFAULT_INVERTER_PORT);
+    follower.unit = parseNumberParam(unit, 1, 255, defaultUnit);
+    follower.meters = parseMaskParam(meters, MAX_METERS, 0);
+    follower.batteries = parseMaskParam(batteries, MAX_BATTERIES, 0);
+    site.addDevice(follower);
+}
+
+void configureSite() {
+    // followers without a valid leader would report partial totals
+    DeviceConfig leader;
+    if (!leader.remote.fromString(inverterIpAddressParamValue)) {
+        return;
+    }
+    leader.port = parseNumberParam(inverterPortParamValue, 1, 65535, DEFAULT_INVERTER_PORT);
+    leader.unit = parseNumberParam(leaderUnitParamValue, 1, 255, MODBUSIP_UNIT);
+    leader.meters = parseMaskParam(leaderMetersParamValue, MAX_METERS, 0x01);
+    leader.batteries = parseMaskParam(leaderBatteriesParamValue, MAX_BATTERIES, 0x01);
+    site.addDevice(leader);
+
+    addFollower(follower1IpParamValue, follower1PortParamValue, follower1UnitParamValue, follower1MetersParamValue, follower1BatteriesParamValue, 2);
+    addFollower(follower2IpParamValue, follower2PortParamValue, follower2UnitParamValue, follower2MetersParamValue, follower2BatteriesParamValue, 3);
+}
+
 void wifiConnected() {
     connected = true;
     Serial.println("wifi connected");
+    bootTimeline.mark("wifi connected");
+
+    // access point, channel and lease for the next boot
+    fastConnectPending = false;
+    bootCache.saveNetwork();
+    if (cachedLeaseApplied) {
+        // the lease only saved the DHCP round trip, the DHCP client renews it from here on
+        WiFi.config(IPAddress(), IPAddress(), IPAddress());
+        cachedLeaseApplied = false;
+    }
 
-    // hack for getting hostname set correctly
+    // local date for the daily energy counters
+    configTime(timeZoneParamValue, NTP_SERVER);
+}
+
+void connectWifi(const char *ssid, const char *password) {
+    // set before connecting, so the DHCP request carries the thing name
     WiFi.hostname(iotWebConf.getThingName());
-    WiFi.begin();
+
+    if (!fastConnectPending) {
+        iotWebConf.setWifiConnectionTimeoutMs(WIFI_CONNECT_TIMEOUT_MILLIS);
+        WiFi.begin(ssid, password);
+        return;
+    }
+
+    // no scan for the access point, and no DHCP if the lease is from before a restart
+    const BootRecord &cached = bootCache.cached();
+    if (bootCache.hasLease()) {
+        WiFi.config(IPAddress(cached.ip), IPAddress(cached.gateway), IPAddress(cached.subnet), IPAddress(cached.dns));
+        cachedLeaseApplied = true;
+    }
+    iotWebConf.setWifiConnectionTimeoutMs(FAST_CONNECT_TIMEOUT_MILLIS);
+    WiFi.begin(ssid, password, cached.channel, cached.bssid);
+    bootTimeline.mark("wifi fast connect");
+}
+
+iotwebconf::WifiAuthInfo *onWifiConnectionFailed() {
+    if (!fastConnectPending) {
+        // access point mode, IotWebConf tries again later
+        return nullptr;
+    }
+
+    // the access point or its channel changed: forget it and scan right away
+    Serial.println("fast WiFi connect failed, scanning");
+    fastConnectPending = false;
+    bootCache.forgetNetwork();
+    WiFi.config(IPAddress(), IPAddress(), IPAddress());
+    cachedLeaseApplied = false;
+    bootTimeline.mark("wifi fast connect failed");
+
+    wifiRetryAuth = iotWebConf.getWifiAuthInfo();
+    return &wifiRetryAuth;
+}
+
+boolean showingBootFrame() {
+    if (bootFrameShown && millis() > BOOT_FRAME_MAX_MILLIS) {
+        bootFrameShown = false;
+    }
+    return bootFrameShown;
 }
 
 void printWifiState() {
     if (iotWebConf.getState() != lastNetWorkState || lastScreen != WifiState) {
-        String state = "";
+        const char *state = "";
         switch (iotWebConf.getState()) {
             case iotwebconf::NetworkState::ApMode:
                 state = "Access Point Mode";
@@ -439,15 +1711,16 @@ void printWifiState() {
                 break;
         }
 
-        String initString = "Init WiFi connection";
-        printStateScreen2(&initString[0], &state[0]);
+        printStateScreen2("Init WiFi connection", state);
 
         lastNetWorkState = iotWebConf.getState();
         lastScreen = WifiState;
     }
 }
 
-void printStateScreen2(char *line1, char *line2, char *line3, char *line4) {
+void printStateScreen2(const char *line1, const char *line2, const char *line3, const char *line4) {
+    // status and dialog screens replace the animated screen 1
+    animating = false;
     display.clearDisplay();
 
     display.setTextSize(1);
@@ -468,11 +1741,154 @@ void printStateScreen2(char *line1, char *line2, char *line3, char *line4) {
         display.println(line4);
     }
 
-    display.display();
-    delay(500);
+    flushDisplay();
+}
+
+void printStateScreen1(const SolarSnapshot &snapshot, boolean stale) {
+    Screen1Values values;
+    {
+        PROFILE_SCOPE(PhaseFormat);
+        formatStateScreen1(snapshot, values);
+    }
+    {
+        PROFILE_SCOPE(PhaseCompose);
+        composeStateScreen1(values, stale);
+    }
+    flushDisplay();
+}
+
+void animateFrame(boolean full) {
+    unsigned long start = micros();
+
+    Screen1Values values;
+    boolean changed = animator.advance(millis());
+    {
+        PROFILE_SCOPE(PhaseFormat);
+        formatStateScreen1(animator.shown(), values);
+    }
+    {
+        PROFILE_SCOPE(PhaseCompose);
+        // the rest of the frame only changes while the values move
+        if (full || changed) {
+            composeStateScreen1(values, animatedStale);
+        }
+        drawFlowArrows(values, true);
+    }
+    flushDisplay();
+
+    animationFrames++;
+    if (micros() - start > FRAME_BUDGET_MICROS) {
+        frameOverruns++;
+        skipFrame = true;
+    }
+}
+
+void flushDisplay() {
+    PROFILE_SCOPE(PhaseFlush);
+    flusher.flush();
+}
+
+void formatStateScreen1(const SolarSnapshot &snapshot, Screen1Values &values) {
+    // sun and house are shown with sign, battery and meter as absolute value plus arrow
+    values.sunPower.clear().appendFixed(toCentiKw(snapshot.sunPower), 2, 4);
+    values.houseUsagePower.clear().appendFixed(toCentiKw(snapshot.houseUsage), 2, 4);
+
+    int32_t batteryCentiKw = toCentiKw(snapshot.batteryPower);
+    values.batteryPower.clear().appendFixed(batteryCentiKw < 0 ? -batteryCentiKw : batteryCentiKw, 2, 4);
+
+    int32_t meterCentiKw = toCentiKw(snapshot.meterPower);
+    values.meterPower.clear().appendFixed(meterCentiKw < 0 ? -meterCentiKw : meterCentiKw, 2, 4);
+
+    values.batteryLevelOfEnergy.clear().appendFixed(divRound(snapshot.batteryStateOfEnergy, 10), 0, 3).append('%');
+
+    // draw battery charge level
+    const int BATT_WIDTH = 17;
+    decipercent_t soe = constrain<decipercent_t>(snapshot.batteryStateOfEnergy, 0, 1000);
+    values.batteryBarWidth = soe * BATT_WIDTH / 1000;
+
+    values.sunFlow = snapshot.inverterPower > 0;
+    values.batteryFlow = batteryCentiKw == 0 ? 0 : (batteryCentiKw < 0 ? -1 : 1);
+    values.meterFlow = meterCentiKw == 0 ? 0 : (meterCentiKw < 0 ? -1 : 1);
 }
 
-void printStateScreen1(char *sunPowerStr, char *houseUsagePower, char *meterPower, char *batteryPower, char *batteryLevelOfEnergy, float batteryLevelOfEnergyPct, float sunPowerPowerKw, float meterPowerKw, float houseUsagePowerKw, float batteryPowerKw, float i_ac_power_norm) {
+void composeStateScreen1(const Screen1Values &values, boolean stale) {
+    blitter.loadTemplate(img_background_pages);
+
+    // #######
+    // # Sun #
+    // #######
+    blitter.drawText(33, 13, values.sunPower.c_str());
+    blitter.drawText(33, 23, "  kW");
+
+    // #########
+    // # House #
+    // #########
+    blitter.drawText(98, 13, values.houseUsagePower.c_str());
+    blitter.drawText(98, 23, "  kW");
+
+    // ###########
+    // # Battery #
+    // ###########
+    blitter.drawText(33, 45, values.batteryPower.c_str());
+    blitter.drawText(33, 55, "  kW");
+
+    blitter.drawText(4, 57, values.batteryLevelOfEnergy.c_str());
+
+    // draw battery charge level
+    blitter.fillRect(7, 46, values.batteryBarWidth, 5, SSD1306_WHITE);
+
+    // #########
+    // # Meter #
+    // #########
+    blitter.drawText(98, 45, values.meterPower.c_str());
+    blitter.drawText(98, 55, "  kW");
+
+    drawFlowArrows(values, false);
+
+    // mark values of an old snapshot in the empty top left corner
+    if (stale) {
+        blitter.drawText(0, 0, "?");
+    }
+}
+
+void drawFlowArrows(const Screen1Values &values, boolean animated) {
+    // arrows rest in these positions of their boxes when not animated
+    uint8_t sunStep = animated ? animator.step(FlowSun) : 0;
+    uint8_t batteryStep = animated ? animator.step(FlowBattery) : 2;
+    uint8_t meterStep = animated ? animator.step(FlowMeter) : 2;
+
+    // print pv system to house power flow arrow, it moves to the right
+    blitter.restoreRect(img_background_pages, 62, 13, 7, 9);
+    if (values.sunFlow) {
+        blitter.fillRect(63, 13, 6, 9, SSD1306_BLACK);
+        blitter.drawSprite(62 + sunStep, 14, sprite_arr_right_3x7);
+    }
+
+    // print battery power flow arrow, it moves down while charging and up while discharging
+    blitter.restoreRect(img_background_pages, 28, 29, 9, 6);
+    if (values.batteryFlow != 0) {
+        blitter.fillRect(28, 29, 9, 6, SSD1306_BLACK);
+        if (values.batteryFlow < 0) {
+            blitter.drawSprite(29, 29 + (animated ? FLOW_STEPS - 1 - batteryStep : batteryStep), sprite_arr_up_7x3);
+        } else {
+            blitter.drawSprite(29, 29 + batteryStep, sprite_arr_down_7x3);
+        }
+    }
+
+    // print meter power flow arrow, it moves down while exporting and up while importing
+    blitter.restoreRect(img_background_pages, 95, 29, 9, 6);
+    if (values.meterFlow != 0) {
+        blitter.fillRect(95, 29, 9, 6, SSD1306_BLACK);
+        if (values.meterFlow < 0) {
+            blitter.drawSprite(96, 29 + (animated ? FLOW_STEPS - 1 - meterStep : meterStep), sprite_arr_up_7x3);
+        } else {
+            blitter.drawSprite(96, 29 + meterStep, sprite_arr_down_7x3);
+        }
+    }
+}
+
+#ifdef SCREEN1_BENCHMARK
+void composeStateScreen1Gfx(const Screen1Values &values, boolean stale) {
     display.clearDisplay();
 
     display.drawBitmap(0, 0, img_background, 128, 64, 1);
@@ -484,7 +1900,7 @@ void printStateScreen1(char *sunPowerStr, char *houseUsagePower, char *meterPowe
     // # Sun #
     // #######
     display.setCursor(33, 13);
-    display.println(sunPowerStr);
+    display.println(values.sunPower.c_str());
     display.setCursor(33, 23);
     display.println("  kW");
 
@@ -492,12 +1908,12 @@ void printStateScreen1(char *sunPowerStr, char *houseUsagePower, char *meterPowe
     // # House #
     // #########
     display.setCursor(98, 13);
-    display.println(houseUsagePower);
+    display.println(values.houseUsagePower.c_str());
     display.setCursor(98, 23);
     display.println("  kW");
 
     // print pv system to house power flow arrow
-    if (i_ac_power_norm > 0) {
+    if (values.sunFlow) {
         display.fillRect(63, 13, 6, 9, SSD1306_BLACK);
         display.drawBitmap(62, 14, img_arr_right_3x7, 3, 7, 1);
     }
@@ -505,39 +1921,21 @@ void printStateScreen1(char *sunPowerStr, char *houseUsagePower, char *meterPowe
     // ###########
     // # Battery #
     // ###########
-
-    float batteryPowerKwAbs = batteryPowerKw < 0 ? batteryPowerKw * -1 : batteryPowerKw;
-    char batteryPowerFmt[4];
-    dtostrf(batteryPowerKwAbs, 4, 2, batteryPowerFmt);
-    String batteryPowerAbsStr(batteryPowerFmt);
-
     display.setCursor(33, 45);
-    display.println(batteryPowerAbsStr);
+    display.println(values.batteryPower.c_str());
     display.setCursor(33, 55);
     display.println("  kW");
 
-    String batteryLevelOfEnergyFmt(batteryLevelOfEnergy);
-    batteryLevelOfEnergyFmt += "%";
-
     display.setCursor(4, 57);
-    display.println(batteryLevelOfEnergyFmt);
+    display.println(values.batteryLevelOfEnergy.c_str());
 
     // draw battery charge level
-    const int BATT_X = 7;
-    const int BATT_Y = 46;
-    const int BATT_WIDTH = 17;
-    const int BATT_HEIGHT = 5;
-
-    float width = batteryLevelOfEnergyPct * BATT_WIDTH / 100.0f;
-    display.fillRect(BATT_X, BATT_Y, (int)width, BATT_HEIGHT, SSD1306_WHITE);
+    display.fillRect(7, 46, values.batteryBarWidth, 5, SSD1306_WHITE);
 
     // print battery power flow arrow
-    long batteryPowerWAbs = batteryPowerKw > 0 ? batteryPowerKw * 1000 : batteryPowerKw * -1000;
-    // Serial.print("battery power w: ");
-    // Serial.println(batteryPowerWAbs);
-    if (batteryPowerWAbs > 9) {
+    if (values.batteryFlow != 0) {
         display.fillRect(28, 29, 9, 6, SSD1306_BLACK);
-        if (batteryPowerKw < 0) {
+        if (values.batteryFlow < 0) {
             display.drawBitmap(29, 31, img_arr_up_7x3, 7, 3, 1);
         } else {
             display.drawBitmap(29, 31, img_arr_down_7x3, 7, 3, 1);
@@ -547,41 +1945,69 @@ void printStateScreen1(char *sunPowerStr, char *houseUsagePower, char *meterPowe
     // #########
     // # Meter #
     // #########
-
-    float meterPowerKwAbs = meterPowerKw < 0 ? meterPowerKw * -1 : meterPowerKw;
-    char meterPowerFmt[4];
-    dtostrf(meterPowerKwAbs, 4, 2, meterPowerFmt);
-    String meterPowerAbsStr(meterPowerFmt);
-
     display.setCursor(98, 45);
-    display.println(meterPowerAbsStr);
+    display.println(values.meterPower.c_str());
     display.setCursor(98, 55);
     display.println("  kW");
 
-    long meterPowerWAbs = meterPowerKwAbs * 1000;
     // print meter power flow arrow
-    if (meterPowerWAbs > 9) {
-        // Serial.print("meter active w: ");
-        // Serial.println(meterPowerWAbs);
+    if (values.meterFlow != 0) {
         display.fillRect(95, 29, 9, 6, SSD1306_BLACK);
-        if (meterPowerKw < 0) {
+        if (values.meterFlow < 0) {
             display.drawBitmap(96, 31, img_arr_up_7x3, 7, 3, 1);
         } else {
             display.drawBitmap(96, 31, img_arr_down_7x3, 7, 3, 1);
         }
-    } else {
-        Serial.print("meter inactive w: ");
-        Serial.println(meterPowerWAbs);
     }
 
-    display.display();
+    // mark values of an old snapshot in the empty top left corner
+    if (stale) {
+        display.setCursor(0, 0);
+        display.print("?");
+    }
+}
 
-    // reset font to default
-    display.setFont();
-    delay(500);
+void benchmarkScreen1() {
+    const int RUNS = 100;
+    static uint8_t reference[SCREEN_WIDTH * SCREEN_HEIGHT / 8];
+
+    // values exercising all arrows, the battery bar and the stale mark
+    SolarSnapshot snapshot = {};
+    snapshot.inverterPower = 1110000;
+    snapshot.sunPower = 1230000;
+    snapshot.houseUsage = 450000;
+    snapshot.meterPower = -780000;
+    snapshot.batteryPower = -120000;
+    snapshot.batteryStateOfEnergy = 560;
+
+    Screen1Values values;
+    formatStateScreen1(snapshot, values);
+
+    unsigned long start = micros();
+    for (int i = 0; i < RUNS; i++) {
+        composeStateScreen1Gfx(values, true);
+    }
+    unsigned long gfxMicros = micros() - start;
+    memcpy(reference, display.getBuffer(), sizeof(reference));
+
+    start = micros();
+    for (int i = 0; i < RUNS; i++) {
+        composeStateScreen1(values, true);
+    }
+    unsigned long fastMicros = micros() - start;
+
+    Serial.print("screen 1 compose us, gfx: ");
+    Serial.print(gfxMicros / RUNS);
+    Serial.print(", blitter: ");
+    Serial.print(fastMicros / RUNS);
+    Serial.print(", identical: ");
+    Serial.println(memcmp(reference, display.getBuffer(), sizeof(reference)) == 0 ? "yes" : "no");
+
+    display.clearDisplay();
 }
+#endif
 
-void printStateScreen3(char *line1, char *line2, char *line3, char *line4) {
+void printStateScreen3(const char *line1, const char *line2, const char *line3, const char *line4) {
     display.clearDisplay();
 
     display.setFont(&FreeMono9pt7b);
@@ -610,84 +2036,172 @@ void printStateScreen3(char *line1, char *line2, char *line3, char *line4) {
         display.println(line4);
     }
 
-    display.display();
+    flushDisplay();
 
     // reset font to default
     display.setFont();
-    delay(500);
 }
 
-void printUsage() {
-    int16_t i_ac_power = mbse.readHregInt(mb, remote, I_AC_POWER);
-    int16_t i_ac_power_sf = mbse.readHregInt(mb, remote, I_AC_POWER_SF);
-    int16_t i_ac_power_norm = mbse.norm(i_ac_power, i_ac_power_sf);
+void acquireSnapshot() {
+    // totals of all devices, every device passed its sanity check in this cycle
+    SolarSnapshot &snapshot = snapshots.beginWrite();
+    site.aggregate(snapshot);
 
-    int16_t m1_m_ac_power = mbse.readHregInt(mb, remote, M1_AC_POWER);
-    int16_t m1_m_ac_power_sf = mbse.readHregInt(mb, remote, M1_AC_POWER_SF);
-    int16_t m1_m_ac_power_norm = mbse.norm(m1_m_ac_power, m1_m_ac_power_sf);
+    // (A) calculate sun power: AC output plus what went into the battery
+    snapshot.sunPower = snapshot.inverterPower + snapshot.batteryPower;
 
-    float b1_b_instantaneous_power = mbse.readHregFloat32(mb, remote, B1_INSTANTANEOUS_POWER);
+    // (B) calculate power used by house: AC output minus export to the grid
+    snapshot.houseUsage = snapshot.inverterPower - snapshot.meterPower;
 
-    // (A) calculate sun power
-    int a_sun_power = mbse.calculate_sun_power(i_ac_power_norm, b1_b_instantaneous_power);
+    snapshots.commit();
+}
 
-    // (B) calculate power used by house
-    int b_house_usage = mbse.calculate_house_usage(i_ac_power_norm, m1_m_ac_power_norm);
+void printUsage(const SolarSnapshot &snapshot, boolean stale) {
+    if (lastScreen == Solar1) {
+        // the values move to the new snapshot in the following frames
+        animator.setTarget(snapshot, millis());
+        animatedStale = stale;
+        animating = true;
+        animateFrame(true);
+        return;
+    }
+    animating = false;
 
-    // (C) grid input/consumption
-    int c_meter_power = m1_m_ac_power_norm;
+    if (lastScreen == History) {
+        printHistoryScreen();
+        return;
+    }
 
-    // (D) battery charge/discharge
-    int d_battery_power = b1_b_instantaneous_power;
+    if (lastScreen == Energy) {
+        printEnergyScreen();
+        return;
+    }
 
-    // battery level in percent
-    float b1_b_state_of_energy = mbse.readHregFloat32(mb, remote, B1_STATE_OF_ENERGY_SOE);
+    ScreenLine line1("S: ");
+    line1.appendFixed(toCentiKw(snapshot.sunPower), 2, 4).append("kW");
 
-    float sunPowerPowerKw = hlpRound(a_sun_power / 1000.0f);
-    char sunPowerFmt[4];
-    dtostrf(sunPowerPowerKw, 4, 2, sunPowerFmt);
-    String sunPowerStr(sunPowerFmt);
-    String line1 = "S: " + sunPowerStr + "kW";
+    ScreenLine line2("H: ");
+    line2.appendFixed(toCentiKw(snapshot.houseUsage), 2, 4).append("kW");
 
-    float houseUsagePowerKw = hlpRound(b_house_usage / 1000.0f);
-    char houseUsagePowerFmt[4];
-    dtostrf(houseUsagePowerKw, 4, 2, houseUsagePowerFmt);
-    String houseUsagePower(houseUsagePowerFmt);
-    String line2 = "H: " + houseUsagePower + "kW";
+    ScreenLine line3("M: ");
+    line3.appendFixed(toCentiKw(snapshot.meterPower), 2, 4).append("kW");
 
-    float meterPowerKw = hlpRound(c_meter_power / 1000.0f);
-    char meterPowerFmt[4];
-    dtostrf(meterPowerKw, 4, 2, meterPowerFmt);
-    String meterPower(meterPowerFmt);
-    String line3 = "M: " + meterPower + "kW";
+    ScreenLine line4("B: ");
+    line4.appendFixed(divRound(snapshot.batteryStateOfEnergy, 10), 0, 3).append("% ");
+    line4.appendFixed(toCentiKw(snapshot.batteryPower), 2, 4).append("kW");
+    if (stale) {
+        line4.append(" (old)");
+    }
 
-    float batteryPowerKw = hlpRound(d_battery_power / 1000.0f);
-    char batteryPowerFmt[4];
-    dtostrf(batteryPowerKw, 4, 2, batteryPowerFmt);
-    String batteryPower(batteryPowerFmt);
+    printStateScreen2(line1.c_str(), line2.c_str(), line3.c_str(), line4.c_str());
+}
 
-    float batterySOE = b1_b_state_of_energy;
-    char batterySOEFmt[3];
-    dtostrf(batterySOE, 3, 0, batterySOEFmt);
-    String batteryLevelOfEnergy(batterySOEFmt);
-    String line4 = "B: " + batteryLevelOfEnergy + "% " + batteryPower + "kW";
+// Width of the sparklines of the history screen, the labels use the rest
+const uint8_t SPARKLINE_WIDTH = 90;
 
-    Serial.println(lastScreen);
+// Minutes per sparkline column, 24 hours over the full width
+const uint8_t SPARKLINE_MINUTES = (24 * 60 + SPARKLINE_WIDTH - 1) / SPARKLINE_WIDTH;
 
-    if (lastScreen == Solar1) {
-        printStateScreen1(&sunPowerStr[0], &houseUsagePower[0], &meterPower[0], &batteryPower[0], &batteryLevelOfEnergy[0], batterySOE, sunPowerPowerKw, meterPowerKw, houseUsagePowerKw, batteryPowerKw, i_ac_power_norm);
-    } else {
-        printStateScreen2(&line1[0], &line2[0], &line3[0], &line4[0]);
+/**
+ * Draws a 24 hour sparkline per channel, newest minute at the right. Every
+ * column shows min to max of its minutes, read straight from the history
+ * ring buffer. The scale of each row spans the channel's extremes and 0.
+ */
+void printHistoryScreen() {
+    static const char *const labels[HISTORY_CHANNELS] = {"S", "H", "M", "B"};
+    const uint8_t rowHeight = SCREEN_HEIGHT / HISTORY_CHANNELS;
+    const uint8_t left = SCREEN_WIDTH - SPARKLINE_WIDTH;
+
+    display.clearDisplay();
+    display.setTextSize(1);
+    display.setTextColor(SSD1306_WHITE);
+
+    uint32_t end = history.currentMinute();
+    for (uint8_t c = 0; c < HISTORY_CHANNELS; c++) {
+        HistoryChannel channel = (HistoryChannel)c;
+        uint8_t top = c * rowHeight;
+
+        // label and 24 hour average in kW, history units are 0.01 kW
+        ScreenLine label(labels[c]);
+        label.appendFixed(history.average(channel), 2, 5);
+        display.setCursor(0, top + 4);
+        display.print(label.c_str());
+
+        int16_t lo;
+        int16_t hi;
+        if (!history.extremes(channel, lo, hi)) {
+            continue;
+        }
+        lo = min(lo, (int16_t)0);
+        hi = max(hi, (int16_t)0);
+        int32_t span = max(hi - lo, 1);
+        uint8_t bottom = top + rowHeight - 2;
+        uint8_t height = rowHeight - 3;
+
+        for (uint8_t x = 0; x < SPARKLINE_WIDTH; x++) {
+            uint32_t back = (uint32_t)(SPARKLINE_WIDTH - x) * SPARKLINE_MINUTES;
+            if (back > end) {
+                continue;
+            }
+
+            int16_t columnLo;
+            int16_t columnHi;
+            if (!history.range(channel, end - back, SPARKLINE_MINUTES, columnLo, columnHi)) {
+                continue;
+            }
+            uint8_t y0 = bottom - divRound((int32_t)(columnHi - lo) * height, span);
+            uint8_t y1 = bottom - divRound((int32_t)(columnLo - lo) * height, span);
+            display.drawFastVLine(left + x, y0, y1 - y0 + 1, SSD1306_WHITE);
+        }
+
+        // zero line for grid and battery
+        if (lo < 0) {
+            uint8_t y = bottom - divRound((int32_t)-lo * height, span);
+            for (uint8_t x = 0; x < SPARKLINE_WIDTH; x += 4) {
+                display.drawPixel(left + x, y, SSD1306_WHITE);
+            }
+        }
     }
+
+    flushDisplay();
+}
+
+// Appends an energy in kWh with one decimal
+void appendKwh(ScreenLine &line, milliwatthour_t mwh) {
+    line.appendFixed(mwh / 100000 + (mwh % 100000 >= 50000 ? 1 : 0), 1, 6);
+}
+
+void printEnergyScreen() {
+    ScreenLine line1("Today kWh ");
+    uint32_t day = energy.current().day;
+    if (day != 0) {
+        // YYYYMMDD as DD.MM.
+        line1.append(day % 100 < 10 ? "0" : "").appendUInt(day % 100).append('.');
+        line1.append(day / 100 % 100 < 10 ? "0" : "").appendUInt(day / 100 % 100).append('.');
+    }
+
+    ScreenLine line2("Sun");
+    appendKwh(line2, energy.today(EnergyProduction));
+    line2.append(" Hse");
+    appendKwh(line2, energy.today(EnergyConsumption));
+
+    ScreenLine line3("Imp");
+    appendKwh(line3, energy.today(EnergyImport));
+    line3.append(" Exp");
+    appendKwh(line3, energy.today(EnergyExport));
+
+    ScreenLine line4("Chg");
+    appendKwh(line4, energy.today(EnergyCharge));
+    line4.append(" Dis");
+    appendKwh(line4, energy.today(EnergyDischarge));
+
+    printStateScreen2(line1.c_str(), line2.c_str(), line3.c_str(), line4.c_str());
 }
 
 /**
- * Rounds a value up to the second decimal fraction
- * @param f value to round
+ * Converts a power to the 0.01 kW units shown on the screens, rounding half away from zero
+ * @param mw power in mW
  */
-float hlpRound(float f) {
-    int sign = f < 0 ? -1 : 1;
-    f = f * sign;
-    f += 0.005;
-    return f * sign;
-}
\ No newline at end of file
+int32_t toCentiKw(milliwatt_t mw) {
+    return divRound(mw, MILLIWATT_PER_CENTI_KW);
+}
@@ -0,0 +1,195 @@
+#include "ModbusPipeline.h"
+
+uint32_t ModbusPipeline::lateCount = 0;
+ModbusPipeline *ModbusPipeline::active = nullptr;
+
+ModbusPipeline::ModbusPipeline(ModbusIP &mb) : mb(mb) {}
+
+bool ModbusPipeline::onTransaction(Modbus::ResultCode event, uint16_t transactionId, void *) {
+    // transaction IDs are only unique per client, match within the pipeline running the library
+    if (active == nullptr || !active->complete(transactionId, event)) {
+        // response to a request already given up, e.g. after a timeout or cancel
+        lateCount++;
+    }
+    return true;
+}
+
+void ModbusPipeline::clientTask() {
+    active = this;
+    mb.task();
+    active = nullptr;
+}
+
+void ModbusPipeline::setTarget(const IPAddress &newRemote, uint8_t newUnit) {
+    remote = newRemote;
+    unit = newUnit;
+}
+
+void ModbusPipeline::setWindow(uint8_t size) {
+    window = size == 0 ? 1 : min<uint8_t>(size, MODBUSIP_MAX_TRANSACIONS);
+}
+
+void ModbusPipeline::setRetries(uint8_t retries) {
+    maxRetries = retries;
+}
+
+bool ModbusPipeline::submit(ReadPlanner &plan, CycleCallback callback, uint8_t cycleUnit) {
+    if (!plan.valid() || cycleCount >= MAX_PIPELINE_CYCLES) {
+        return false;
+    }
+
+    uint8_t freeSlots = 0;
+    for (const Request &request : requestSlots) {
+        freeSlots += request.state == RequestFree ? 1 : 0;
+    }
+    if (freeSlots < plan.blockCount()) {
+        return false;
+    }
+
+    uint8_t index = (firstCycle + cycleCount) % MAX_PIPELINE_CYCLES;
+    cycles[index] = {&plan, callback, (uint32_t)millis(), cycleUnit, plan.blockCount(), false, Modbus::EX_SUCCESS};
+    cycleCount++;
+
+    uint8_t block = 0;
+    for (Request &request : requestSlots) {
+        if (block < plan.blockCount() && request.state == RequestFree) {
+            request = {RequestQueued, index, block, 0, 0, Modbus::EX_SUCCESS};
+            block++;
+        }
+    }
+    return true;
+}
+
+void ModbusPipeline::task() {
+    // send in submit order while the window has room
+    for (uint8_t c = 0; c < cycleCount && inFlight < window; c++) {
+        uint8_t index = (firstCycle + c) % MAX_PIPELINE_CYCLES;
+        for (Request &request : requestSlots) {
+            if (inFlight >= window) {
+                break;
+            }
+            if (request.state == RequestQueued && request.cycle == index) {
+                send(request);
+            }
+        }
+    }
+
+    finishCycles();
+}
+
+void ModbusPipeline::cancel() {
+    // drop first, the library reports dropped transactions through the callback
+    active = this;
+    mb.dropTransactions();
+    active = nullptr;
+
+    for (Request &request : requestSlots) {
+        request.state = RequestFree;
+    }
+    inFlight = 0;
+    firstCycle = 0;
+    cycleCount = 0;
+    cancelCount++;
+}
+
+bool ModbusPipeline::complete(uint16_t transactionId, Modbus::ResultCode event) {
+    for (Request &request : requestSlots) {
+        if (request.state != RequestInFlight || request.transaction != transactionId) {
+            continue;
+        }
+
+        inFlight--;
+        request.result = event;
+        if (event == Modbus::EX_TIMEOUT) {
+            timeoutCount++;
+        }
+        if (event == Modbus::EX_SUCCESS) {
+            request.state = RequestDone;
+            cycles[request.cycle].pending--;
+        } else {
+            retryOrFail(request);
+        }
+        return true;
+    }
+    return false;
+}
+
+bool ModbusPipeline::send(Request &request) {
+    const Cycle &cycle = cycles[request.cycle];
+    ReadPlanner &plan = *cycle.plan;
+
+    request.attempts++;
+    requestCount++;
+    if (request.attempts > 1) {
+        retryCount++;
+    }
+
+    request.transaction = mb.readHreg(remote, plan.blockStart(request.block), plan.blockBuffer(request.block), plan.blockSize(request.block), onTransaction, cycle.unit);
+    if (request.transaction == 0) {
+        request.result = Modbus::EX_GENERAL_FAILURE;
+        retryOrFail(request);
+        return false;
+    }
+
+    request.state = RequestInFlight;
+    inFlight++;
+    maxFlight = max(maxFlight, inFlight);
+    return true;
+}
+
+void ModbusPipeline::retryOrFail(Request &request) {
+    bool transient = request.result == Modbus::EX_TIMEOUT ||
+                     request.result == Modbus::EX_SLAVE_DEVICE_BUSY ||
+                     request.result == Modbus::EX_DEVICE_FAILED_TO_RESPOND ||
+                     request.result == Modbus::EX_GENERAL_FAILURE;
+
+    if (transient && request.attempts <= maxRetries) {
+        request.state = RequestQueued;
+        return;
+    }
+
+    Cycle &cycle = cycles[request.cycle];
+    ReadPlanner &plan = *cycle.plan;
+    Serial.print("Block read failed at ");
+    Serial.print(plan.blockStart(request.block));
+    Serial.print(": 0x");
+    Serial.println(request.result, HEX);
+
+    request.state = RequestFailed;
+    cycle.pending--;
+    if (!cycle.failed) {
+        cycle.result = request.result;
+    }
+    cycle.failed = true;
+
+    // the cycle cannot succeed anymore, do not send its remaining reads
+    for (Request &other : requestSlots) {
+        if (other.state == RequestQueued && other.cycle == request.cycle) {
+            other.state = RequestFailed;
+            cycle.pending--;
+        }
+    }
+}
+
+void ModbusPipeline::finishCycles() {
+    while (cycleCount > 0 && cycles[firstCycle].pending == 0) {
+        uint8_t index = firstCycle;
+        Cycle cycle = cycles[index];
+
+        for (Request &request : requestSlots) {
+            if (request.state != RequestFree && request.cycle == index) {
+                request.state = RequestFree;
+            }
+        }
+
+        firstCycle = (firstCycle + 1) % MAX_PIPELINE_CYCLES;
+        cycleCount--;
+        lastCycle = millis() - cycle.submittedAt;
+
+        // the callback may submit the next cycle
+        if (cycle.callback != nullptr) {
+            reportedResult = cycle.result;
+            cycle.callback(*cycle.plan, !cycle.failed);
+        }
+    }
+}
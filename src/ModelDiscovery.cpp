@@ -0,0 +1,189 @@
+#include "ModelDiscovery.h"
+
+#include "EnergyLog.h"
+
+// "SunS" in two registers
+static const uint16_t SUNSPEC_MARKER_HIGH = 0x5375;
+static const uint16_t SUNSPEC_MARKER_LOW = 0x6e53;
+
+void ModelDiscovery::start() {
+    layout = {};
+    layout.bases = DEFAULT_BLOCK_BASES;
+    models = 0;
+    battery = 0;
+
+    // the marker and the header of the first model in one read
+    step = Marker;
+    readAt(SUNSPEC_BASE_ADDRESS, 4);
+}
+
+bool ModelDiscovery::check(const DeviceLayout &cached, uint8_t batteries) {
+    layout = cached;
+    battery = 0;
+    probeMask = batteries & ~cached.batteries;
+
+    // an assumed layout or a chain without end marker has no end to check
+    if (cached.inverterModel != 0 && cached.chainEnd != 0) {
+        step = EndCheck;
+        readAt(cached.chainEnd, 2);
+        return true;
+    }
+    step = BatteryCheck;
+    if (probeNext()) {
+        return true;
+    }
+    step = Done;
+    return false;
+}
+
+bool ModelDiscovery::next() {
+    const uint16_t *values = probe.blockValues(0);
+
+    switch (step) {
+        case Marker:
+            if (values[0] != SUNSPEC_MARKER_HIGH || values[1] != SUNSPEC_MARKER_LOW) {
+                Serial.println("discovery: no SunSpec marker");
+                step = Failed;
+                return false;
+            }
+            address = SUNSPEC_BASE_ADDRESS + 2;
+            step = Header;
+            values += 2;
+            break;
+
+        case Header:
+            break;
+
+        case Battery:
+        case BatteryCheck:
+            // the manufacturer name of a battery which is not installed is empty
+            return probed(values[0] != 0 || values[1] != 0);
+
+        case EndCheck:
+            // e.g. a meter installed later is appended to the chain
+            if (values[0] != SUNSPEC_END_MODEL) {
+                return contradict("model appended to the chain");
+            }
+            step = BatteryCheck;
+            if (probeNext()) {
+                return true;
+            }
+            step = Done;
+            return false;
+
+        default:
+            return false;
+    }
+
+    uint16_t id = values[0];
+    uint16_t length = values[1];
+    if (id == SUNSPEC_END_MODEL) {
+        layout.chainEnd = address;
+        return endChain();
+    }
+    if (length == 0) {
+        return endChain();
+    }
+    record(address, id, length);
+
+    // a chain running past the end of the address space is corrupt
+    uint32_t following = (uint32_t)address + 2 + length;
+    if (++models >= MAX_CHAIN_MODELS || following + 2 > 0x10000) {
+        return endChain();
+    }
+    address = following;
+    readAt(address, 2);
+    return true;
+}
+
+bool ModelDiscovery::rejected() {
+    if (step == Battery || step == BatteryCheck) {
+        return probed(false);
+    }
+    if (step == EndCheck) {
+        return contradict("end of the chain rejected");
+    }
+
+    // a chain with a hole cannot be walked on
+    Serial.println("discovery: model chain rejected");
+    step = Failed;
+    return false;
+}
+
+void ModelDiscovery::record(uint16_t at, uint16_t id, uint16_t length) {
+    Serial.printf("discovery: model %u at %u, length %u\n", id, at, length);
+
+    // only the integer models with scale factors match the register map, not the float models 11x and 21x
+    if (id >= 101 && id <= 103 && layout.inverterModel == 0) {
+        layout.inverterModel = id;
+        layout.bases.base[InverterBlock] = at;
+        return;
+    }
+    if (id >= 201 && id <= 204) {
+        for (uint8_t i = 0; i < MAX_METERS; i++) {
+            if ((layout.meters & (1 << i)) == 0) {
+                layout.meterModel[i] = id;
+                layout.meters |= 1 << i;
+                layout.bases.base[SUNSPEC_REGISTERS[METER_MODEL_ID[i]].block] = at;
+                return;
+            }
+        }
+    }
+}
+
+bool ModelDiscovery::endChain() {
+    if (layout.inverterModel == 0) {
+        Serial.println("discovery: no inverter model in the chain");
+        step = Failed;
+        return false;
+    }
+    step = Battery;
+    battery = 0;
+    probeMask = (1 << MAX_BATTERIES) - 1;
+    probeNext();
+    return true;
+}
+
+bool ModelDiscovery::probeNext() {
+    while (battery < MAX_BATTERIES && (probeMask & (1 << battery)) == 0) {
+        battery++;
+    }
+    if (battery == MAX_BATTERIES) {
+        return false;
+    }
+    readAt(layout.bases.base[SUNSPEC_REGISTERS[BATTERY_RATED_ENERGY[battery]].block], 2);
+    return true;
+}
+
+bool ModelDiscovery::probed(bool present) {
+    if (present && step == BatteryCheck) {
+        return contradict("battery installed");
+    }
+    if (present) {
+        layout.batteries |= 1 << battery;
+    }
+    battery++;
+    if (probeNext()) {
+        return true;
+    }
+    if (step == BatteryCheck) {
+        step = Done;
+        return false;
+    }
+
+    seal(layout);
+    Serial.printf("discovery: layout %08lx, inverter %u at %u, meters %02x, batteries %02x\n", (unsigned long)layout.fingerprint,
+                  layout.inverterModel, layout.bases.base[InverterBlock], layout.meters, layout.batteries);
+    step = Done;
+    return false;
+}
+
+bool ModelDiscovery::contradict(const char *reason) {
+    Serial.printf("discovery: layout %08lx outdated, %s\n", (unsigned long)layout.fingerprint, reason);
+    step = Contradicted;
+    return false;
+}
+
+void ModelDiscovery::seal(DeviceLayout &target) {
+    target.fingerprint = EnergyLog::crc32((const uint8_t *)&target, offsetof(DeviceLayout, fingerprint));
+}
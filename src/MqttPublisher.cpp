@@ -0,0 +1,140 @@
+#include "MqttPublisher.h"
+
+MqttPublisher::MqttPublisher() : mqtt(net) {
+}
+
+void MqttPublisher::begin(const char *brokerHost, uint16_t brokerPort, const char *brokerUser, const char *brokerPassword, const char *prefix, const char *id) {
+    strncpy(host, brokerHost, sizeof(host) - 1);
+    host[sizeof(host) - 1] = '\0';
+    port = brokerPort;
+    user = brokerUser[0] != '\0' ? brokerUser : nullptr;
+    password = brokerPassword[0] != '\0' ? brokerPassword : nullptr;
+    clientId = id;
+
+    stateTopic.clear().append(prefix).append("/state");
+    statusTopic.clear().append(prefix).append("/status");
+
+    // a dead broker must not stall the loop for the default 5 s, PubSubClient waits for CONNACK in whole seconds
+    net.setTimeout(MQTT_CONNECT_TIMEOUT_MILLIS);
+    mqtt.setSocketTimeout((MQTT_CONNECT_TIMEOUT_MILLIS + 999) / 1000);
+    resolved = false;
+    reconnectAt = millis();
+}
+
+void MqttPublisher::publish(const SolarSnapshot &snapshot) {
+    if (!enabled()) {
+        return;
+    }
+
+    bool full = !hasSent || millis() - fullStateAt >= MQTT_FULL_STATE_MILLIS;
+    int32_t deadband = divRound(powerDeadband, 1000);
+
+    scratch.clear().append("{\"q\":").appendUInt(snapshot.sequence);
+    bool changed = appendChanged("sun", divRound(snapshot.sunPower, 1000), sentSun, deadband, 0, full);
+    changed |= appendChanged("house", divRound(snapshot.houseUsage, 1000), sentHouse, deadband, 0, full);
+    changed |= appendChanged("grid", divRound(snapshot.meterPower, 1000), sentGrid, deadband, 0, full);
+    changed |= appendChanged("battery", divRound(snapshot.batteryPower, 1000), sentBattery, deadband, 0, full);
+    changed |= appendChanged("soe", snapshot.batteryStateOfEnergy, sentSoe, 0, 1, full);
+    scratch.append('}');
+
+    if (!changed) {
+        return;
+    }
+
+    // the oldest message makes room for the newest one
+    if (queueCount == MQTT_QUEUE_LENGTH) {
+        queueFirst = (queueFirst + 1) % MQTT_QUEUE_LENGTH;
+        queueCount--;
+        droppedCount++;
+    }
+    Message &message = queue[(queueFirst + queueCount) % MQTT_QUEUE_LENGTH];
+    message.payload = scratch;
+    message.enqueuedAt = millis();
+    queueCount++;
+    hasSent = true;
+    if (full) {
+        fullStateAt = millis();
+    }
+}
+
+bool MqttPublisher::appendChanged(const char *name, int32_t value, int32_t &last, int32_t deadband, uint8_t decimals, bool full) {
+    int32_t diff = value - last;
+    if (!full && diff <= deadband && -diff <= deadband) {
+        return false;
+    }
+
+    scratch.append(",\"").append(name).append("\":").appendFixed(value, decimals);
+    last = value;
+    return true;
+}
+
+void MqttPublisher::task() {
+    if (!enabled()) {
+        return;
+    }
+
+    if (!mqtt.connected() && !reconnect()) {
+        return;
+    }
+    mqtt.loop();
+
+    for (uint8_t i = 0; i < MQTT_PUBLISH_PER_TASK && queueCount > 0; i++) {
+        Message &message = queue[queueFirst];
+        if (!mqtt.publish(stateTopic.c_str(), message.payload.c_str(), false)) {
+            // the connection broke, the message stays for the next connection
+            if (!mqtt.connected()) {
+                return;
+            }
+            droppedCount++;
+        } else {
+            publishedCount++;
+            lastLatency = millis() - message.enqueuedAt;
+            maxLatency = max(maxLatency, lastLatency);
+        }
+        queueFirst = (queueFirst + 1) % MQTT_QUEUE_LENGTH;
+        queueCount--;
+    }
+}
+
+bool MqttPublisher::reconnect() {
+    if ((long)(millis() - reconnectAt) < 0) {
+        return false;
+    }
+
+    // blocking lookup, connect and CONNACK, each bounded by MQTT_CONNECT_TIMEOUT_MILLIS
+    if (!resolve()) {
+        Serial.print("MQTT broker not found: ");
+        Serial.println(host);
+    } else if (!mqtt.connect(clientId, user, password, statusTopic.c_str(), 0, true, "offline")) {
+        Serial.print("MQTT connect failed, state ");
+        Serial.println(mqtt.state());
+    }
+    if (!mqtt.connected()) {
+        // the broker may have moved to another address
+        resolved = false;
+        reconnectAt = millis() + reconnectDelay;
+        reconnectDelay = min(reconnectDelay * 2, MQTT_MAX_RECONNECT_MILLIS);
+        return false;
+    }
+
+    Serial.println("MQTT connected");
+    mqtt.publish(statusTopic.c_str(), "online", true);
+    reconnectDelay = MQTT_MIN_RECONNECT_MILLIS;
+
+    // the broker may have lost the values, send all of them with the next cycle
+    hasSent = false;
+    return true;
+}
+
+bool MqttPublisher::resolve() {
+    if (resolved) {
+        return true;
+    }
+
+    // PubSubClient would look the name up with the default 10 s timeout on every connect
+    resolved = WiFi.hostByName(host, brokerIp, MQTT_CONNECT_TIMEOUT_MILLIS) == 1;
+    if (resolved) {
+        mqtt.setServer(brokerIp, port);
+    }
+    return resolved;
+}
@@ -0,0 +1,114 @@
+#include "PageBlitter.h"
+
+static const int16_t WIDTH = 128;
+static const int16_t HEIGHT = 64;
+static const int16_t PAGES = HEIGHT / 8;
+
+void PageBlitter::begin() {
+    uint8_t *buf = display.getBuffer();
+
+    // glyph drawn at logical 0, 0 ends up in the last page at the right edge
+    for (uint8_t g = 0; g < GLYPH_COUNT; g++) {
+        display.clearDisplay();
+        display.drawChar(0, 0, GLYPH_CHARS[g], SSD1306_WHITE, SSD1306_WHITE, 1);
+        for (uint8_t i = 0; i < GLYPH_WIDTH; i++) {
+            atlas[g][i] = buf[(PAGES - 1) * WIDTH + WIDTH - 1 - i];
+        }
+    }
+
+    display.clearDisplay();
+}
+
+void PageBlitter::loadTemplate(const uint8_t *pages) {
+    memcpy_P(display.getBuffer(), pages, WIDTH * PAGES);
+}
+
+void PageBlitter::drawText(int16_t x, int16_t y, const char *text) {
+    for (; *text != '\0'; text++, x += GLYPH_WIDTH) {
+        const char *g = strchr(GLYPH_CHARS, *text);
+        if (g != nullptr && *text != ' ') {
+            blit(x, y, 8, atlas[g - GLYPH_CHARS], GLYPH_WIDTH);
+        }
+    }
+}
+
+void PageBlitter::drawSprite(int16_t x, int16_t y, const Sprite &sprite) {
+    blit(x, y, sprite.height, sprite.cols, sprite.width);
+}
+
+void PageBlitter::blit(int16_t x, int16_t y, uint8_t h, const uint8_t *cols, uint8_t w) {
+    uint8_t *buf = display.getBuffer();
+
+    // rotation 2: bottom row of the image is the top physical row
+    int16_t top = HEIGHT - y - h;
+    int16_t page = top >> 3;
+    uint8_t shift = top & 7;
+
+    for (uint8_t i = 0; i < w; i++) {
+        int16_t col = WIDTH - 1 - (x + i);
+        if (col < 0 || col >= WIDTH || cols[i] == 0) {
+            continue;
+        }
+
+        uint16_t bits = (uint16_t)cols[i] << shift;
+        if (page >= 0 && page < PAGES) {
+            buf[page * WIDTH + col] |= bits & 0xff;
+        }
+        if (page + 1 >= 0 && page + 1 < PAGES) {
+            buf[(page + 1) * WIDTH + col] |= bits >> 8;
+        }
+    }
+}
+
+void PageBlitter::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    applyRect(x, y, w, h, color, nullptr);
+}
+
+void PageBlitter::restoreRect(const uint8_t *pages, int16_t x, int16_t y, int16_t w, int16_t h) {
+    applyRect(x, y, w, h, SSD1306_BLACK, pages);
+}
+
+void PageBlitter::applyRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color, const uint8_t *pages) {
+    uint8_t *buf = display.getBuffer();
+
+    // physical rows and columns covered by the rectangle
+    int16_t rowFrom = max<int16_t>(HEIGHT - y - h, 0);
+    int16_t rowTo = min<int16_t>(HEIGHT - 1 - y, HEIGHT - 1);
+    int16_t colFrom = max<int16_t>(WIDTH - x - w, 0);
+    int16_t colTo = min<int16_t>(WIDTH - 1 - x, WIDTH - 1);
+    if (rowFrom > rowTo || colFrom > colTo) {
+        return;
+    }
+
+    for (int16_t page = rowFrom >> 3; page <= rowTo >> 3; page++) {
+        uint8_t from = page == rowFrom >> 3 ? rowFrom & 7 : 0;
+        uint8_t to = page == rowTo >> 3 ? rowTo & 7 : 7;
+        uint8_t mask = (0xff << from) & (0xff >> (7 - to));
+
+        uint8_t *p = &buf[page * WIDTH];
+        for (int16_t col = colFrom; col <= colTo; col++) {
+            if (pages != nullptr) {
+                p[col] = (p[col] & ~mask) | (pgm_read_byte(&pages[page * WIDTH + col]) & mask);
+            } else if (color == SSD1306_BLACK) {
+                p[col] &= ~mask;
+            } else {
+                p[col] |= mask;
+            }
+        }
+    }
+}
+
+Sprite PageBlitter::spriteFromBitmap(const uint8_t *bitmap, uint8_t w, uint8_t h) {
+    Sprite sprite = {w, h, {0}};
+    uint8_t byteWidth = (w + 7) / 8;
+
+    for (uint8_t row = 0; row < h; row++) {
+        for (uint8_t i = 0; i < w; i++) {
+            if (pgm_read_byte(&bitmap[row * byteWidth + i / 8]) & (0x80 >> (i & 7))) {
+                // bottom row becomes bit 0
+                sprite.cols[i] |= 1 << (h - 1 - row);
+            }
+        }
+    }
+    return sprite;
+}
@@ -0,0 +1,125 @@
+#include "PhaseProfiler.h"
+
+#ifdef MONITOR_PROFILING
+
+void PhaseHistogram::add(uint32_t micros) {
+    uint8_t bucket = bucketOf(micros);
+    if (buckets[bucket] == UINT16_MAX) {
+        for (uint8_t i = 0; i < PROFILE_BUCKETS; i++) {
+            buckets[i] /= 2;
+        }
+    }
+    buckets[bucket]++;
+
+    total++;
+    sum += micros;
+    if (micros > longest) {
+        longest = micros;
+    }
+}
+
+uint32_t PhaseHistogram::percentile(uint8_t p) const {
+    uint32_t n = 0;
+    for (uint8_t i = 0; i < PROFILE_BUCKETS; i++) {
+        n += buckets[i];
+    }
+    if (n == 0) {
+        return 0;
+    }
+
+    uint32_t target = (n * p + 99) / 100;
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < PROFILE_BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen >= target && seen > 0) {
+            uint32_t bound = upperBound(i);
+            return bound < longest ? bound : longest;
+        }
+    }
+    return longest;
+}
+
+void PhaseHistogram::reset() {
+    memset(buckets, 0, sizeof(buckets));
+    total = 0;
+    longest = 0;
+    sum = 0;
+}
+
+uint8_t PhaseHistogram::bucketOf(uint32_t micros) {
+    // below 4 us every value has its own bucket, above the two bits after the leading one select the sub bucket
+    if (micros < PROFILE_SUB_BUCKETS) {
+        return micros;
+    }
+    uint8_t octave = 31 - __builtin_clz(micros);
+    uint32_t bucket = PROFILE_SUB_BUCKETS * (octave - 1) + ((micros >> (octave - 2)) & (PROFILE_SUB_BUCKETS - 1));
+    return bucket < PROFILE_BUCKETS ? bucket : PROFILE_BUCKETS - 1;
+}
+
+uint32_t PhaseHistogram::upperBound(uint8_t bucket) {
+    if (bucket < PROFILE_SUB_BUCKETS) {
+        return bucket;
+    }
+    if (bucket == PROFILE_BUCKETS - 1) {
+        return UINT32_MAX;
+    }
+    uint8_t shift = bucket / PROFILE_SUB_BUCKETS - 1;
+    uint32_t lower = (uint32_t)(PROFILE_SUB_BUCKETS + bucket % PROFILE_SUB_BUCKETS) << shift;
+    return lower + (1UL << shift) - 1;
+}
+
+void PhaseProfiler::end(Phase phase) {
+    if (started[phase] == 0) {
+        return;
+    }
+    record(phase, micros() - started[phase]);
+    started[phase] = 0;
+}
+
+const char *PhaseProfiler::name(Phase phase) {
+    static const char *const names[PHASE_COUNT] = {"loop", "poll", "snapshot", "format", "compose", "flush", "web"};
+    return phase < PHASE_COUNT ? names[phase] : "?";
+}
+
+const FixedText<PROFILE_TEXT_CAPACITY> &PhaseProfiler::report() {
+    char line[96];
+    text.clear();
+    text.append("phase          count     mean      p50      p95      max (us)\n");
+    for (uint8_t i = 0; i < PHASE_COUNT; i++) {
+        const PhaseHistogram &h = histograms[i];
+        snprintf(line, sizeof(line), "%-10s %9lu %8lu %8lu %8lu %8lu\n", name((Phase)i), (unsigned long)h.count(),
+                 (unsigned long)h.meanMicros(), (unsigned long)h.percentile(50), (unsigned long)h.percentile(95), (unsigned long)h.maxMicros());
+        text.append(line);
+    }
+    return text;
+}
+
+void PhaseProfiler::reset() {
+    for (uint8_t i = 0; i < PHASE_COUNT; i++) {
+        histograms[i].reset();
+    }
+}
+
+void PhaseProfiler::handleSerial(Stream &serial) {
+    while (serial.available() > 0) {
+        char c = serial.read();
+        if (c != '\n' && c != '\r') {
+            // overlong lines are cut, they match no command
+            if (commandLength < sizeof(command) - 1) {
+                command[commandLength++] = c;
+            }
+            continue;
+        }
+
+        command[commandLength] = '\0';
+        if (strcmp(command, "prof") == 0) {
+            serial.print(report().c_str());
+        } else if (strcmp(command, "prof reset") == 0) {
+            reset();
+            serial.println("profile reset");
+        }
+        commandLength = 0;
+    }
+}
+
+#endif
@@ -0,0 +1,154 @@
+#include "PowerHistory.h"
+
+// Quantized value of a gap in a closed block
+static const uint8_t QUANTIZED_GAP = 255;
+
+// Highest quantized value, min maps to 0 and max to this
+static const uint8_t QUANTIZED_MAX = 254;
+
+void PowerHistory::add(const SolarSnapshot &snapshot) {
+    minuteSum[HistorySun] += divRound(snapshot.sunPower, HISTORY_MILLIWATT_PER_UNIT);
+    minuteSum[HistoryHouse] += divRound(snapshot.houseUsage, HISTORY_MILLIWATT_PER_UNIT);
+    minuteSum[HistoryGrid] += divRound(snapshot.meterPower, HISTORY_MILLIWATT_PER_UNIT);
+    minuteSum[HistoryBattery] += divRound(snapshot.batteryPower, HISTORY_MILLIWATT_PER_UNIT);
+    minuteCount++;
+}
+
+void PowerHistory::tick() {
+    while (millis() - minuteStart >= HISTORY_MINUTE_MILLIS) {
+        closeMinute();
+        minuteStart += HISTORY_MINUTE_MILLIS;
+    }
+}
+
+uint32_t PowerHistory::oldestMinute() const {
+    uint32_t block = minute / HISTORY_BLOCK_MINUTES;
+    return block > closedCount ? (block - closedCount) * HISTORY_BLOCK_MINUTES : 0;
+}
+
+int16_t PowerHistory::value(HistoryChannel c, uint32_t m) const {
+    if (m >= minute || m < oldestMinute()) {
+        return HISTORY_GAP;
+    }
+
+    uint32_t block = m / HISTORY_BLOCK_MINUTES;
+    uint8_t slot = m % HISTORY_BLOCK_MINUTES;
+    if (block == minute / HISTORY_BLOCK_MINUTES) {
+        return open[c][slot];
+    }
+
+    const ClosedBlock &b = closed[block % HISTORY_CLOSED_BLOCKS];
+    uint8_t q = b.samples[c][slot];
+    if (q == QUANTIZED_GAP) {
+        return HISTORY_GAP;
+    }
+    const Summary &s = b.summary[c];
+    return s.min + divRound((int64_t)q * (s.max - s.min), QUANTIZED_MAX);
+}
+
+bool PowerHistory::range(HistoryChannel c, uint32_t first, uint16_t count, int16_t &lo, int16_t &hi) const {
+    bool found = false;
+    for (uint32_t m = first; m < first + count; m++) {
+        int16_t v = value(c, m);
+        if (v == HISTORY_GAP) {
+            continue;
+        }
+        lo = found ? min(lo, v) : v;
+        hi = found ? max(hi, v) : v;
+        found = true;
+    }
+    return found;
+}
+
+bool PowerHistory::extremes(HistoryChannel c, int16_t &lo, int16_t &hi) const {
+    bool found = openSummary[c].count > 0;
+    if (found) {
+        lo = openSummary[c].min;
+        hi = openSummary[c].max;
+    }
+
+    for (uint8_t i = 0; i < closedCount; i++) {
+        const Summary &s = closed[i].summary[c];
+        if (s.count == 0) {
+            continue;
+        }
+        lo = found ? min(lo, s.min) : s.min;
+        hi = found ? max(hi, s.max) : s.max;
+        found = true;
+    }
+    return found;
+}
+
+int16_t PowerHistory::average(HistoryChannel c) const {
+    int32_t sum = openSummary[c].sum;
+    int32_t count = openSummary[c].count;
+    for (uint8_t i = 0; i < closedCount; i++) {
+        sum += closed[i].summary[c].sum;
+        count += closed[i].summary[c].count;
+    }
+    return count > 0 ? divRound(sum, count) : 0;
+}
+
+void PowerHistory::closeMinute() {
+    if (!openInitialized) {
+        for (uint8_t c = 0; c < HISTORY_CHANNELS; c++) {
+            for (uint8_t i = 0; i < HISTORY_BLOCK_MINUTES; i++) {
+                open[c][i] = HISTORY_GAP;
+            }
+        }
+        openInitialized = true;
+    }
+
+    uint8_t slot = minute % HISTORY_BLOCK_MINUTES;
+    for (uint8_t c = 0; c < HISTORY_CHANNELS; c++) {
+        if (minuteCount == 0) {
+            open[c][slot] = HISTORY_GAP;
+            continue;
+        }
+        int16_t v = constrain(divRound(minuteSum[c], minuteCount), INT16_MIN + 1, INT16_MAX);
+        open[c][slot] = v;
+        addToSummary(openSummary[c], v);
+        minuteSum[c] = 0;
+    }
+    minuteCount = 0;
+    minute++;
+
+    if (minute % HISTORY_BLOCK_MINUTES == 0) {
+        closeBlock();
+    }
+}
+
+void PowerHistory::closeBlock() {
+    uint32_t number = minute / HISTORY_BLOCK_MINUTES - 1;
+    ClosedBlock &b = closed[number % HISTORY_CLOSED_BLOCKS];
+
+    for (uint8_t c = 0; c < HISTORY_CHANNELS; c++) {
+        const Summary &s = openSummary[c];
+        b.summary[c] = s;
+        int32_t span = s.max - s.min;
+
+        for (uint8_t i = 0; i < HISTORY_BLOCK_MINUTES; i++) {
+            int16_t v = open[c][i];
+            if (v == HISTORY_GAP) {
+                b.samples[c][i] = QUANTIZED_GAP;
+            } else {
+                b.samples[c][i] = span == 0 ? 0 : divRound((int64_t)(v - s.min) * QUANTIZED_MAX, span);
+            }
+        }
+    }
+
+    if (closedCount < HISTORY_CLOSED_BLOCKS) {
+        closedCount++;
+    }
+    for (uint8_t c = 0; c < HISTORY_CHANNELS; c++) {
+        openSummary[c] = {};
+    }
+    openInitialized = false;
+}
+
+void PowerHistory::addToSummary(Summary &summary, int16_t v) {
+    summary.min = summary.count == 0 ? v : min(summary.min, v);
+    summary.max = summary.count == 0 ? v : max(summary.max, v);
+    summary.sum += v;
+    summary.count++;
+}
@@ -0,0 +1,78 @@
+#include "PowerManager.h"
+
+#include <ESP8266WiFi.h>
+
+volatile bool PowerManager::pressed = false;
+
+void IRAM_ATTR PowerManager::onButton() {
+    pressed = true;
+}
+
+void PowerManager::begin(uint8_t pin) {
+    attachInterrupt(digitalPinToInterrupt(pin), onButton, RISING);
+    resetStats();
+}
+
+void PowerManager::setLowPower(bool enabled) {
+    if (enabled == active) {
+        return;
+    }
+    active = enabled;
+
+    if (enabled) {
+        // presses while awake were handled by OneButton
+        pressed = false;
+        WiFi.setSleepMode(WIFI_LIGHT_SLEEP, LIGHT_SLEEP_LISTEN_INTERVAL);
+    } else {
+        // the default of the station mode
+        WiFi.setSleepMode(WIFI_MODEM_SLEEP);
+    }
+    Serial.println(enabled ? "low power on" : "low power off");
+}
+
+void PowerManager::sleep(uint32_t maxMillis) {
+    if (!active) {
+        return;
+    }
+    if (maxMillis > LOW_POWER_MAX_SLEEP_MILLIS) {
+        maxMillis = LOW_POWER_MAX_SLEEP_MILLIS;
+    }
+
+    uint32_t start = millis();
+    uint32_t slept = 0;
+    while (!pressed && slept < maxMillis) {
+        delay(min(LOW_POWER_SLICE_MILLIS, maxMillis - slept));
+        slept = millis() - start;
+    }
+    wakeCount++;
+    if (slept >= LIGHT_SLEEP_MIN_MILLIS) {
+        sleptMillis += slept;
+    }
+}
+
+bool PowerManager::takeWake() {
+    if (!pressed) {
+        return false;
+    }
+    pressed = false;
+    return true;
+}
+
+uint16_t PowerManager::dutyCyclePermille() const {
+    uint32_t elapsed = millis() - windowStart;
+    if (elapsed == 0 || sleptMillis >= elapsed) {
+        return elapsed == 0 ? 1000 : 0;
+    }
+    return (uint64_t)(elapsed - sleptMillis) * 1000 / elapsed;
+}
+
+uint16_t PowerManager::averageCurrentMilliamps() const {
+    uint16_t duty = dutyCyclePermille();
+    return ((uint32_t)duty * AWAKE_CURRENT_MILLIAMPS + (uint32_t)(1000 - duty) * LIGHT_SLEEP_CURRENT_MILLIAMPS + 500) / 1000;
+}
+
+void PowerManager::resetStats() {
+    windowStart = millis();
+    sleptMillis = 0;
+    wakeCount = 0;
+}
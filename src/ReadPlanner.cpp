@@ -0,0 +1,38 @@
+#include "ReadPlanner.h"
+
+void ReadPlanner::setLayout(const PlanLayout &newLayout) {
+    layout = newLayout;
+}
+
+uint16_t ReadPlanner::uint16(Field f) const {
+    return layout.slot[f] >= 0 ? buffer[layout.slot[f]] : 0;
+}
+
+uint32_t ReadPlanner::uint32(Field f) const {
+    if (layout.slot[f] < 0 || SUNSPEC_REGISTERS[f].width < 2) {
+        return 0;
+    }
+
+    const uint16_t *v = &buffer[layout.slot[f]];
+    if (SUNSPEC_REGISTERS[f].type == RegType::Acc32) {
+        return ((uint32_t)v[0] << 16) | v[1];
+    }
+    return ((uint32_t)v[1] << 16) | v[0];
+}
+
+int32_t ReadPlanner::fixed(Field f, int32_t scale, int16_t sf) const {
+    switch (SUNSPEC_REGISTERS[f].type) {
+        case RegType::Int16:
+            return scaledToFixed(int16(f), sf, scale);
+        case RegType::Uint16:
+            return scaledToFixed(uint16(f), sf, scale);
+        case RegType::Acc32:
+        case RegType::Uint32Le:
+            return scaledToFixed(uint32(f), sf, scale);
+        case RegType::Float32Le:
+            return ieee754ToFixed(uint32(f), scale);
+        case RegType::ScaleFactor:
+            break;
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include "RegisterCache.h"
+
+bool RegisterCache::load(const ReadPlanner &plan) {
+    missCount++;
+
+    inverterModel = plan.uint16(F_I_MODEL_ID);
+    Serial.printf("metadata: inverter model %u", inverterModel);
+
+    // model IDs identify inverter (10x) and meter (20x) blocks
+    valid = inverterModel >= 101 && inverterModel <= 103;
+
+    for (uint8_t i = 0; i < MAX_METERS; i++) {
+        if (!plan.contains(METER_MODEL_ID[i])) {
+            meterModel[i] = 0;
+            continue;
+        }
+        meterModel[i] = plan.uint16(METER_MODEL_ID[i]);
+        Serial.printf(", meter %u model %u", i + 1, meterModel[i]);
+        valid = valid && meterModel[i] >= 201 && meterModel[i] <= 204;
+    }
+
+    for (uint8_t i = 0; i < MAX_BATTERIES; i++) {
+        if (!plan.contains(BATTERY_RATED_ENERGY[i])) {
+            ratedEnergyWh[i] = 0;
+            maxCharge[i] = 0;
+            maxDischarge[i] = 0;
+            continue;
+        }
+        ratedEnergyWh[i] = plan.fixed(BATTERY_RATED_ENERGY[i], 1);
+        maxCharge[i] = plan.fixed(BATTERY_MAX_CHARGE_POWER[i], 1000);
+        maxDischarge[i] = plan.fixed(BATTERY_MAX_DISCHARGE_POWER[i], 1000);
+        Serial.printf(", battery %u %ld Wh, charge %ld mW, discharge %ld mW", i + 1, (long)ratedEnergyWh[i], (long)maxCharge[i], (long)maxDischarge[i]);
+    }
+    Serial.println();
+
+    return valid;
+}
+
+void RegisterCache::invalidate() {
+    valid = false;
+}
+
+bool RegisterCache::plausiblePower(milliwatt_t power) const {
+    return abs(power) <= MAX_PLAUSIBLE_MILLIWATT;
+}
+
+bool RegisterCache::plausibleBattery(uint8_t battery, milliwatt_t power) const {
+    // allow some headroom above the nameplate, 0 = not reported by the battery
+    if (maxCharge[battery] > 0 && power > maxCharge[battery] + maxCharge[battery] / 2) {
+        return false;
+    }
+    if (maxDischarge[battery] > 0 && -power > maxDischarge[battery] + maxDischarge[battery] / 2) {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,273 @@
+#include "RegisterMirror.h"
+
+RegisterMirror *RegisterMirror::instance = nullptr;
+
+// Does a read of count registers from first touch the registers from start?
+static bool overlaps(uint16_t first, uint16_t count, uint16_t start, uint16_t length) {
+    return first < (uint32_t)start + length && (uint32_t)first + count > start;
+}
+
+RegisterMirror::RegisterMirror(ModbusIP &server, ModbusPipeline &upstream) : server(server), upstream(upstream) {
+    instance = this;
+}
+
+void RegisterMirror::begin(uint16_t port, uint32_t maxAgeMillis, const BlockBases &bases) {
+    maxAge = maxAgeMillis;
+    setRanges(bases);
+    server.onRequest(onRequest);
+    server.onRaw(onRaw);
+    server.server(port);
+    running = true;
+}
+
+void RegisterMirror::rebase(const BlockBases &bases) {
+    if (!running) {
+        return;
+    }
+    pendingBases = bases;
+    rebasing = true;
+}
+
+void RegisterMirror::setRanges(const BlockBases &bases) {
+    // whole models, the battery block exceeds one read and is split behind its identity strings
+    const Range updated[MIRROR_RANGE_COUNT] = {
+        {bases.base[InverterBlock], 52, 0, 0, false, false},
+        {bases.base[Meter1Block], 107, 0, 0, false, false},
+        {bases.base[Battery1Block], 0x42, 0, 0, false, false},
+        {(uint16_t)(bases.base[Battery1Block] + 0x42), 0x46, 0, 0, false, false}};
+
+    bool unchanged = true;
+    for (uint8_t i = 0; i < MIRROR_RANGE_COUNT; i++) {
+        unchanged = unchanged && running && ranges[i].start == updated[i].start;
+    }
+    if (unchanged) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < MIRROR_RANGE_COUNT; i++) {
+        if (running) {
+            server.removeHreg(ranges[i].start, ranges[i].count);
+        }
+        ranges[i] = updated[i];
+    }
+    for (const Range &range : ranges) {
+        server.addHreg(range.start, 0, range.count);
+    }
+}
+
+void RegisterMirror::task(bool upstreamReady) {
+    if (!running) {
+        return;
+    }
+
+    upstreamUp = upstreamReady;
+    server.task();
+
+    // held reads fail once upstream is gone or they waited too long
+    answerHeld(-1);
+
+    if (!upstreamReady) {
+        // the pipeline is cancelled on disconnect and does not report the pending read
+        fetching = -1;
+        return;
+    }
+    if (fetching >= 0 && upstream.cancels() != fetchCancels) {
+        // the site cancelled the pipeline, e.g. after a failed resubmit, the read is not reported
+        fetching = -1;
+    }
+    if (fetching >= 0) {
+        return;
+    }
+    if (rebasing) {
+        // the fetch plan is free, no stored() can refer to the old ranges
+        setRanges(pendingBases);
+        rebasing = false;
+    }
+
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < MIRROR_RANGE_COUNT; i++) {
+        Range &range = ranges[i];
+
+        // refresh ahead of expiry while clients keep reading the range
+        bool inDemand = range.requestedAt != 0 && now - range.requestedAt < MIRROR_DEMAND_WINDOW_MILLIS;
+        bool expiring = !range.fetched || now - range.fetchedAt >= maxAge * 3 / 4;
+        if (!range.wanted && !(inDemand && expiring)) {
+            continue;
+        }
+
+        fetchPlan.setLayout(rangeLayout(range.start, range.count));
+        if (upstream.submit(fetchPlan, onFetched)) {
+            fetching = i;
+            fetchCancels = upstream.cancels();
+            fetchCount++;
+        }
+        return;
+    }
+}
+
+Modbus::ResultCode RegisterMirror::onRequest(Modbus::FunctionCode fc, const Modbus::RequestData data) {
+    return instance->check(fc, data);
+}
+
+Modbus::ResultCode RegisterMirror::onRaw(uint8_t *data, uint8_t length, void *custom) {
+    return instance->hold(data, length, *(const Modbus::frame_arg_t *)custom);
+}
+
+void RegisterMirror::onFetched(ReadPlanner &, bool success) {
+    instance->stored(success);
+}
+
+bool RegisterMirror::fresh(const Range &range, uint32_t now) const {
+    return range.fetched && now - range.fetchedAt < maxAge;
+}
+
+bool RegisterMirror::covers(uint16_t first, uint16_t count) const {
+    uint32_t end = (uint32_t)first + count;  // exclusive
+    uint32_t covered = 0;
+
+    // the ranges do not overlap, a read may span adjacent ones like the two battery ranges
+    for (const Range &range : ranges) {
+        uint32_t rangeEnd = (uint32_t)range.start + range.count;
+        if (first < rangeEnd && end > range.start) {
+            covered += min(end, rangeEnd) - max((uint32_t)first, (uint32_t)range.start);
+        }
+    }
+    return covered == count;
+}
+
+bool RegisterMirror::freshRead(uint16_t first, uint16_t count, uint32_t now) const {
+    for (const Range &range : ranges) {
+        if (overlaps(first, count, range.start, range.count) && !fresh(range, now)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RegisterMirror::request(uint16_t first, uint16_t count, uint32_t now) {
+    bool stale = false;
+    for (Range &range : ranges) {
+        if (!overlaps(first, count, range.start, range.count)) {
+            continue;
+        }
+        range.requestedAt = now;
+
+        if (!fresh(range, now)) {
+            // coalesced: one upstream read serves every client asking meanwhile
+            range.wanted = true;
+            stale = true;
+        }
+    }
+    return stale;
+}
+
+Modbus::ResultCode RegisterMirror::check(Modbus::FunctionCode fc, const Modbus::RequestData &data) {
+    if (fc != Modbus::FC_READ_REGS) {
+        return Modbus::EX_ILLEGAL_FUNCTION;
+    }
+    if (!covers(data.reg.address, data.regCount)) {
+        return Modbus::EX_ILLEGAL_ADDRESS;
+    }
+
+    // reached for fresh reads and for outdated ones hold() could not take
+    if (request(data.reg.address, data.regCount, millis())) {
+        missCount++;
+        return upstreamUp ? Modbus::EX_SLAVE_DEVICE_BUSY : Modbus::EX_DEVICE_FAILED_TO_RESPOND;
+    }
+
+    hitCount++;
+    return Modbus::EX_SUCCESS;
+}
+
+Modbus::ResultCode RegisterMirror::hold(const uint8_t *pdu, uint8_t length, const Modbus::frame_arg_t &header) {
+    if (!upstreamUp || length < 5 || pdu[0] != Modbus::FC_READ_REGS) {
+        return Modbus::EX_PASSTHROUGH;
+    }
+
+    uint16_t first = pdu[1] << 8 | pdu[2];
+    uint16_t count = pdu[3] << 8 | pdu[4];
+    uint32_t now = millis();
+    if (count == 0 || count > MAX_BLOCK_REGS || !covers(first, count) || freshRead(first, count, now)) {
+        return Modbus::EX_PASSTHROUGH;
+    }
+
+    // the raw response goes to the first connection of the IP, one held read per client keeps the answers apart
+    IPAddress client(header.ipaddr);
+    HeldRead *slot = nullptr;
+    for (HeldRead &read : held) {
+        if (read.used && read.client == client) {
+            return Modbus::EX_PASSTHROUGH;
+        }
+        if (!read.used && slot == nullptr) {
+            slot = &read;
+        }
+    }
+    if (slot == nullptr) {
+        return Modbus::EX_PASSTHROUGH;
+    }
+
+    request(first, count, now);
+    missCount++;
+    *slot = {client, header.transactionId, first, count, now, header.unitId, true};
+
+    // the library sends nothing, answerHeld() responds once the ranges are fetched
+    return Modbus::EX_SUCCESS;
+}
+
+void RegisterMirror::answerHeld(int8_t failedRange) {
+    uint32_t now = millis();
+
+    for (HeldRead &read : held) {
+        if (!read.used) {
+            continue;
+        }
+
+        bool covered = covers(read.first, read.count);
+        if (covered && freshRead(read.first, read.count, now)) {
+            uint8_t pdu[2 + 2 * MAX_BLOCK_REGS];
+            pdu[0] = Modbus::FC_READ_REGS;
+            pdu[1] = read.count * 2;
+            for (uint16_t i = 0; i < read.count; i++) {
+                uint16_t value = server.Hreg(read.first + i);
+                pdu[2 + 2 * i] = value >> 8;
+                pdu[3 + 2 * i] = value & 0xff;
+            }
+            server.setTransactionId(read.transaction);
+            server.rawResponce(read.client, pdu, 2 + 2 * read.count, read.unit);
+            read.used = false;
+            continue;
+        }
+
+        // a rebase may have moved the ranges away from the read
+        bool failed = !upstreamUp || !covered || now - read.heldAt >= MIRROR_HOLD_MILLIS ||
+                      (failedRange >= 0 && overlaps(read.first, read.count, ranges[failedRange].start, ranges[failedRange].count));
+        if (failed) {
+            server.setTransactionId(read.transaction);
+            server.errorResponce(read.client, Modbus::FC_READ_REGS, Modbus::EX_DEVICE_FAILED_TO_RESPOND, read.unit);
+            read.used = false;
+        }
+    }
+}
+
+void RegisterMirror::stored(bool success) {
+    if (fetching < 0) {
+        return;
+    }
+
+    int8_t index = fetching;
+    Range &range = ranges[index];
+    fetching = -1;
+
+    // a failed read is tried again when a client asks next time
+    range.wanted = false;
+    if (success) {
+        const uint16_t *values = fetchPlan.blockValues(0);
+        for (uint16_t i = 0; i < range.count; i++) {
+            server.Hreg(range.start + i, values[i]);
+        }
+        range.fetched = true;
+        range.fetchedAt = millis();
+    }
+
+    answerHeld(success ? -1 : index);
+}
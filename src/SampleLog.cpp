@@ -0,0 +1,349 @@
+#include "SampleLog.h"
+
+#include <LittleFS.h>
+
+// Marks a block, changes with the block format
+static const uint16_t SAMPLE_BLOCK_MAGIC = 0x4C53;  // "SL"
+
+// Ring file and index of earlier versions, which rewrote blocks in place
+static const char *LEGACY_DATA_FILE = "/samples.bin";
+static const char *LEGACY_INDEX_FILE = "/samples.idx";
+
+// Path of a segment file
+static void segmentPath(char *path, size_t size, uint8_t segment) {
+    snprintf(path, size, "/samples%02u.bin", segment);
+}
+
+// Response header of a download, the blocks follow as chunks
+static const char SAMPLE_DOWNLOAD_HEADER[] PROGMEM =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: application/octet-stream\r\n"
+    "Content-Disposition: attachment; filename=\"samples.bin\"\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "Connection: close\r\n"
+    "\r\n";
+
+// Chunk size line of a block and the chunk trailer
+static const char SAMPLE_CHUNK_START[] = "200\r\n";
+static const char SAMPLE_CHUNK_END[] = "\r\n";
+static const char SAMPLE_LAST_CHUNK[] = "0\r\n\r\n";
+
+// Longest varint of 32 bit
+static const uint8_t MAX_VARINT_BYTES = 5;
+
+// Writes v as unsigned LEB128 varint, returns the number of bytes
+static uint8_t putVarint(uint8_t *out, uint32_t v) {
+    uint8_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+// Length of the varint at in
+static uint8_t varintLength(const uint8_t *in) {
+    uint8_t n = 1;
+    while (in[n - 1] & 0x80) {
+        n++;
+    }
+    return n;
+}
+
+// Maps small negative and positive deltas to small unsigned values
+static uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+bool SampleLog::begin() {
+    LittleFS.remove(LEGACY_DATA_FILE);
+    LittleFS.remove(LEGACY_INDEX_FILE);
+
+    // the newest segment starts with the highest sequence, the segments before it are full
+    char path[20];
+    uint32_t newestFirst = 0;
+    for (uint8_t s = 0; s < SAMPLE_LOG_SEGMENTS; s++) {
+        segmentPath(path, sizeof(path), s);
+        File data = LittleFS.open(path, "r");
+        if (!data) {
+            continue;
+        }
+        SampleBlockHeader header = {};
+        uint16_t count = data.size() / SAMPLE_BLOCK_SIZE;
+        bool ok = count > 0 && data.read((uint8_t *)&header, sizeof(header)) == sizeof(header) && header.magic == SAMPLE_BLOCK_MAGIC;
+        data.close();
+        if (!ok) {
+            LittleFS.remove(path);
+            continue;
+        }
+
+        segments++;
+        if (header.sequence > newestFirst) {
+            newestFirst = header.sequence;
+            headSegment = s;
+            headBlocks = min<uint16_t>(count, SAMPLE_SEGMENT_BLOCKS);
+        }
+    }
+
+    if (segments > 0) {
+        blockCount = (segments - 1) * SAMPLE_SEGMENT_BLOCKS + headBlocks;
+        sequence = newestFirst + headBlocks - 1;
+    }
+    ready = true;
+    return true;
+}
+
+void SampleLog::add(uint32_t time, const SolarSnapshot &snapshot) {
+    int32_t values[SAMPLE_COLUMNS] = {
+        (int32_t)time,
+        divRound(snapshot.sunPower, 1000),
+        divRound(snapshot.houseUsage, 1000),
+        divRound(snapshot.meterPower, 1000),
+        divRound(snapshot.batteryPower, 1000),
+        snapshot.batteryStateOfEnergy};
+
+    for (uint8_t attempt = 0; attempt < 2; attempt++) {
+        if (rowCount == 0) {
+            // deltas of the first row are relative to the header
+            firstTime = time;
+            previous[0] = (int32_t)time;
+            for (uint8_t c = 1; c < SAMPLE_COLUMNS; c++) {
+                previous[c] = 0;
+            }
+        }
+
+        uint8_t row[SAMPLE_COLUMNS * MAX_VARINT_BYTES];
+        uint8_t length = 0;
+        for (uint8_t c = 0; c < SAMPLE_COLUMNS; c++) {
+            length += putVarint(row + length, zigzag((int32_t)((uint32_t)values[c] - (uint32_t)previous[c])));
+        }
+
+        if (rowsLength + length <= SAMPLE_PAYLOAD_SIZE && rowCount < UINT8_MAX) {
+            memcpy(rows + rowsLength, row, length);
+            rowsLength += length;
+            rowCount++;
+            memcpy(previous, values, sizeof(previous));
+            return;
+        }
+
+        // block is full: hand it to task() and start the next one with this sample
+        if (sealedPending) {
+            droppedCount++;
+        }
+        seal(sealed, sequence + 1);
+        sealedPending = true;
+        rowsLength = 0;
+        rowCount = 0;
+    }
+}
+
+void SampleLog::task() {
+    if (sealedPending) {
+        if (!writeBlock()) {
+            droppedCount++;
+        }
+        sealedPending = false;
+    }
+
+    // a few chunks per loop, as many as the socket takes
+    for (uint8_t i = 0; i < 2 && downloading && sendNext(); i++) {
+    }
+}
+
+void SampleLog::flush() {
+    if (sealedPending) {
+        writeBlock();
+        sealedPending = false;
+    }
+    if (rowCount > 0) {
+        seal(sealed, sequence + 1);
+        writeBlock();
+        rowsLength = 0;
+        rowCount = 0;
+    }
+}
+
+void SampleLog::seal(uint8_t *block, uint32_t blockSequence) const {
+    SampleBlockHeader header = {};
+    header.magic = SAMPLE_BLOCK_MAGIC;
+    header.count = rowCount;
+    header.columns = SAMPLE_COLUMNS;
+    header.sequence = blockSequence;
+    header.firstTime = firstTime;
+    header.length = rowsLength;
+    memcpy(block, &header, sizeof(header));
+
+    // column c is the c-th varint of every row
+    uint8_t *out = block + sizeof(header);
+    for (uint8_t c = 0; c < SAMPLE_COLUMNS; c++) {
+        const uint8_t *in = rows;
+        for (uint8_t r = 0; r < rowCount; r++) {
+            for (uint8_t skip = 0; skip < c; skip++) {
+                in += varintLength(in);
+            }
+            uint8_t n = varintLength(in);
+            memcpy(out, in, n);
+            out += n;
+            in += n;
+            for (uint8_t skip = c + 1; skip < SAMPLE_COLUMNS; skip++) {
+                in += varintLength(in);
+            }
+        }
+    }
+    memset(out, 0, block + SAMPLE_BLOCK_SIZE - out);
+}
+
+bool SampleLog::writeBlock() {
+    if (!ready) {
+        return false;
+    }
+    if (segments == 0 || headBlocks >= SAMPLE_SEGMENT_BLOCKS) {
+        startSegment();
+    }
+
+    // appending only touches the last flash block of the file
+    char path[20];
+    segmentPath(path, sizeof(path), headSegment);
+    File data = LittleFS.open(path, "a");
+    bool ok = data && data.write(sealed, SAMPLE_BLOCK_SIZE) == SAMPLE_BLOCK_SIZE;
+    if (data && !ok) {
+        // keep the blocks aligned for the next attempt
+        data.truncate((uint32_t)headBlocks * SAMPLE_BLOCK_SIZE);
+    }
+    data.close();
+
+    if (!ok) {
+        return false;
+    }
+    SampleBlockHeader header;
+    memcpy(&header, sealed, sizeof(header));
+    sequence = header.sequence;
+    headBlocks++;
+    blockCount++;
+    writeCount++;
+    return true;
+}
+
+void SampleLog::startSegment() {
+    uint8_t next = segments == 0 ? 0 : (headSegment + 1) % SAMPLE_LOG_SEGMENTS;
+    if (segments == SAMPLE_LOG_SEGMENTS) {
+        // the oldest segment goes as a whole, a download continues with the same block
+        segments--;
+        blockCount -= SAMPLE_SEGMENT_BLOCKS;
+        downloadBlock = downloadBlock >= SAMPLE_SEGMENT_BLOCKS ? downloadBlock - SAMPLE_SEGMENT_BLOCKS : 0;
+    }
+
+    char path[20];
+    segmentPath(path, sizeof(path), next);
+    LittleFS.remove(path);
+    headSegment = next;
+    headBlocks = 0;
+    segments++;
+}
+
+bool SampleLog::readBlock(uint16_t i, uint8_t *block, size_t size) {
+    if (i >= blockCount) {
+        return false;
+    }
+    char path[20];
+    segmentPath(path, sizeof(path), (oldestSegment() + i / SAMPLE_SEGMENT_BLOCKS) % SAMPLE_LOG_SEGMENTS);
+    File data = LittleFS.open(path, "r");
+    bool ok = data && data.seek((uint32_t)(i % SAMPLE_SEGMENT_BLOCKS) * SAMPLE_BLOCK_SIZE, SeekSet) && data.read(block, size) == size;
+    data.close();
+    return ok;
+}
+
+bool SampleLog::readIndex(uint16_t i, IndexEntry &entry) {
+    SampleBlockHeader header;
+    if (!readBlock(i, (uint8_t *)&header, sizeof(header))) {
+        return false;
+    }
+    entry = {header.sequence, header.firstTime};
+    return true;
+}
+
+bool SampleLog::download(WiFiClient &requestClient, uint32_t from, uint32_t to) {
+    if (!ready || (downloading && client.connected())) {
+        return false;
+    }
+
+    // binary search for the last block starting at or before `from`, the blocks are in time order
+    uint16_t lo = 0;
+    uint16_t hi = blockCount;
+    while (hi - lo > 1) {
+        uint16_t mid = (lo + hi) / 2;
+        IndexEntry entry;
+        if (readIndex(mid, entry) && entry.firstTime <= from) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    // the copy keeps the connection open after the web server releases the request
+    client = requestClient;
+    client.setNoDelay(true);
+    client.setSync(false);
+    downloading = true;
+    downloadBlock = lo;
+    downloadSequence = 0;
+    downloadTo = to;
+
+    char header[sizeof(SAMPLE_DOWNLOAD_HEADER)];
+    memcpy_P(header, SAMPLE_DOWNLOAD_HEADER, sizeof(SAMPLE_DOWNLOAD_HEADER));
+    client.write((const uint8_t *)header, sizeof(SAMPLE_DOWNLOAD_HEADER) - 1);
+    return true;
+}
+
+bool SampleLog::sendNext() {
+    if (!client.connected()) {
+        client.stop();
+        downloading = false;
+        return false;
+    }
+
+    // a slow client only delays the download, it never blocks the loop
+    const size_t chunkSize = sizeof(SAMPLE_CHUNK_START) - 1 + SAMPLE_BLOCK_SIZE + sizeof(SAMPLE_CHUNK_END) - 1;
+    if ((size_t)client.availableForWrite() < chunkSize) {
+        return false;
+    }
+
+    uint8_t block[SAMPLE_BLOCK_SIZE];
+    SampleBlockHeader header = {};
+    bool ok = readBlock(downloadBlock, block, SAMPLE_BLOCK_SIZE);
+    if (ok) {
+        memcpy(&header, block, sizeof(header));
+    }
+
+    // past the newest block, or the next one was dropped with its segment meanwhile
+    bool consecutive = downloadSequence == 0 || header.sequence == downloadSequence + 1;
+    if (!ok || header.magic != SAMPLE_BLOCK_MAGIC || !consecutive || header.firstTime > downloadTo) {
+        endDownload();
+        return false;
+    }
+
+    sendChunk(block);
+    downloadSequence = header.sequence;
+    downloadBlock++;
+    return true;
+}
+
+void SampleLog::sendChunk(const uint8_t *block) {
+    client.write((const uint8_t *)SAMPLE_CHUNK_START, sizeof(SAMPLE_CHUNK_START) - 1);
+    client.write(block, SAMPLE_BLOCK_SIZE);
+    client.write((const uint8_t *)SAMPLE_CHUNK_END, sizeof(SAMPLE_CHUNK_END) - 1);
+}
+
+void SampleLog::endDownload() {
+    // the samples still in RAM go out as one more block
+    if (rowCount > 0 && firstTime <= downloadTo) {
+        uint8_t block[SAMPLE_BLOCK_SIZE];
+        seal(block, sequence + 1);
+        sendChunk(block);
+    }
+
+    client.write((const uint8_t *)SAMPLE_LAST_CHUNK, sizeof(SAMPLE_LAST_CHUNK) - 1);
+    client.stop();
+    downloading = false;
+}
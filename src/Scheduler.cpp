@@ -0,0 +1,59 @@
+#include "Scheduler.h"
+
+bool Scheduler::addTask(const char *name, TaskCallback callback, uint32_t intervalMs, bool pausable) {
+    if (taskCount >= MAX_TASKS) {
+        return false;
+    }
+    tasks[taskCount++] = {name, callback, intervalMs, 0, pausable};
+    return true;
+}
+
+void Scheduler::run() {
+    uint32_t now = micros();
+    if (lastRunMicros != 0 && now - lastRunMicros > maxLoop) {
+        maxLoop = now - lastRunMicros;
+    }
+    lastRunMicros = now;
+
+    for (uint8_t i = 0; i < taskCount; i++) {
+        Task &t = tasks[i];
+        uint32_t ms = millis();
+        if ((paused && t.pausable) || ms - t.lastRunMs < t.intervalMs) {
+            continue;
+        }
+        t.lastRunMs = ms;
+
+        uint32_t start = micros();
+        t.callback();
+        uint32_t took = micros() - start;
+        if (took > maxTask) {
+            maxTask = took;
+            slowest = t.name;
+        }
+    }
+}
+
+uint32_t Scheduler::millisUntilDue() const {
+    uint32_t ms = millis();
+    uint32_t next = UINT32_MAX;
+
+    // tasks running every loop and paused tasks do not limit the time
+    for (uint8_t i = 0; i < taskCount; i++) {
+        const Task &t = tasks[i];
+        if (t.intervalMs == 0 || (paused && t.pausable)) {
+            continue;
+        }
+        uint32_t since = ms - t.lastRunMs;
+        uint32_t left = since >= t.intervalMs ? 0 : t.intervalMs - since;
+        if (left < next) {
+            next = left;
+        }
+    }
+    return next;
+}
+
+void Scheduler::resetLatency() {
+    maxLoop = 0;
+    maxTask = 0;
+    slowest = "";
+}
@@ -0,0 +1,406 @@
+#include "SolarSite.h"
+
+// Layout of the fixed SolarEdge addresses with the configured meters and batteries
+static DeviceLayout assumedLayout(const DeviceConfig &config) {
+    DeviceLayout layout = {};
+    layout.bases = DEFAULT_BLOCK_BASES;
+    layout.meters = config.meters;
+    layout.batteries = config.batteries;
+    return layout;
+}
+
+bool SolarSite::addDevice(const DeviceConfig &config) {
+    if (devices >= MAX_DEVICES) {
+        return false;
+    }
+
+    // inverters behind the same address share its connection
+    uint8_t c = 0;
+    while (c < connections && (connectionList[c].remote != config.remote || connectionList[c].port != config.port)) {
+        c++;
+    }
+    if (c == connections) {
+        connectionList[c].remote = config.remote;
+        connectionList[c].port = config.port;
+        connectionList[c].unit = config.unit;
+        connections++;
+    }
+
+    // the fixed SolarEdge addresses until the layout is known
+    Device &device = deviceList[devices++];
+    device.config = config;
+    device.connection = c;
+    applyLayout(device, assumedLayout(config));
+    device.layoutKnown = false;
+    return true;
+}
+
+void SolarSite::begin() {
+    for (uint8_t c = 0; c < connections; c++) {
+        connectionList[c].mb.client();
+    }
+
+    layouts.begin();
+    for (uint8_t d = 0; d < devices; d++) {
+        Device &device = deviceList[d];
+        DeviceLayout cached;
+        if (layouts.find(device.config.remote, device.config.port, device.config.unit, device.config.meters, device.config.batteries, cached)) {
+            applyLayout(device, cached);
+            Serial.printf("device %u: layout %08lx from flash\n", d + 1, (unsigned long)cached.fingerprint);
+        }
+    }
+}
+
+uint8_t SolarSite::connect() {
+    uint8_t connected = 0;
+    for (uint8_t c = 0; c < connections; c++) {
+        Connection &connection = connectionList[c];
+        if (connection.mb.isConnected(connection.remote) || connection.mb.connect(connection.remote, connection.port)) {
+            connected++;
+        }
+
+        // reads without an explicit unit, e.g. of the local Modbus server, go to the first inverter of the address
+        connection.pipeline.setTarget(connection.remote, connection.unit);
+    }
+    return connected;
+}
+
+bool SolarSite::isConnected() {
+    for (uint8_t c = 0; c < connections; c++) {
+        if (!connectionList[c].mb.isConnected(connectionList[c].remote)) {
+            return false;
+        }
+    }
+    return connections > 0;
+}
+
+void SolarSite::cancel() {
+    for (uint8_t c = 0; c < connections; c++) {
+        connectionList[c].pipeline.cancel();
+    }
+    pending = 0;
+}
+
+void SolarSite::invalidate() {
+    for (uint8_t d = 0; d < devices; d++) {
+        deviceList[d].cache.invalidate();
+    }
+}
+
+bool SolarSite::metadataValid() const {
+    for (uint8_t d = 0; d < devices; d++) {
+        if (!deviceList[d].cache.isValid()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SolarSite::submit(CycleCallback callback) {
+    bool metadata = !metadataValid();
+    cycleCallback = callback;
+    pending = 0;
+    cycleFailed = false;
+    cycleStartedAt = millis();
+
+    for (uint8_t d = 0; d < devices; d++) {
+        Device &device = deviceList[d];
+        if (metadata && device.cache.isValid()) {
+            continue;
+        }
+
+        // the metadata cycle of a device without layout starts with the walk of its model chain, with a layout with its check
+        ReadPlanner *plan = metadata ? &device.metadata : &device.usage;
+        device.rediscovered = false;
+        if (metadata && !device.layoutKnown) {
+            startDiscovery(device);
+            plan = &device.discovery.plan();
+        } else if (metadata && device.discovery.check(device.layout, device.config.batteries)) {
+            plan = &device.discovery.plan();
+        }
+        if (!resubmit(device, *plan)) {
+            return false;
+        }
+        pending++;
+    }
+    return pending > 0;
+}
+
+bool SolarSite::finish(ReadPlanner &plan, bool success) {
+    for (uint8_t d = 0; d < devices; d++) {
+        Device &device = deviceList[d];
+        if (&plan == &device.discovery.plan()) {
+            // a rejected address is an answer, e.g. of an inverter without a second battery block
+            bool rejected = !success && connectionList[device.connection].pipeline.cycleResult() == Modbus::EX_ILLEGAL_ADDRESS;
+            if ((success && device.discovery.next()) || (rejected && device.discovery.rejected())) {
+                // the walk goes on with the next model
+                if (resubmit(device, plan)) {
+                    return false;
+                }
+                success = false;
+            } else if (device.discovery.contradicted()) {
+                // a model or battery the cached layout does not know, walk the chain again within the same cycle
+                Serial.print("device ");
+                Serial.print(d + 1);
+                Serial.println(" reports more than its layout, rediscovering");
+                device.layoutKnown = false;
+                startDiscovery(device);
+                if (resubmit(device, device.discovery.plan())) {
+                    return false;
+                }
+                success = false;
+            } else if ((success || rejected) && !device.rediscovered) {
+                // the check confirmed the layout, read the metadata within the same cycle
+                success = resubmit(device, device.metadata);
+                if (success) {
+                    return false;
+                }
+            } else if (success || rejected) {
+                // a chain the walk does not understand falls back to the fixed addresses, which are not cached
+                DeviceLayout layout = device.discovery.found() ? device.discovery.result() : assumedLayout(device.config);
+                applyLayout(device, layout);
+                if (device.discovery.found()) {
+                    layouts.store(device.config.remote, device.config.port, device.config.unit, device.config.meters, device.config.batteries, layout);
+                }
+                if (device.meters != device.config.meters || device.batteries != device.config.batteries) {
+                    Serial.printf("device %u: configured meters %02x and batteries %02x not found\n", d + 1,
+                                  device.config.meters & ~device.meters, device.config.batteries & ~device.batteries);
+                }
+
+                // read the metadata at the discovered bases within the same cycle
+                success = resubmit(device, device.metadata);
+                if (success) {
+                    return false;
+                }
+            }
+        } else if (&plan == &device.metadata) {
+            device.metadataFailures = success ? 0 : device.metadataFailures + 1;
+            if (device.metadataFailures >= LAYOUT_RETRY_FAILURES && !device.rediscovered) {
+                // e.g. the blocks moved to addresses the inverter rejects
+                Serial.print("metadata of device ");
+                Serial.print(d + 1);
+                Serial.println(" keeps failing, layout dropped");
+                device.metadataFailures = 0;
+                device.layoutKnown = false;
+            }
+
+            bool loaded = success && device.cache.load(device.metadata);
+            if (success && !matchesLayout(device) && !device.rediscovered) {
+                // the model IDs disagree with the cached layout, walk the chain again
+                Serial.print("metadata of device ");
+                Serial.print(d + 1);
+                Serial.println(" contradicts its layout, rediscovering");
+                device.cache.invalidate();
+                device.layoutKnown = false;
+                startDiscovery(device);
+                if (resubmit(device, device.discovery.plan())) {
+                    return false;
+                }
+                loaded = false;
+            }
+            success = loaded;
+        } else if (&plan == &device.usage) {
+            if (success && !decode(device)) {
+                // values contradict the cached metadata, read it again
+                Serial.print("poll of device ");
+                Serial.print(d + 1);
+                Serial.println(" failed sanity check, metadata invalidated");
+                device.cache.invalidate();
+                success = false;
+            }
+        } else {
+            continue;
+        }
+
+        cycleFailed = cycleFailed || !success;
+        if (pending > 0) {
+            pending--;
+        }
+        if (pending == 0) {
+            lastCycle = millis() - cycleStartedAt;
+            return true;
+        }
+        return false;
+    }
+    return false;
+}
+
+void SolarSite::applyLayout(Device &device, const DeviceLayout &layout) {
+    device.layout = layout;
+    device.layoutKnown = true;
+    device.meters = device.config.meters & layout.meters;
+    device.batteries = device.config.batteries & layout.batteries;
+
+    device.usage.setLayout(planFields(usageFields(device.meters, device.batteries), layout.bases));
+    device.metadata.setLayout(planFields(metadataFields(device.meters, device.batteries), layout.bases));
+}
+
+bool SolarSite::matchesLayout(const Device &device) const {
+    // model 0 = assumed layout, only checked for plausibility by the register cache
+    const DeviceLayout &layout = device.layout;
+    if (layout.inverterModel != 0 && device.cache.inverterModelId() != layout.inverterModel) {
+        return false;
+    }
+    for (uint8_t i = 0; i < MAX_METERS; i++) {
+        if ((device.meters & (1 << i)) != 0 && layout.meterModel[i] != 0 && device.cache.meterModelId(i) != layout.meterModel[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SolarSite::startDiscovery(Device &device) {
+    device.discovery.start();
+    device.rediscovered = true;
+    discoveryCount++;
+}
+
+bool SolarSite::resubmit(Device &device, ReadPlanner &plan) {
+    if (!connectionList[device.connection].pipeline.submit(plan, cycleCallback, device.config.unit)) {
+        // a partial cycle would never complete
+        cancel();
+        return false;
+    }
+    return true;
+}
+
+bool SolarSite::decode(Device &device) {
+    const ReadPlanner &plan = device.usage;
+    RegisterCache &cache = device.cache;
+    cache.countHit();
+
+    // SunSpec marks values which are not available with 0x8000, scale factors stay within -10..10
+    int16_t inverterRaw = plan.int16(F_I_AC_POWER);
+    int16_t inverterSf = plan.int16(F_I_AC_POWER_SF);
+    if (inverterRaw == INT16_MIN || inverterSf < -10 || inverterSf > 10) {
+        return false;
+    }
+    device.inverterPower = plan.fixed(F_I_AC_POWER, 1000, inverterSf);
+    if (!cache.plausiblePower(device.inverterPower)) {
+        return false;
+    }
+
+    device.meterPower = 0;
+    for (uint8_t i = 0; i < MAX_METERS; i++) {
+        if ((device.meters & (1 << i)) == 0) {
+            continue;
+        }
+        int16_t meterSf = plan.int16(METER_AC_POWER_SF[i]);
+        if (plan.int16(METER_AC_POWER[i]) == INT16_MIN || meterSf < -10 || meterSf > 10) {
+            return false;
+        }
+        milliwatt_t power = plan.fixed(METER_AC_POWER[i], 1000, meterSf);
+        if (!cache.plausiblePower(power)) {
+            return false;
+        }
+        device.meterPower += power;
+    }
+
+    // battery registers are IEEE floats, decoded straight to fixed point
+    for (uint8_t i = 0; i < MAX_BATTERIES; i++) {
+        if ((device.batteries & (1 << i)) == 0) {
+            continue;
+        }
+        device.batteryPower[i] = plan.fixed(BATTERY_POWER[i], 1000);
+        device.batteryStateOfEnergy[i] = plan.fixed(BATTERY_STATE_OF_ENERGY[i], 10);
+        if (!cache.plausibleBattery(i, device.batteryPower[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SolarSite::aggregate(SolarSnapshot &snapshot) const {
+    snapshot.inverterPower = 0;
+    snapshot.meterPower = 0;
+    snapshot.batteryPower = 0;
+
+    // state of energy weighted by the rated energy, plain average if a battery does not report it
+    int64_t weightedSoe = 0;
+    int64_t ratedTotal = 0;
+    int32_t soeSum = 0;
+    uint8_t batteries = 0;
+    bool allRated = true;
+
+    for (uint8_t d = 0; d < devices; d++) {
+        const Device &device = deviceList[d];
+        snapshot.inverterPower += device.inverterPower;
+        snapshot.meterPower += device.meterPower;
+
+        for (uint8_t i = 0; i < MAX_BATTERIES; i++) {
+            if ((device.batteries & (1 << i)) == 0) {
+                continue;
+            }
+            int32_t rated = device.cache.batteryRatedEnergyWh(i);
+            snapshot.batteryPower += device.batteryPower[i];
+            soeSum += device.batteryStateOfEnergy[i];
+            weightedSoe += (int64_t)device.batteryStateOfEnergy[i] * rated;
+            ratedTotal += rated;
+            allRated = allRated && rated > 0;
+            batteries++;
+        }
+    }
+
+    if (batteries == 0) {
+        snapshot.batteryStateOfEnergy = 0;
+    } else if (allRated) {
+        snapshot.batteryStateOfEnergy = (weightedSoe + ratedTotal / 2) / ratedTotal;
+    } else {
+        snapshot.batteryStateOfEnergy = divRound(soeSum, batteries);
+    }
+}
+
+void SolarSite::task() {
+    for (uint8_t c = 0; c < connections; c++) {
+        connectionList[c].pipeline.clientTask();
+        connectionList[c].pipeline.task();
+    }
+}
+
+uint32_t SolarSite::requests() const {
+    uint32_t sum = 0;
+    for (uint8_t c = 0; c < connections; c++) {
+        sum += connectionList[c].pipeline.requests();
+    }
+    return sum;
+}
+
+uint32_t SolarSite::retries() const {
+    uint32_t sum = 0;
+    for (uint8_t c = 0; c < connections; c++) {
+        sum += connectionList[c].pipeline.retries();
+    }
+    return sum;
+}
+
+uint32_t SolarSite::timeouts() const {
+    uint32_t sum = 0;
+    for (uint8_t c = 0; c < connections; c++) {
+        sum += connectionList[c].pipeline.timeouts();
+    }
+    return sum;
+}
+
+uint8_t SolarSite::maxInFlight() const {
+    uint8_t highest = 0;
+    for (uint8_t c = 0; c < connections; c++) {
+        highest = max(highest, connectionList[c].pipeline.maxInFlight());
+    }
+    return highest;
+}
+
+uint32_t SolarSite::cacheHits() const {
+    uint32_t sum = 0;
+    for (uint8_t d = 0; d < devices; d++) {
+        sum += deviceList[d].cache.hits();
+    }
+    return sum;
+}
+
+uint32_t SolarSite::cacheMisses() const {
+    uint32_t sum = 0;
+    for (uint8_t d = 0; d < devices; d++) {
+        sum += deviceList[d].cache.misses();
+    }
+    return sum;
+}
@@ -0,0 +1,150 @@
+#include "WebApi.h"
+
+bool WebApi::cached(const SnapshotStore &snapshots, uint32_t builtSequence, unsigned long builtAt, bool built) {
+    return built && builtSequence == snapshots.latest().sequence && millis() - builtAt < WEB_API_CACHE_MILLIS;
+}
+
+const FixedText<LIVE_JSON_CAPACITY> &WebApi::live(const SnapshotStore &snapshots, unsigned long staleAfterMillis, const DeviceHealth &health) {
+    if (cached(snapshots, jsonSequence, jsonBuiltAt, jsonBuilt)) {
+        return json;
+    }
+
+    const SolarSnapshot &s = snapshots.latest();
+    json.clear();
+    json.append("{\"sequence\":").appendUInt(s.sequence);
+
+    if (snapshots.hasData()) {
+        json.append(",\"age_ms\":").appendUInt(snapshots.age());
+        json.append(",\"stale\":").append(snapshots.isStale(staleAfterMillis) ? "true" : "false");
+        json.append(",\"sun_w\":").appendFixed(s.sunPower, 3);
+        json.append(",\"house_w\":").appendFixed(s.houseUsage, 3);
+        json.append(",\"grid_w\":").appendFixed(s.meterPower, 3);
+        json.append(",\"battery_w\":").appendFixed(s.batteryPower, 3);
+        json.append(",\"battery_soe_pct\":").appendFixed(s.batteryStateOfEnergy, 1);
+        json.append(",\"inverter_w\":").appendFixed(s.inverterPower, 3);
+    } else {
+        json.append(",\"age_ms\":null,\"stale\":true,\"sun_w\":null,\"house_w\":null,\"grid_w\":null");
+        json.append(",\"battery_w\":null,\"battery_soe_pct\":null,\"inverter_w\":null");
+    }
+
+    json.append(",\"health\":{\"uptime_s\":").appendUInt(health.uptimeMillis / 1000);
+    json.append(",\"heap_free\":").appendUInt(health.freeHeap);
+    json.append(",\"heap_max_block\":").appendUInt(health.maxFreeBlock);
+    json.append(",\"heap_fragmentation_pct\":").appendUInt(health.heapFragmentation);
+    json.append(",\"rssi_dbm\":").appendInt(health.rssi);
+    json.append(",\"loop_max_us\":").appendUInt(health.loopMaxMicros);
+    json.append(",\"modbus_cycle_ms\":").appendUInt(health.cycleMillis);
+    json.append(",\"poll_interval_ms\":").appendUInt(health.pollIntervalMillis);
+    json.append(",\"modbus_requests\":").appendUInt(health.requests);
+    json.append(",\"modbus_retries\":").appendUInt(health.retries);
+    json.append(",\"modbus_timeouts\":").appendUInt(health.timeouts);
+    json.append(",\"poll_failures\":").appendUInt(health.pollFailures);
+    json.append("}}");
+
+    jsonSequence = s.sequence;
+    jsonBuiltAt = millis();
+    jsonBuilt = true;
+    buildCount++;
+    return json;
+}
+
+const FixedText<METRICS_TEXT_CAPACITY> &WebApi::metrics(const SnapshotStore &snapshots, const DeviceHealth &health) {
+    if (cached(snapshots, textSequence, textBuiltAt, textBuilt)) {
+        return text;
+    }
+
+    const SolarSnapshot &s = snapshots.latest();
+    text.clear();
+
+    // no samples instead of zeros before the first poll, so graphs show a gap
+    if (snapshots.hasData()) {
+        family("solaredge_power_watts", "gauge", "Power flow, grid positive = export, battery positive = charging");
+        metric("solaredge_power_watts", "flow=\"sun\"", s.sunPower, 3);
+        metric("solaredge_power_watts", "flow=\"house\"", s.houseUsage, 3);
+        metric("solaredge_power_watts", "flow=\"grid\"", s.meterPower, 3);
+        metric("solaredge_power_watts", "flow=\"battery\"", s.batteryPower, 3);
+        metric("solaredge_power_watts", "flow=\"inverter\"", s.inverterPower, 3);
+
+        family("solaredge_battery_soe_percent", "gauge", "Battery state of energy");
+        metric("solaredge_battery_soe_percent", nullptr, s.batteryStateOfEnergy, 1);
+
+        family("solaredge_snapshot_age_seconds", "gauge", "Age of the exported values");
+        metric("solaredge_snapshot_age_seconds", nullptr, min(snapshots.age(), 2000000000UL), 3);
+    }
+
+    family("solaredge_polls_total", "counter", "Successful polls since boot");
+    metric("solaredge_polls_total", nullptr, s.sequence);
+
+    family("monitor_uptime_seconds", "counter", "Time since boot");
+    metric("monitor_uptime_seconds", nullptr, health.uptimeMillis / 1000);
+
+    family("monitor_heap_free_bytes", "gauge", "Free heap");
+    metric("monitor_heap_free_bytes", nullptr, health.freeHeap);
+
+    family("monitor_heap_max_block_bytes", "gauge", "Largest free heap block");
+    metric("monitor_heap_max_block_bytes", nullptr, health.maxFreeBlock);
+
+    family("monitor_heap_fragmentation_percent", "gauge", "Heap fragmentation");
+    metric("monitor_heap_fragmentation_percent", nullptr, health.heapFragmentation);
+
+    family("monitor_wifi_rssi_dbm", "gauge", "WiFi signal strength");
+    metric("monitor_wifi_rssi_dbm", nullptr, health.rssi);
+
+    family("monitor_loop_max_seconds", "gauge", "Longest loop iteration in the current metrics window");
+    metric("monitor_loop_max_seconds", nullptr, health.loopMaxMicros, 6);
+
+    family("monitor_modbus_cycle_seconds", "gauge", "Duration of the last Modbus poll cycle");
+    metric("monitor_modbus_cycle_seconds", nullptr, health.cycleMillis, 3);
+
+    family("monitor_poll_interval_seconds", "gauge", "Current adaptive poll interval");
+    metric("monitor_poll_interval_seconds", nullptr, health.pollIntervalMillis, 3);
+
+    family("monitor_modbus_requests_total", "counter", "Modbus requests sent including retries");
+    metric("monitor_modbus_requests_total", nullptr, health.requests);
+
+    family("monitor_modbus_retries_total", "counter", "Repeated Modbus requests");
+    metric("monitor_modbus_retries_total", nullptr, health.retries);
+
+    family("monitor_modbus_timeouts_total", "counter", "Modbus requests without response");
+    metric("monitor_modbus_timeouts_total", nullptr, health.timeouts);
+
+    family("monitor_poll_failures_total", "counter", "Failed connects and polls");
+    metric("monitor_poll_failures_total", nullptr, health.pollFailures);
+
+    family("monitor_mqtt_published_total", "counter", "MQTT messages sent");
+    metric("monitor_mqtt_published_total", nullptr, health.mqttPublished);
+
+    family("monitor_mqtt_dropped_total", "counter", "MQTT messages lost to a full queue or refused");
+    metric("monitor_mqtt_dropped_total", nullptr, health.mqttDropped);
+
+    family("monitor_mqtt_latency_seconds", "gauge", "Time from poll to publish of the last MQTT message");
+    metric("monitor_mqtt_latency_seconds", nullptr, health.mqttLatencyMillis, 3);
+
+    family("monitor_boot_first_frame_seconds", "gauge", "Time from power on to the first frame with live values");
+    metric("monitor_boot_first_frame_seconds", nullptr, health.bootMillis, 3);
+
+    family("monitor_duty_cycle_ratio", "gauge", "Share of time awake since the last metrics interval");
+    metric("monitor_duty_cycle_ratio", nullptr, health.dutyCyclePermille, 3);
+
+    family("monitor_estimated_current_amperes", "gauge", "Average supply current estimated from the duty cycle");
+    metric("monitor_estimated_current_amperes", nullptr, health.currentMilliamps, 3);
+
+    textSequence = s.sequence;
+    textBuiltAt = millis();
+    textBuilt = true;
+    buildCount++;
+    return text;
+}
+
+void WebApi::family(const char *name, const char *type, const char *help) {
+    text.append("# HELP ").append(name).append(' ').append(help).append('\n');
+    text.append("# TYPE ").append(name).append(' ').append(type).append('\n');
+}
+
+void WebApi::metric(const char *name, const char *labels, int32_t value, uint8_t decimals) {
+    text.append(name);
+    if (labels != nullptr) {
+        text.append('{').append(labels).append('}');
+    }
+    text.append(' ').appendFixed(value, decimals).append('\n');
+}
@@ -0,0 +1,248 @@
+#include "Adafruit_GFX.h"
+
+// default 5x7 font, a test font in the library's layout
+#include "glcdfont.h"
+
+Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), currentWidth(w), currentHeight(h) {
+}
+
+void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    for (int16_t i = 0; i < h; i++) {
+        drawPixel(x, y + i, color);
+    }
+}
+
+void Adafruit_GFX::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    for (int16_t i = 0; i < w; i++) {
+        drawPixel(x + i, y, color);
+    }
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    for (int16_t i = x; i < x + w; i++) {
+        drawFastVLine(i, y, h, color);
+    }
+}
+
+void Adafruit_GFX::fillScreen(uint16_t color) {
+    fillRect(0, 0, currentWidth, currentHeight, color);
+}
+
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    if (x0 == x1) {
+        drawFastVLine(x0, min(y0, y1), abs(y1 - y0) + 1, color);
+        return;
+    }
+    if (y0 == y1) {
+        drawFastHLine(min(x0, x1), y0, abs(x1 - x0) + 1, color);
+        return;
+    }
+
+    // Bresenham
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) {
+        std::swap(x0, y0);
+        std::swap(x1, y1);
+    }
+    if (x0 > x1) {
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+    }
+
+    int16_t dx = x1 - x0;
+    int16_t dy = abs(y1 - y0);
+    int16_t err = dx / 2;
+    int16_t yStep = y0 < y1 ? 1 : -1;
+
+    for (; x0 <= x1; x0++) {
+        if (steep) {
+            drawPixel(y0, x0, color);
+        } else {
+            drawPixel(x0, y0, color);
+        }
+        err -= dy;
+        if (err < 0) {
+            y0 += yStep;
+            err += dx;
+        }
+    }
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+}
+
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t color) {
+    int16_t byteWidth = (w + 7) / 8;
+    uint8_t b = 0;
+
+    for (int16_t j = 0; j < h; j++, y++) {
+        for (int16_t i = 0; i < w; i++) {
+            if (i & 7) {
+                b <<= 1;
+            } else {
+                b = pgm_read_byte(&bitmap[j * byteWidth + i / 8]);
+            }
+            if (b & 0x80) {
+                drawPixel(x + i, y, color);
+            }
+        }
+    }
+}
+
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bg) {
+    int16_t byteWidth = (w + 7) / 8;
+    uint8_t b = 0;
+
+    for (int16_t j = 0; j < h; j++, y++) {
+        for (int16_t i = 0; i < w; i++) {
+            if (i & 7) {
+                b <<= 1;
+            } else {
+                b = pgm_read_byte(&bitmap[j * byteWidth + i / 8]);
+            }
+            drawPixel(x + i, y, (b & 0x80) ? color : bg);
+        }
+    }
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size) {
+    drawChar(x, y, c, color, bg, size, size);
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t sizeX, uint8_t sizeY) {
+    if (gfxFont == nullptr) {
+        // default font: 5 columns of 8 bits, bit 0 at the top, plus one column spacing
+        if (x >= currentWidth || y >= currentHeight || x + 6 * sizeX - 1 < 0 || y + 8 * sizeY - 1 < 0) {
+            return;
+        }
+        if (!useCp437 && c >= 176) {
+            c++;
+        }
+
+        for (int8_t i = 0; i < 5; i++) {
+            uint8_t line = pgm_read_byte(&font[c * 5 + i]);
+            for (int8_t j = 0; j < 8; j++, line >>= 1) {
+                if (line & 1) {
+                    if (sizeX == 1 && sizeY == 1) {
+                        drawPixel(x + i, y + j, color);
+                    } else {
+                        fillRect(x + i * sizeX, y + j * sizeY, sizeX, sizeY, color);
+                    }
+                } else if (bg != color) {
+                    if (sizeX == 1 && sizeY == 1) {
+                        drawPixel(x + i, y + j, bg);
+                    } else {
+                        fillRect(x + i * sizeX, y + j * sizeY, sizeX, sizeY, bg);
+                    }
+                }
+            }
+        }
+        if (bg != color) {
+            if (sizeX == 1 && sizeY == 1) {
+                drawFastVLine(x + 5, y, 8, bg);
+            } else {
+                fillRect(x + 5 * sizeX, y, sizeX, 8 * sizeY, bg);
+            }
+        }
+        return;
+    }
+
+    // custom font: glyph bitmap relative to the baseline, rows packed MSB first, background not drawn
+    c -= (uint8_t)pgm_read_byte(&gfxFont->first);
+    const GFXglyph *glyph = &gfxFont->glyph[c];
+    const uint8_t *bitmap = gfxFont->bitmap;
+
+    uint16_t bo = glyph->bitmapOffset;
+    uint8_t w = glyph->width;
+    uint8_t h = glyph->height;
+    int8_t xo = glyph->xOffset;
+    int8_t yo = glyph->yOffset;
+    uint8_t bits = 0;
+    uint8_t bit = 0;
+    int16_t xo16 = 0;
+    int16_t yo16 = 0;
+
+    if (sizeX > 1 || sizeY > 1) {
+        xo16 = xo;
+        yo16 = yo;
+    }
+
+    for (uint8_t yy = 0; yy < h; yy++) {
+        for (uint8_t xx = 0; xx < w; xx++) {
+            if (!(bit++ & 7)) {
+                bits = pgm_read_byte(&bitmap[bo++]);
+            }
+            if (bits & 0x80) {
+                if (sizeX == 1 && sizeY == 1) {
+                    drawPixel(x + xo + xx, y + yo + yy, color);
+                } else {
+                    fillRect(x + (xo16 + xx) * sizeX, y + (yo16 + yy) * sizeY, sizeX, sizeY, color);
+                }
+            }
+            bits <<= 1;
+        }
+    }
+}
+
+size_t Adafruit_GFX::write(uint8_t c) {
+    if (gfxFont == nullptr) {
+        if (c == '\n') {
+            cursorX = 0;
+            cursorY += textSizeY * 8;
+        } else if (c != '\r') {
+            if (wrap && cursorX + textSizeX * 6 > currentWidth) {
+                cursorX = 0;
+                cursorY += textSizeY * 8;
+            }
+            drawChar(cursorX, cursorY, c, textColor, textBgColor, textSizeX, textSizeY);
+            cursorX += textSizeX * 6;
+        }
+        return 1;
+    }
+
+    uint8_t yAdvance = pgm_read_byte(&gfxFont->yAdvance);
+    if (c == '\n') {
+        cursorX = 0;
+        cursorY += (int16_t)textSizeY * yAdvance;
+    } else if (c != '\r') {
+        uint8_t first = pgm_read_byte(&gfxFont->first);
+        if (c >= first && c <= (uint8_t)pgm_read_byte(&gfxFont->last)) {
+            const GFXglyph *glyph = &gfxFont->glyph[c - first];
+            if (glyph->width > 0 && glyph->height > 0) {
+                int16_t xo = glyph->xOffset;
+                if (wrap && cursorX + textSizeX * (xo + glyph->width) > currentWidth) {
+                    cursorX = 0;
+                    cursorY += (int16_t)textSizeY * yAdvance;
+                }
+                drawChar(cursorX, cursorY, c, textColor, textBgColor, textSizeX, textSizeY);
+            }
+            cursorX += glyph->xAdvance * (int16_t)textSizeX;
+        }
+    }
+    return 1;
+}
+
+void Adafruit_GFX::setFont(const GFXfont *font) {
+    // the default font is drawn from the top left corner, custom fonts from the baseline
+    if (font != nullptr && gfxFont == nullptr) {
+        cursorY += 6;
+    } else if (font == nullptr && gfxFont != nullptr) {
+        cursorY -= 6;
+    }
+    gfxFont = font;
+}
+
+void Adafruit_GFX::setRotation(uint8_t r) {
+    rotation = r & 3;
+    if (rotation == 0 || rotation == 2) {
+        currentWidth = WIDTH;
+        currentHeight = HEIGHT;
+    } else {
+        currentWidth = HEIGHT;
+        currentHeight = WIDTH;
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef NATIVE_ADAFRUIT_GFX_H
+#define NATIVE_ADAFRUIT_GFX_H
+
+#include <Arduino.h>
+
+// glyph and font structures in the layout of the real library
+#include <gfxfont.h>
+
+/**
+ * Subset of Adafruit_GFX used by the monitor. Primitives and text
+ * rendering follow the library's algorithms pixel by pixel, so frames
+ * composed on the host match the ones on the device. The fonts are test
+ * fonts with the cell size, advance and line height of the library fonts,
+ * so the host needs no download and the golden frames show the device's
+ * layout; only the glyph shapes differ.
+ */
+class Adafruit_GFX : public Print {
+   public:
+    Adafruit_GFX(int16_t w, int16_t h);
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void fillScreen(uint16_t color);
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t color);
+    void drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bg);
+
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size);
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t sizeX, uint8_t sizeY);
+
+    void setCursor(int16_t x, int16_t y) {
+        cursorX = x;
+        cursorY = y;
+    }
+    void setTextColor(uint16_t color) { textColor = textBgColor = color; }
+    void setTextColor(uint16_t color, uint16_t bg) {
+        textColor = color;
+        textBgColor = bg;
+    }
+    void setTextSize(uint8_t size) { setTextSize(size, size); }
+    void setTextSize(uint8_t sizeX, uint8_t sizeY) {
+        textSizeX = sizeX > 0 ? sizeX : 1;
+        textSizeY = sizeY > 0 ? sizeY : 1;
+    }
+    void setTextWrap(bool wrap) { this->wrap = wrap; }
+    void cp437(bool enable = true) { useCp437 = enable; }
+    void setFont(const GFXfont *font = nullptr);
+    void setRotation(uint8_t r);
+
+    size_t write(uint8_t c) override;
+    using Print::write;
+
+    int16_t width() const { return currentWidth; }
+    int16_t height() const { return currentHeight; }
+    uint8_t getRotation() const { return rotation; }
+    int16_t getCursorX() const { return cursorX; }
+    int16_t getCursorY() const { return cursorY; }
+
+   protected:
+    // Physical size
+    const int16_t WIDTH;
+    const int16_t HEIGHT;
+
+    int16_t currentWidth;
+    int16_t currentHeight;
+    int16_t cursorX = 0;
+    int16_t cursorY = 0;
+    uint16_t textColor = 0xFFFF;
+    uint16_t textBgColor = 0xFFFF;
+    uint8_t textSizeX = 1;
+    uint8_t textSizeY = 1;
+    uint8_t rotation = 0;
+    bool wrap = true;
+    bool useCp437 = false;
+    const GFXfont *gfxFont = nullptr;
+};
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef NATIVE_ADAFRUIT_I2C_DEVICE_H
+#define NATIVE_ADAFRUIT_I2C_DEVICE_H
+
+// Only included for the Arduino library dependency finder
+
+#endif
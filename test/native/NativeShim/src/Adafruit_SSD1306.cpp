@@ -0,0 +1,158 @@
+#include "Adafruit_SSD1306.h"
+
+// I2C transmissions of the library carry at most 32 bytes including the control byte
+static const uint8_t WIRE_MAX = 32;
+
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire *twi, int8_t rstPin, uint32_t clkDuring, uint32_t clkAfter)
+    : Adafruit_GFX(w, h), wire(twi), clkDuring(clkDuring), clkAfter(clkAfter) {
+}
+
+Adafruit_SSD1306::~Adafruit_SSD1306() {
+    free(buffer);
+}
+
+bool Adafruit_SSD1306::begin(uint8_t switchVcc, uint8_t address, bool reset, bool periphBegin) {
+    if (buffer == nullptr) {
+        buffer = (uint8_t *)malloc(WIDTH * ((HEIGHT + 7) / 8));
+        if (buffer == nullptr) {
+            return false;
+        }
+    }
+    clearDisplay();
+
+    if (address != 0) {
+        this->address = address;
+    }
+    if (periphBegin) {
+        wire->begin();
+    }
+    ssd1306_command(SSD1306_DISPLAYON);
+    return true;
+}
+
+void Adafruit_SSD1306::display() {
+    wire->setClock(clkDuring);
+
+    // whole frame: page and column window, then the data in chunks
+    wire->beginTransmission(address);
+    wire->write((uint8_t)0x00);
+    wire->write((uint8_t)SSD1306_PAGEADDR);
+    wire->write((uint8_t)0);
+    wire->write((uint8_t)0xFF);
+    wire->write((uint8_t)SSD1306_COLUMNADDR);
+    wire->write((uint8_t)0);
+    wire->write((uint8_t)(WIDTH - 1));
+    wire->endTransmission();
+
+    uint16_t count = WIDTH * ((HEIGHT + 7) / 8);
+    const uint8_t *p = buffer;
+    wire->beginTransmission(address);
+    wire->write((uint8_t)0x40);
+    uint8_t bytesOut = 1;
+    while (count--) {
+        if (bytesOut >= WIRE_MAX) {
+            wire->endTransmission();
+            wire->beginTransmission(address);
+            wire->write((uint8_t)0x40);
+            bytesOut = 1;
+        }
+        wire->write(*p++);
+        bytesOut++;
+    }
+    wire->endTransmission();
+
+    wire->setClock(clkAfter);
+    displays++;
+}
+
+void Adafruit_SSD1306::clearDisplay() {
+    memset(buffer, 0, WIDTH * ((HEIGHT + 7) / 8));
+}
+
+void Adafruit_SSD1306::invertDisplay(bool invert) {
+    ssd1306_command(invert ? SSD1306_INVERTDISPLAY : SSD1306_NORMALDISPLAY);
+}
+
+void Adafruit_SSD1306::dim(bool dim) {
+    ssd1306_command(SSD1306_SETCONTRAST);
+    ssd1306_command(dim ? 0 : 0xCF);
+    dimmed = dim;
+}
+
+void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if (x < 0 || x >= width() || y < 0 || y >= height()) {
+        return;
+    }
+
+    switch (getRotation()) {
+        case 1:
+            std::swap(x, y);
+            x = WIDTH - x - 1;
+            break;
+        case 2:
+            x = WIDTH - x - 1;
+            y = HEIGHT - y - 1;
+            break;
+        case 3:
+            std::swap(x, y);
+            y = HEIGHT - y - 1;
+            break;
+    }
+
+    uint8_t *p = &buffer[x + (y / 8) * WIDTH];
+    switch (color) {
+        case SSD1306_WHITE:
+            *p |= 1 << (y & 7);
+            break;
+        case SSD1306_BLACK:
+            *p &= ~(1 << (y & 7));
+            break;
+        case SSD1306_INVERSE:
+            *p ^= 1 << (y & 7);
+            break;
+    }
+}
+
+bool Adafruit_SSD1306::getPixel(int16_t x, int16_t y) {
+    if (x < 0 || x >= width() || y < 0 || y >= height()) {
+        return false;
+    }
+
+    switch (getRotation()) {
+        case 1:
+            std::swap(x, y);
+            x = WIDTH - x - 1;
+            break;
+        case 2:
+            x = WIDTH - x - 1;
+            y = HEIGHT - y - 1;
+            break;
+        case 3:
+            std::swap(x, y);
+            y = HEIGHT - y - 1;
+            break;
+    }
+    return buffer[x + (y / 8) * WIDTH] & (1 << (y & 7));
+}
+
+void Adafruit_SSD1306::ssd1306_command(uint8_t c) {
+    wire->beginTransmission(address);
+    wire->write((uint8_t)0x00);
+    wire->write(c);
+    wire->endTransmission();
+
+    switch (c) {
+        case SSD1306_DISPLAYOFF:
+            displayOn = false;
+            break;
+        case SSD1306_DISPLAYON:
+            displayOn = true;
+            break;
+        case SSD1306_NORMALDISPLAY:
+            inverted = false;
+            break;
+        case SSD1306_INVERTDISPLAY:
+            inverted = true;
+            break;
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef NATIVE_ADAFRUIT_SSD1306_H
+#define NATIVE_ADAFRUIT_SSD1306_H
+
+#include <Adafruit_GFX.h>
+#include <Wire.h>
+
+#define SSD1306_BLACK 0
+#define SSD1306_WHITE 1
+#define SSD1306_INVERSE 2
+
+#define SSD1306_MEMORYMODE 0x20
+#define SSD1306_COLUMNADDR 0x21
+#define SSD1306_PAGEADDR 0x22
+#define SSD1306_SETCONTRAST 0x81
+#define SSD1306_NORMALDISPLAY 0xA6
+#define SSD1306_INVERTDISPLAY 0xA7
+#define SSD1306_DISPLAYOFF 0xAE
+#define SSD1306_DISPLAYON 0xAF
+
+#define SSD1306_EXTERNALVCC 0x01
+#define SSD1306_SWITCHCAPVCC 0x02
+
+/**
+ * SSD1306 with the library's page layout buffer: one byte per column and
+ * 8 pixel high page, bit 0 at the top. Nothing is shown, the buffer is
+ * inspected instead. display() and commands are written to the TwoWire
+ * bus like the library does, so the bus counters show the traffic.
+ */
+class Adafruit_SSD1306 : public Adafruit_GFX {
+   public:
+    Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire *twi = &Wire, int8_t rstPin = -1, uint32_t clkDuring = 400000UL, uint32_t clkAfter = 100000UL);
+    ~Adafruit_SSD1306();
+
+    bool begin(uint8_t switchVcc = SSD1306_SWITCHCAPVCC, uint8_t address = 0, bool reset = true, bool periphBegin = true);
+    void display();
+    void clearDisplay();
+    void invertDisplay(bool invert);
+    void dim(bool dim);
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    bool getPixel(int16_t x, int16_t y);
+    uint8_t *getBuffer() { return buffer; }
+    void ssd1306_command(uint8_t c);
+
+    // Host only: panel state set by the commands sent so far
+    bool isDisplayOn() const { return displayOn; }
+    bool isInverted() const { return inverted; }
+    bool isDimmed() const { return dimmed; }
+
+    // Host only: number of display() calls
+    uint32_t displayCount() const { return displays; }
+
+   private:
+    TwoWire *wire;
+    uint8_t address = 0x3C;
+    uint32_t clkDuring;
+    uint32_t clkAfter;
+    uint8_t *buffer = nullptr;
+
+    bool displayOn = false;
+    bool inverted = false;
+    bool dimmed = false;
+    uint32_t displays = 0;
+};
+
+#endif
@@ -0,0 +1,323 @@
+#include "Arduino.h"
+
+#include <stdarg.h>
+
+#include <chrono>
+#include <random>
+#include <thread>
+
+HardwareSerial Serial;
+EspClass ESP;
+
+// ### Time ###
+
+// Start of the program, millis() and micros() count from here
+static const std::chrono::steady_clock::time_point startedAt = std::chrono::steady_clock::now();
+
+unsigned long millis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startedAt).count();
+}
+
+unsigned long micros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startedAt).count();
+}
+
+void delay(unsigned long ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield() {
+}
+
+// ### GPIO ###
+
+// Inputs idle high like with the pull ups of the board
+static int pinLevels[NATIVE_PIN_COUNT] = {HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH,
+                                          HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, LOW};
+
+// Interrupt handler and edge per pin
+static void (*pinHandlers[NATIVE_PIN_COUNT])() = {};
+static int pinModes[NATIVE_PIN_COUNT] = {};
+
+void pinMode(uint8_t pin, uint8_t mode) {
+}
+
+int digitalRead(uint8_t pin) {
+    return pin < NATIVE_PIN_COUNT ? pinLevels[pin] : LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+    if (pin < NATIVE_PIN_COUNT) {
+        pinLevels[pin] = level;
+    }
+}
+
+int digitalPinToInterrupt(int pin) {
+    return pin;
+}
+
+void attachInterrupt(int interrupt, void (*handler)(), int mode) {
+    if (interrupt >= 0 && interrupt < NATIVE_PIN_COUNT) {
+        pinHandlers[interrupt] = handler;
+        pinModes[interrupt] = mode;
+    }
+}
+
+void detachInterrupt(int interrupt) {
+    if (interrupt >= 0 && interrupt < NATIVE_PIN_COUNT) {
+        pinHandlers[interrupt] = nullptr;
+    }
+}
+
+void nativeSetPin(uint8_t pin, int level) {
+    if (pin >= NATIVE_PIN_COUNT || pinLevels[pin] == level) {
+        return;
+    }
+    pinLevels[pin] = level;
+
+    int edge = level == HIGH ? RISING : FALLING;
+    if (pinHandlers[pin] != nullptr && (pinModes[pin] & edge) != 0) {
+        pinHandlers[pin]();
+    }
+}
+
+// ### Misc ###
+
+// Fixed seed, runs are reproducible
+static std::mt19937 randomEngine(1);
+
+long random(long howBig) {
+    return howBig <= 0 ? 0 : (long)(randomEngine() % (unsigned long)howBig);
+}
+
+long random(long howSmall, long howBig) {
+    return howSmall >= howBig ? howSmall : howSmall + random(howBig - howSmall);
+}
+
+void randomSeed(unsigned long seed) {
+    randomEngine.seed(seed);
+}
+
+char *dtostrf(double value, signed char width, unsigned char precision, char *buffer) {
+    sprintf(buffer, "%*.*f", width, precision, value);
+    return buffer;
+}
+
+void configTime(const char *tz, const char *server1, const char *server2, const char *server3) {
+    setenv("TZ", tz, 1);
+    tzset();
+}
+
+// ### Print ###
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    while (size-- > 0) {
+        n += write(*buffer++);
+    }
+    return n;
+}
+
+size_t Print::print(const char *s) {
+    return write(s);
+}
+
+size_t Print::print(const String &s) {
+    return write(s.c_str(), s.length());
+}
+
+size_t Print::print(const __FlashStringHelper *s) {
+    return write((const char *)s);
+}
+
+size_t Print::print(char c) {
+    return write((uint8_t)c);
+}
+
+size_t Print::print(int value, int base) {
+    return print((long)value, base);
+}
+
+size_t Print::print(unsigned value, int base) {
+    return print((unsigned long)value, base);
+}
+
+size_t Print::print(long value, int base) {
+    if (base == DEC && value < 0) {
+        return print('-') + printNumber(-(unsigned long)value, base);
+    }
+    return printNumber((unsigned long)value, base);
+}
+
+size_t Print::print(unsigned long value, int base) {
+    return printNumber(value, base);
+}
+
+size_t Print::print(double value, int digits) {
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+    return write(buffer);
+}
+
+size_t Print::println() {
+    return write("\r\n");
+}
+
+size_t Print::println(const char *s) {
+    return print(s) + println();
+}
+
+size_t Print::println(const String &s) {
+    return print(s) + println();
+}
+
+size_t Print::println(const __FlashStringHelper *s) {
+    return print(s) + println();
+}
+
+size_t Print::println(char c) {
+    return print(c) + println();
+}
+
+size_t Print::println(int value, int base) {
+    return print(value, base) + println();
+}
+
+size_t Print::println(unsigned value, int base) {
+    return print(value, base) + println();
+}
+
+size_t Print::println(long value, int base) {
+    return print(value, base) + println();
+}
+
+size_t Print::println(unsigned long value, int base) {
+    return print(value, base) + println();
+}
+
+size_t Print::println(double value, int digits) {
+    return print(value, digits) + println();
+}
+
+size_t Print::printf(const char *format, ...) {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length < 0) {
+        return 0;
+    }
+    return write((const uint8_t *)buffer, min<size_t>(length, sizeof(buffer) - 1));
+}
+
+size_t Print::printf_P(const char *format, ...) {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length < 0) {
+        return 0;
+    }
+    return write((const uint8_t *)buffer, min<size_t>(length, sizeof(buffer) - 1));
+}
+
+size_t Print::printNumber(unsigned long value, int base) {
+    char buffer[8 * sizeof(long) + 1];
+    char *p = &buffer[sizeof(buffer) - 1];
+    *p = '\0';
+
+    if (base < 2) {
+        base = DEC;
+    }
+    do {
+        unsigned digit = value % base;
+        *--p = digit < 10 ? '0' + digit : 'A' + digit - 10;
+        value /= base;
+    } while (value > 0);
+    return write(p);
+}
+
+size_t Stream::readBytes(uint8_t *buffer, size_t length) {
+    size_t n = 0;
+    while (n < length) {
+        int c = read();
+        if (c < 0) {
+            break;
+        }
+        buffer[n++] = (uint8_t)c;
+    }
+    return n;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size) {
+    if (!muted) {
+        fwrite(buffer, 1, size, stdout);
+    }
+    return size;
+}
+
+// ### IPAddress ###
+
+bool IPAddress::fromString(const char *address) {
+    unsigned parts[4];
+    char tail;
+    if (address == nullptr || sscanf(address, "%u.%u.%u.%u%c", &parts[0], &parts[1], &parts[2], &parts[3], &tail) != 4) {
+        return false;
+    }
+    for (uint8_t i = 0; i < 4; i++) {
+        if (parts[i] > 255) {
+            return false;
+        }
+        bytes[i] = parts[i];
+    }
+    return true;
+}
+
+String IPAddress::toString() const {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", bytes[0], bytes[1], bytes[2], bytes[3]);
+    return buffer;
+}
+
+IPAddress::operator uint32_t() const {
+    uint32_t address;
+    memcpy(&address, bytes, sizeof(address));
+    return address;
+}
+
+// ### ESP ###
+
+void EspClass::restart() {
+    fflush(stdout);
+    exit(RESTART_EXIT_CODE);
+}
+
+uint32_t EspClass::getCycleCount() {
+    return micros() * getCpuFreqMHz();
+}
+
+bool EspClass::rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size) {
+    if (offset * 4 + size > NATIVE_RTC_USER_MEMORY) {
+        return false;
+    }
+    memcpy(data, &rtcMemory[offset * 4], size);
+    return true;
+}
+
+bool EspClass::rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size) {
+    if (offset * 4 + size > NATIVE_RTC_USER_MEMORY) {
+        return false;
+    }
+    memcpy(&rtcMemory[offset * 4], data, size);
+    return true;
+}
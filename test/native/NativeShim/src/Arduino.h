@@ -0,0 +1,261 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <functional>
+#include <string>
+
+/**
+ * Host replacement for the parts of the ESP8266 Arduino core used by the
+ * monitor. Time runs on the host's steady clock, serial output goes to
+ * stdout and GPIO levels are set from tests with nativeSetPin().
+ */
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+#define F(s) ((const __FlashStringHelper *)(s))
+class __FlashStringHelper;
+
+#define pgm_read_byte(a) (*(const uint8_t *)(a))
+#define pgm_read_word(a) (*(const uint16_t *)(a))
+#define pgm_read_dword(a) (*(const uint32_t *)(a))
+#define pgm_read_ptr(a) (*(void *const *)(a))
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define strncpy_P strncpy
+#define snprintf_P snprintf
+
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+
+// D1 mini pins
+#define D0 16
+#define D1 5
+#define D2 4
+#define D3 0
+#define D4 2
+#define D5 14
+#define D6 12
+#define D7 13
+#define D8 15
+#define LED_BUILTIN 2
+
+// Number of GPIOs with a level
+#define NATIVE_PIN_COUNT 17
+
+#define LOW 0
+#define HIGH 1
+
+#define INPUT 0x00
+#define INPUT_PULLUP 0x02
+#define OUTPUT 0x01
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define DEC 10
+#define HEX 16
+
+// ### Time ###
+
+// Milliseconds since the program started
+unsigned long millis();
+
+// Microseconds since the program started
+unsigned long micros();
+
+// Sleeps the host thread
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// No scheduler to yield to on the host
+void yield();
+
+// ### GPIO ###
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalPinToInterrupt(int pin);
+void attachInterrupt(int interrupt, void (*handler)(), int mode);
+void detachInterrupt(int interrupt);
+
+// Host only: drives an input pin, runs its interrupt handler if the edge matches
+void nativeSetPin(uint8_t pin, int level);
+
+// ### Misc ###
+
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+
+char *dtostrf(double value, signed char width, unsigned char precision, char *buffer);
+
+// Sets the time zone, the host clock is assumed to be synchronized already
+void configTime(const char *tz, const char *server1, const char *server2 = nullptr, const char *server3 = nullptr);
+
+template <class T>
+T min(T a, T b) {
+    return a < b ? a : b;
+}
+
+template <class T>
+T max(T a, T b) {
+    return a > b ? a : b;
+}
+
+template <class T>
+T constrain(T a, T low, T high) {
+    return a < low ? low : (a > high ? high : a);
+}
+
+// ### String ###
+
+class String : public std::string {
+   public:
+    String(const char *s = "") : std::string(s != nullptr ? s : "") {}
+    String(const std::string &s) : std::string(s) {}
+    String(char c) : std::string(1, c) {}
+    String(int value) : std::string(std::to_string(value)) {}
+    String(unsigned value) : std::string(std::to_string(value)) {}
+    String(long value) : std::string(std::to_string(value)) {}
+    String(unsigned long value) : std::string(std::to_string(value)) {}
+
+    bool isEmpty() const { return empty(); }
+    int toInt() const { return atoi(c_str()); }
+};
+
+// ### Print ###
+
+class Print {
+   public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *s) { return s == nullptr ? 0 : write((const uint8_t *)s, strlen(s)); }
+    size_t write(const char *buffer, size_t size) { return write((const uint8_t *)buffer, size); }
+
+    size_t print(const char *s);
+    size_t print(const String &s);
+    size_t print(const __FlashStringHelper *s);
+    size_t print(char c);
+    size_t print(int value, int base = DEC);
+    size_t print(unsigned value, int base = DEC);
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int digits = 2);
+
+    size_t println();
+    size_t println(const char *s);
+    size_t println(const String &s);
+    size_t println(const __FlashStringHelper *s);
+    size_t println(char c);
+    size_t println(int value, int base = DEC);
+    size_t println(unsigned value, int base = DEC);
+    size_t println(long value, int base = DEC);
+    size_t println(unsigned long value, int base = DEC);
+    size_t println(double value, int digits = 2);
+
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+    size_t printf_P(const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+   private:
+    size_t printNumber(unsigned long value, int base);
+};
+
+class Stream : public Print {
+   public:
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+    virtual int peek() { return -1; }
+    size_t write(uint8_t) override { return 1; }
+    using Print::write;
+
+    size_t readBytes(uint8_t *buffer, size_t length);
+    size_t readBytes(char *buffer, size_t length) { return readBytes((uint8_t *)buffer, length); }
+};
+
+// Serial port writing to stdout
+class HardwareSerial : public Stream {
+   public:
+    void begin(unsigned long baud) {}
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+
+    // Host only: suppresses the output, e.g. in benchmarks
+    void setMuted(bool muted) { this->muted = muted; }
+
+   private:
+    bool muted = false;
+};
+
+extern HardwareSerial Serial;
+
+// ### IPAddress ###
+
+class IPAddress {
+   public:
+    IPAddress() {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : bytes{a, b, c, d} {}
+    IPAddress(uint32_t address) { memcpy(bytes, &address, sizeof(bytes)); }
+
+    bool fromString(const char *address);
+    String toString() const;
+    bool isSet() const { return static_cast<uint32_t>(*this) != 0; }
+
+    // first octet in the lowest byte like on the ESP8266
+    operator uint32_t() const;
+    uint8_t operator[](int index) const { return bytes[index]; }
+    uint8_t &operator[](int index) { return bytes[index]; }
+    bool operator==(const IPAddress &other) const { return memcmp(bytes, other.bytes, sizeof(bytes)) == 0; }
+    bool operator!=(const IPAddress &other) const { return !(*this == other); }
+
+   private:
+    uint8_t bytes[4] = {0, 0, 0, 0};
+};
+
+// ### ESP ###
+
+// Size of the RTC user memory
+const size_t NATIVE_RTC_USER_MEMORY = 512;
+
+class EspClass {
+   public:
+    // Host only: restart() ends the program with this exit code
+    static const int RESTART_EXIT_CODE = 3;
+
+    void restart();
+    uint32_t getFreeHeap() { return 40000; }
+    uint32_t getMaxFreeBlockSize() { return 30000; }
+    uint8_t getHeapFragmentation() { return 10; }
+    uint32_t getCycleCount();
+    uint8_t getCpuFreqMHz() { return 80; }
+    uint32_t getChipId() { return 0x00c0ffee; }
+    String getResetReason() { return "Native start"; }
+
+    // RTC user memory, offset in 32 bit blocks
+    bool rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size);
+    bool rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size);
+
+   private:
+    uint8_t rtcMemory[NATIVE_RTC_USER_MEMORY] = {};
+};
+
+extern EspClass ESP;
+
+#endif
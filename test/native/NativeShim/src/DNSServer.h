@@ -0,0 +1,10 @@
+#ifndef NATIVE_DNS_SERVER_H
+#define NATIVE_DNS_SERVER_H
+
+// Captive portal DNS of the access point mode, not used on the host
+class DNSServer {
+   public:
+    void processNextRequest() {}
+};
+
+#endif
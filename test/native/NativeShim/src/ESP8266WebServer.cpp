@@ -0,0 +1,18 @@
+#include "ESP8266WebServer.h"
+
+void ESP8266WebServer::on(const char *uri, std::function<void()> handler) {
+    if (handlerCount < MAX_HANDLERS) {
+        uris[handlerCount] = uri;
+        handlers[handlerCount] = handler;
+        handlerCount++;
+    }
+}
+
+std::function<void()> ESP8266WebServer::handler(const char *uri) const {
+    for (uint8_t i = 0; i < handlerCount; i++) {
+        if (strcmp(uris[i], uri) == 0) {
+            return handlers[i];
+        }
+    }
+    return nullptr;
+}
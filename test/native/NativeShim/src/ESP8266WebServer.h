@@ -0,0 +1,52 @@
+#ifndef NATIVE_ESP8266_WEB_SERVER_H
+#define NATIVE_ESP8266_WEB_SERVER_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+
+/**
+ * Web server which registers handlers but never serves a request on the
+ * host. Tests may call a handler directly through handler().
+ */
+class ESP8266WebServer {
+   public:
+    ESP8266WebServer(int port = 80) {}
+
+    void begin() {}
+    void handleClient() {}
+    void on(const char *uri, std::function<void()> handler);
+    void onNotFound(std::function<void()> handler) { notFound = handler; }
+
+    void send(int code, const char *contentType = nullptr, const char *content = nullptr) {}
+    void send(int code, const char *contentType, const char *content, size_t length) {}
+    void send_P(int code, const char *contentType, const char *content) {}
+    void send_P(int code, const char *contentType, const char *content, size_t length) {}
+    void setContentLength(size_t length) {}
+    void sendHeader(const char *name, const char *value, bool first = false) {}
+    void sendContent(const char *content) {}
+    void sendContent(const char *content, size_t length) {}
+    void sendContent_P(const char *content) {}
+    void sendContent_P(const char *content, size_t length) {}
+
+    bool hasArg(const char *name) { return false; }
+    String arg(const char *name) { return String(); }
+    WiFiClient client() { return WiFiClient(); }
+
+    // Host only: handler registered for uri, empty if none
+    std::function<void()> handler(const char *uri) const;
+
+   private:
+    // Number of handlers kept, the monitor registers fewer
+    static const uint8_t MAX_HANDLERS = 16;
+
+    const char *uris[MAX_HANDLERS] = {};
+    std::function<void()> handlers[MAX_HANDLERS];
+    uint8_t handlerCount = 0;
+    std::function<void()> notFound;
+};
+
+typedef ESP8266WebServer WebServer;
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef NATIVE_ESP8266_WIFI_H
+#define NATIVE_ESP8266_WIFI_H
+
+#include <Arduino.h>
+
+#define WIFI_OFF 0
+#define WIFI_STA 1
+#define WIFI_AP 2
+#define WIFI_AP_STA 3
+
+enum WiFiSleepType_t {
+    WIFI_NONE_SLEEP,
+    WIFI_LIGHT_SLEEP,
+    WIFI_MODEM_SLEEP
+};
+
+enum wl_status_t {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_DISCONNECTED = 6
+};
+
+/**
+ * TCP client of the web server and MQTT. Not connected on the host: the
+ * HTTP and MQTT paths are not part of the native tests, writes are
+ * dropped.
+ */
+class WiFiClient : public Stream {
+   public:
+    int connect(IPAddress ip, uint16_t port) { return 0; }
+    int connect(const char *host, uint16_t port) { return 0; }
+    bool connected() { return false; }
+    operator bool() { return connected(); }
+    void stop() {}
+    void flush() {}
+
+    size_t write(uint8_t c) override { return 0; }
+    size_t write(const uint8_t *buffer, size_t size) override { return 0; }
+    using Print::write;
+    int availableForWrite() { return 0; }
+
+    void setNoDelay(bool noDelay) {}
+    void setSync(bool sync) {}
+    void setTimeout(unsigned long timeout) {}
+    IPAddress remoteIP() { return IPAddress(); }
+};
+
+/**
+ * Station which is always connected to a fixed access point with the
+ * host's loopback address, so code waiting for WiFi proceeds.
+ */
+class ESP8266WiFiClass {
+   public:
+    bool mode(int m) { return true; }
+    bool persistent(bool persistent) { return true; }
+    bool setAutoReconnect(bool autoReconnect) { return true; }
+    bool hostname(const char *name) { return true; }
+    bool hostname(const String &name) { return true; }
+    bool setSleepMode(WiFiSleepType_t type, uint8_t listenInterval = 0) { return true; }
+    bool forceSleepBegin(uint32_t us = 0) { return true; }
+    bool forceSleepWake() { return true; }
+
+    int begin() { return WL_CONNECTED; }
+    int begin(const char *ssid, const char *password, int32_t channel = 0, const uint8_t *bssid = nullptr, bool connect = true) { return WL_CONNECTED; }
+    bool config(IPAddress local, IPAddress gateway, IPAddress subnet, IPAddress dns1 = IPAddress(), IPAddress dns2 = IPAddress()) { return true; }
+    bool disconnect(bool wifiOff = false) { return true; }
+    int hostByName(const char *name, IPAddress &result, uint32_t timeoutMillis = 10000) { return result.fromString(name) ? 1 : 0; }
+    wl_status_t status() { return WL_CONNECTED; }
+
+    int32_t RSSI() { return -60; }
+    uint8_t *BSSID() { return bssid; }
+    int32_t channel() { return 6; }
+    IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+    IPAddress gatewayIP() { return IPAddress(127, 0, 0, 1); }
+    IPAddress subnetMask() { return IPAddress(255, 0, 0, 0); }
+    IPAddress dnsIP(uint8_t n = 0) { return IPAddress(127, 0, 0, 1); }
+
+   private:
+    uint8_t bssid[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+};
+
+extern ESP8266WiFiClass WiFi;
+
+#endif
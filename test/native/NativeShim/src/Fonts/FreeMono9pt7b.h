@@ -0,0 +1,205 @@
+#ifndef NATIVE_FREE_MONO_9PT7B_H
+#define NATIVE_FREE_MONO_9PT7B_H
+
+#include <gfxfont.h>
+
+// Test stand-in for the library's FreeMono 9pt font: the glyphs of the default test font at twice
+// the size, with the 11 pixel advance and 18 pixel line height of the real font
+const uint8_t FreeMono9pt7bBitmaps[] PROGMEM = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x0C, 0x03, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0x00, 0x00, 0x0C, 0x03, 0x00, 0x00, 0x00,
+    0x33, 0x0C, 0xC3, 0x30, 0xCC, 0x33, 0x0C, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x33, 0x0C, 0xC3, 0x30, 0xCC, 0xFF, 0xFF, 0xF3, 0x30, 0xCC, 0xFF, 0xFF, 0xF3, 0x30, 0xCC, 0x33, 0x0C, 0xC0, 0x00, 0x00,
+    0x0C, 0x03, 0x03, 0xFC, 0xFF, 0xCC, 0x33, 0x03, 0xF0, 0xFC, 0x0C, 0xC3, 0x3F, 0xF3, 0xFC, 0x0C, 0x03, 0x00, 0x00, 0x00,
+    0xF0, 0x3C, 0x0F, 0x0F, 0xC3, 0x03, 0x00, 0xC0, 0xC0, 0x30, 0x30, 0x0C, 0x0C, 0x3F, 0x0F, 0x03, 0xC0, 0xF0, 0x00, 0x00,
+    0x30, 0x0C, 0x0C, 0xC3, 0x30, 0xCC, 0x33, 0x03, 0x00, 0xC0, 0xCC, 0xF3, 0x3C, 0x33, 0x0C, 0x3C, 0xCF, 0x30, 0x00, 0x00,
+    0x0F, 0x03, 0xC0, 0xF0, 0x3C, 0x0C, 0x03, 0x03, 0x00, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x03, 0x00, 0xC0, 0xC0, 0x30, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x0C, 0x00, 0xC0, 0x30, 0x03, 0x00, 0xC0, 0x00, 0x00,
+    0x30, 0x0C, 0x00, 0xC0, 0x30, 0x03, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0xC0, 0x30, 0x30, 0x0C, 0x00, 0x00, 0x00,
+    0x0C, 0x03, 0x0C, 0xCF, 0x33, 0x3F, 0x0F, 0xCF, 0xFF, 0xFF, 0x3F, 0x0F, 0xCC, 0xCF, 0x33, 0x0C, 0x03, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x0F, 0xFF, 0xFF, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x03, 0xC0, 0xF0, 0x3C, 0x0C, 0x03, 0x03, 0x00, 0xC0,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3C, 0x0F, 0x03, 0xC0, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x0C, 0x03, 0x03, 0x00, 0xC0, 0xC0, 0x30, 0x30, 0x0C, 0x0C, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x3F, 0x0F, 0xCC, 0x0F, 0x03, 0xC3, 0xF0, 0xFC, 0xCF, 0x33, 0xF0, 0xFC, 0x3C, 0x0F, 0x03, 0x3F, 0x0F, 0xC0, 0x00, 0x00,
+    0x0C, 0x03, 0x03, 0xC0, 0xF0, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x3F, 0x0F, 0xC0, 0x00, 0x00,
+    0x3F, 0x0F, 0xCC, 0x0F, 0x03, 0x00, 0xC0, 0x33, 0xF0, 0xFC, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xFF, 0xFF, 0xF0, 0x00, 0x00,
+    0xFF, 0xFF, 0xF0, 0x0C, 0x03, 0x03, 0x00, 0xC0, 0xF0, 0x3C, 0x00, 0xC0, 0x3C, 0x0F, 0x03, 0x3F, 0x0F, 0xC0, 0x00, 0x00,
+    0x03, 0x00, 0xC0, 0xF0, 0x3C, 0x33, 0x0C, 0xCC, 0x33, 0x0C, 0xFF, 0xFF, 0xF0, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0x00, 0x00,
+    0xFF, 0xFF, 0xFC, 0x03, 0x00, 0xFF, 0x3F, 0xC0, 0x0C, 0x03, 0x00, 0xC0, 0x3C, 0x0F, 0x03, 0x3F, 0x0F, 0xC0, 0x00, 0x00,
+    0x0F, 0xC3, 0xF3, 0x00, 0xC0, 0xC0, 0x30, 0x0F, 0xF3, 0xFC, 0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0x3F, 0x0F, 0xC0, 0x00, 0x00,
+    0xFF, 0xFF, 0xF0, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x30, 0x0C, 0x0C, 0x03, 0x03, 0x00, 0xC0, 0xC0, 0x30, 0x00, 0x00, 0x00,
+    0x3F, 0x0F, 0xCC, 0x0F, 0x03, 0xC0, 0xF0, 0x33, 0xF0, 0xFC, 0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0x3F, 0x0F, 0xC0, 0x00, 0x00,
+    0x3F, 0x0F, 0xCC, 0x0F, 0x03, 0xC0, 0xF0, 0x33, 0xFC, 0xFF, 0x00, 0xC0, 0x30, 0x30, 0x0C, 0xFC, 0x3F, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x03, 0x00, 0x00, 0x00, 0x0C, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x03, 0x00, 0x00, 0x00, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x30, 0x0C, 0x00, 0x00, 0x00,
+    0x00, 0xC0, 0x30, 0x30, 0x0C, 0x0C, 0x03, 0x03, 0x00, 0xC0, 0x0C, 0x03, 0x00, 0x30, 0x0C, 0x00, 0xC0, 0x30, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xF0, 0x00, 0x00, 0xFF, 0xFF, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x30, 0x0C, 0x00, 0xC0, 0x30, 0x03, 0x00, 0xC0, 0x0C, 0x03, 0x03, 0x00, 0xC0, 0xC0, 0x30, 0x30, 0x0C, 0x00, 0x00, 0x00,
+    0x3F, 0x0F, 0xCC, 0x0F, 0x03, 0x00, 0xC0, 0x30, 0xF0, 0x3C, 0x0C, 0x03, 0x00, 0x00, 0x00, 0x0C, 0x03, 0x00, 0x00, 0x00,
+    0x3F, 0x0F, 0xCC, 0x0F, 0x03, 0xCC, 0xF3, 0x3C, 0xFF, 0x3F, 0xCF, 0x33, 0xCC, 0x03, 0x00, 0x3F, 0xCF, 0xF0, 0x00, 0x00,
+    0x0C, 0x03, 0x03, 0x30, 0xCC, 0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0xFF, 0xFF, 0xFC, 0x0F, 0x03, 0xC0, 0xF0, 0x30, 0x00, 0x00,
+    0xFF, 0x3F, 0xCC, 0x0F, 0x03, 0xC0, 0xF0, 0x3F, 0xF3, 0xFC, 0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0xFF, 0x3F, 0xC0, 0x00, 0x00,
+    0x3F, 0x0F, 0xCC, 0x0F, 0x03, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x0C, 0x0F, 0x03, 0x3F, 0x0F, 0xC0, 0x00, 0x00,
+    0xFF, 0x3F, 0xCC, 0x0F, 0x03, 0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0xFF, 0x3F, 0xC0, 0x00, 0x00,
+    0xFF, 0xFF, 0xFC, 0x03, 0x00, 0xC0, 0x30, 0x0F, 0xF3, 0xFC, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xFF, 0xFF, 0xF0, 0x00, 0x00,
+    0xFF, 0xFF, 0xFC, 0x03, 0x00, 0xC0, 0x30, 0x0F, 0xF3, 0xFC, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x00, 0x00, 0x00,
+    0x3F, 0xCF, 0xFC, 0x0F, 0x03, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xC3, 0xF0, 0xFC, 0x0F, 0x03, 0x3F, 0xCF, 0xF0, 0x00, 0x00,
+    0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0xC0, 0xF0, 0x3F, 0xFF, 0xFF, 0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0xC0, 0xF0, 0x30, 0x00, 0x00,
+    0x3F, 0x0F, 0xC0, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x3F, 0x0F, 0xC0, 0x00, 0x00,
+    0x0F, 0xC3, 0xF0, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xCC, 0x33, 0x0C, 0x3C, 0x0F, 0x00, 0x00, 0x00,
+    0xC0, 0xF0, 0x3C, 0x33, 0x0C, 0xCC, 0x33, 0x0F, 0x03, 0xC0, 0xCC, 0x33, 0x0C, 0x33, 0x0C, 0xC0, 0xF0, 0x30, 0x00, 0x00,
+    0xC0, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xFF, 0xFF, 0xF0, 0x00, 0x00,
+    0xC0, 0xF0, 0x3F, 0x3F, 0xCF, 0xCC, 0xF3, 0x3C, 0xCF, 0x33, 0xCC, 0xF3, 0x3C, 0x0F, 0x03, 0xC0, 0xF0, 0x30, 0x00, 0x00,
+    0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0xF0, 0xFC, 0x3C, 0xCF, 0x33, 0xC3, 0xF0, 0xFC, 0x0F, 0x03, 0xC0, 0xF0, 0x30, 0x00, 0x00,
+    0x3F, 0x0F, 0xCC, 0x0F, 0x03, 0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0x3F, 0x0F, 0xC0, 0x00, 0x00,
+    0xFF, 0x3F, 0xCC, 0x0F, 0x03, 0xC0, 0xF0, 0x3F, 0xF3, 0xFC, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x00, 0x00, 0x00,
+    0x3F, 0x0F, 0xCC, 0x0F, 0x03, 0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0xCC, 0xF3, 0x3C, 0x33, 0x0C, 0x3C, 0xCF, 0x30, 0x00, 0x00,
+    0xFF, 0x3F, 0xCC, 0x0F, 0x03, 0xC0, 0xF0, 0x3F, 0xF3, 0xFC, 0xCC, 0x33, 0x0C, 0x33, 0x0C, 0xC0, 0xF0, 0x30, 0x00, 0x00,
+    0x3F, 0x0F, 0xCC, 0x0F, 0x03, 0xC0, 0x30, 0x03, 0xF0, 0xFC, 0x00, 0xC0, 0x3C, 0x0F, 0x03, 0x3F, 0x0F, 0xC0, 0x00, 0x00,
+    0xFF, 0xFF, 0xFC, 0xCF, 0x33, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0x00, 0x00,
+    0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0x3F, 0x0F, 0xC0, 0x00, 0x00,
+    0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0xC0, 0xF0, 0x33, 0x30, 0xCC, 0x0C, 0x03, 0x00, 0x00, 0x00,
+    0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0xC0, 0xF0, 0x3C, 0xCF, 0x33, 0xCC, 0xF3, 0x3C, 0xCF, 0x33, 0x33, 0x0C, 0xC0, 0x00, 0x00,
+    0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0x33, 0x0C, 0xC0, 0xC0, 0x30, 0x33, 0x0C, 0xCC, 0x0F, 0x03, 0xC0, 0xF0, 0x30, 0x00, 0x00,
+    0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0x33, 0x0C, 0xC0, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0x00, 0x00,
+    0xFF, 0xFF, 0xF0, 0x0C, 0x03, 0x03, 0x00, 0xC3, 0xF0, 0xFC, 0x30, 0x0C, 0x0C, 0x03, 0x00, 0xFF, 0xFF, 0xF0, 0x00, 0x00,
+    0x3F, 0xCF, 0xF3, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0x3F, 0xCF, 0xF0, 0x00, 0x00,
+    0x00, 0x00, 0x0C, 0x03, 0x00, 0x30, 0x0C, 0x00, 0xC0, 0x30, 0x03, 0x00, 0xC0, 0x0C, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x3F, 0xCF, 0xF0, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x3F, 0xCF, 0xF0, 0x00, 0x00,
+    0x0C, 0x03, 0x03, 0x30, 0xCC, 0xC0, 0xF0, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xF0, 0x00, 0x00,
+    0x3C, 0x0F, 0x03, 0xC0, 0xF0, 0x0C, 0x03, 0x00, 0x30, 0x0C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x3C, 0x0F, 0x00, 0x30, 0x0C, 0x3F, 0x0F, 0xCC, 0x33, 0x0C, 0x3F, 0xCF, 0xF0, 0x00, 0x00,
+    0xC0, 0x30, 0x0C, 0x03, 0x00, 0xCF, 0x33, 0xCF, 0x0F, 0xC3, 0xC0, 0xF0, 0x3F, 0x0F, 0xC3, 0xCF, 0x33, 0xC0, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x3F, 0x0F, 0xCC, 0x0F, 0x03, 0xC0, 0x30, 0x0C, 0x0F, 0x03, 0x3F, 0x0F, 0xC0, 0x00, 0x00,
+    0x00, 0xC0, 0x30, 0x0C, 0x03, 0x3C, 0xCF, 0x3C, 0x3F, 0x0F, 0xC0, 0xF0, 0x3C, 0x3F, 0x0F, 0x3C, 0xCF, 0x30, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x3F, 0x0F, 0xCC, 0x0F, 0x03, 0xFF, 0xFF, 0xFC, 0x03, 0x00, 0x3F, 0x0F, 0xC0, 0x00, 0x00,
+    0x03, 0x00, 0xC0, 0xCC, 0x33, 0x0C, 0x03, 0x03, 0xF0, 0xFC, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x3F, 0x0F, 0xCC, 0x3F, 0x0F, 0xC3, 0xF0, 0xF3, 0xCC, 0xF3, 0x00, 0xC0, 0x33, 0xF0, 0xFC,
+    0xC0, 0x30, 0x0C, 0x03, 0x00, 0xCF, 0x33, 0xCF, 0x0F, 0xC3, 0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0xC0, 0xF0, 0x30, 0x00, 0x00,
+    0x0C, 0x03, 0x00, 0x00, 0x00, 0x3C, 0x0F, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x3F, 0x0F, 0xC0, 0x00, 0x00,
+    0x03, 0x00, 0xC0, 0x00, 0x00, 0x03, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xCC, 0x33, 0x0C, 0x3C, 0x0F, 0x00, 0x00, 0x00,
+    0xC0, 0x30, 0x0C, 0x03, 0x00, 0xC3, 0x30, 0xCC, 0xC3, 0x30, 0xF0, 0x3C, 0x0C, 0xC3, 0x30, 0xC3, 0x30, 0xC0, 0x00, 0x00,
+    0x3C, 0x0F, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x3F, 0x0F, 0xC0, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xF3, 0x3C, 0xCC, 0xCF, 0x33, 0xCC, 0xF3, 0x3C, 0xCF, 0x33, 0xCC, 0xF3, 0x30, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xCF, 0x33, 0xCF, 0x0F, 0xC3, 0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0xC0, 0xF0, 0x30, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x3F, 0x0F, 0xCC, 0x0F, 0x03, 0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0x3F, 0x0F, 0xC0, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xCF, 0x33, 0xCF, 0x0F, 0xC3, 0xF0, 0xFC, 0x3C, 0xF3, 0x3C, 0xC0, 0x30, 0x0C, 0x03, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x3C, 0xCF, 0x3C, 0x3F, 0x0F, 0xC3, 0xF0, 0xF3, 0xCC, 0xF3, 0x00, 0xC0, 0x30, 0x0C, 0x03,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xCF, 0x33, 0xCF, 0x0F, 0xC3, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x3F, 0xCF, 0xFC, 0x03, 0x00, 0x3F, 0x0F, 0xC0, 0x0C, 0x03, 0xFF, 0x3F, 0xC0, 0x00, 0x00,
+    0x0C, 0x03, 0x00, 0xC0, 0x30, 0xFF, 0xFF, 0xF0, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xCC, 0x33, 0x03, 0x00, 0xC0, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0xC0, 0xF0, 0x3C, 0x3F, 0x0F, 0x3C, 0xCF, 0x30, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0xC0, 0xF0, 0x33, 0x30, 0xCC, 0x0C, 0x03, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0xCC, 0xF3, 0x3C, 0xCF, 0x33, 0x33, 0x0C, 0xC0, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xC0, 0xF0, 0x33, 0x30, 0xCC, 0x0C, 0x03, 0x03, 0x30, 0xCC, 0xC0, 0xF0, 0x30, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0x3F, 0xCF, 0xF0, 0x0C, 0x03, 0xC0, 0xF0, 0x33, 0xF0, 0xFC,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xF0, 0x30, 0x0C, 0x0C, 0x03, 0x03, 0x00, 0xC0, 0xFF, 0xFF, 0xF0, 0x00, 0x00,
+    0x03, 0x00, 0xC0, 0xC0, 0x30, 0x0C, 0x03, 0x03, 0x00, 0xC0, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x03, 0x00, 0xC0, 0x00, 0x00,
+    0x0C, 0x03, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0x00, 0x00, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0x00, 0x00,
+    0x30, 0x0C, 0x00, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0x30, 0x0C, 0x0C, 0x03, 0x00, 0xC0, 0x30, 0x30, 0x0C, 0x00, 0x00, 0x00,
+    0x30, 0x0C, 0x0C, 0xCF, 0x33, 0x03, 0x00, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+const GFXglyph FreeMono9pt7bGlyphs[] PROGMEM = {
+    {0, 10, 16, 11, 0, -14},  // ' '
+    {20, 10, 16, 11, 0, -14},  // '!'
+    {40, 10, 16, 11, 0, -14},  // '"'
+    {60, 10, 16, 11, 0, -14},  // '#'
+    {80, 10, 16, 11, 0, -14},  // '$'
+    {100, 10, 16, 11, 0, -14},  // '%'
+    {120, 10, 16, 11, 0, -14},  // '&'
+    {140, 10, 16, 11, 0, -14},  // '''
+    {160, 10, 16, 11, 0, -14},  // '('
+    {180, 10, 16, 11, 0, -14},  // ')'
+    {200, 10, 16, 11, 0, -14},  // '*'
+    {220, 10, 16, 11, 0, -14},  // '+'
+    {240, 10, 16, 11, 0, -14},  // ','
+    {260, 10, 16, 11, 0, -14},  // '-'
+    {280, 10, 16, 11, 0, -14},  // '.'
+    {300, 10, 16, 11, 0, -14},  // '/'
+    {320, 10, 16, 11, 0, -14},  // '0'
+    {340, 10, 16, 11, 0, -14},  // '1'
+    {360, 10, 16, 11, 0, -14},  // '2'
+    {380, 10, 16, 11, 0, -14},  // '3'
+    {400, 10, 16, 11, 0, -14},  // '4'
+    {420, 10, 16, 11, 0, -14},  // '5'
+    {440, 10, 16, 11, 0, -14},  // '6'
+    {460, 10, 16, 11, 0, -14},  // '7'
+    {480, 10, 16, 11, 0, -14},  // '8'
+    {500, 10, 16, 11, 0, -14},  // '9'
+    {520, 10, 16, 11, 0, -14},  // ':'
+    {540, 10, 16, 11, 0, -14},  // ';'
+    {560, 10, 16, 11, 0, -14},  // '<'
+    {580, 10, 16, 11, 0, -14},  // '='
+    {600, 10, 16, 11, 0, -14},  // '>'
+    {620, 10, 16, 11, 0, -14},  // '?'
+    {640, 10, 16, 11, 0, -14},  // '@'
+    {660, 10, 16, 11, 0, -14},  // 'A'
+    {680, 10, 16, 11, 0, -14},  // 'B'
+    {700, 10, 16, 11, 0, -14},  // 'C'
+    {720, 10, 16, 11, 0, -14},  // 'D'
+    {740, 10, 16, 11, 0, -14},  // 'E'
+    {760, 10, 16, 11, 0, -14},  // 'F'
+    {780, 10, 16, 11, 0, -14},  // 'G'
+    {800, 10, 16, 11, 0, -14},  // 'H'
+    {820, 10, 16, 11, 0, -14},  // 'I'
+    {840, 10, 16, 11, 0, -14},  // 'J'
+    {860, 10, 16, 11, 0, -14},  // 'K'
+    {880, 10, 16, 11, 0, -14},  // 'L'
+    {900, 10, 16, 11, 0, -14},  // 'M'
+    {920, 10, 16, 11, 0, -14},  // 'N'
+    {940, 10, 16, 11, 0, -14},  // 'O'
+    {960, 10, 16, 11, 0, -14},  // 'P'
+    {980, 10, 16, 11, 0, -14},  // 'Q'
+    {1000, 10, 16, 11, 0, -14},  // 'R'
+    {1020, 10, 16, 11, 0, -14},  // 'S'
+    {1040, 10, 16, 11, 0, -14},  // 'T'
+    {1060, 10, 16, 11, 0, -14},  // 'U'
+    {1080, 10, 16, 11, 0, -14},  // 'V'
+    {1100, 10, 16, 11, 0, -14},  // 'W'
+    {1120, 10, 16, 11, 0, -14},  // 'X'
+    {1140, 10, 16, 11, 0, -14},  // 'Y'
+    {1160, 10, 16, 11, 0, -14},  // 'Z'
+    {1180, 10, 16, 11, 0, -14},  // '['
+    {1200, 10, 16, 11, 0, -14},  // 'backslash'
+    {1220, 10, 16, 11, 0, -14},  // ']'
+    {1240, 10, 16, 11, 0, -14},  // '^'
+    {1260, 10, 16, 11, 0, -14},  // '_'
+    {1280, 10, 16, 11, 0, -14},  // '`'
+    {1300, 10, 16, 11, 0, -14},  // 'a'
+    {1320, 10, 16, 11, 0, -14},  // 'b'
+    {1340, 10, 16, 11, 0, -14},  // 'c'
+    {1360, 10, 16, 11, 0, -14},  // 'd'
+    {1380, 10, 16, 11, 0, -14},  // 'e'
+    {1400, 10, 16, 11, 0, -14},  // 'f'
+    {1420, 10, 16, 11, 0, -14},  // 'g'
+    {1440, 10, 16, 11, 0, -14},  // 'h'
+    {1460, 10, 16, 11, 0, -14},  // 'i'
+    {1480, 10, 16, 11, 0, -14},  // 'j'
+    {1500, 10, 16, 11, 0, -14},  // 'k'
+    {1520, 10, 16, 11, 0, -14},  // 'l'
+    {1540, 10, 16, 11, 0, -14},  // 'm'
+    {1560, 10, 16, 11, 0, -14},  // 'n'
+    {1580, 10, 16, 11, 0, -14},  // 'o'
+    {1600, 10, 16, 11, 0, -14},  // 'p'
+    {1620, 10, 16, 11, 0, -14},  // 'q'
+    {1640, 10, 16, 11, 0, -14},  // 'r'
+    {1660, 10, 16, 11, 0, -14},  // 's'
+    {1680, 10, 16, 11, 0, -14},  // 't'
+    {1700, 10, 16, 11, 0, -14},  // 'u'
+    {1720, 10, 16, 11, 0, -14},  // 'v'
+    {1740, 10, 16, 11, 0, -14},  // 'w'
+    {1760, 10, 16, 11, 0, -14},  // 'x'
+    {1780, 10, 16, 11, 0, -14},  // 'y'
+    {1800, 10, 16, 11, 0, -14},  // 'z'
+    {1820, 10, 16, 11, 0, -14},  // '{'
+    {1840, 10, 16, 11, 0, -14},  // '|'
+    {1860, 10, 16, 11, 0, -14},  // '}'
+    {1880, 10, 16, 11, 0, -14}  // '~'
+};
+
+const GFXfont FreeMono9pt7b PROGMEM = {(uint8_t *)FreeMono9pt7bBitmaps, (GFXglyph *)FreeMono9pt7bGlyphs, 0x20, 0x7E, 18};
+
+#endif
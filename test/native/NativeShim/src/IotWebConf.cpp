@@ -0,0 +1,56 @@
+#include "IotWebConf.h"
+
+namespace iotwebconf {
+
+void ParameterGroup::addItem(Parameter *parameter) {
+    Parameter **tail = &first;
+    while (*tail != nullptr) {
+        tail = &(*tail)->next;
+    }
+    *tail = parameter;
+}
+
+void ParameterGroup::applyDefaultValue() {
+    for (Parameter *p = first; p != nullptr; p = p->next) {
+        p->applyDefaultValue();
+    }
+}
+
+void TextParameter::applyDefaultValue() {
+    if (length <= 0) {
+        return;
+    }
+    strncpy(valueBuffer, defaultValue != nullptr ? defaultValue : "", length - 1);
+    valueBuffer[length - 1] = '\0';
+}
+
+IotWebConf::IotWebConf(const char *thingName, DNSServer *dnsServer, WebServer *server, const char *initialApPassword, const char *configVersion) {
+    strncpy(this->thingName, thingName, sizeof(this->thingName) - 1);
+    this->thingName[sizeof(this->thingName) - 1] = '\0';
+}
+
+void IotWebConf::addParameterGroup(ParameterGroup *group) {
+    if (groupCount < MAX_GROUPS) {
+        groups[groupCount++] = group;
+    }
+}
+
+bool IotWebConf::init() {
+    systemGroup.applyDefaultValue();
+    for (uint8_t i = 0; i < groupCount; i++) {
+        groups[i]->applyDefaultValue();
+    }
+
+    if (connectionHandler) {
+        connectionHandler("native", "");
+    }
+    state = NetworkState::OnLine;
+    if (wifiConnected) {
+        wifiConnected();
+    }
+
+    // no stored configuration, like a fresh device
+    return false;
+}
+
+}  // namespace iotwebconf
@@ -0,0 +1,129 @@
+#ifndef NATIVE_IOT_WEB_CONF_H
+#define NATIVE_IOT_WEB_CONF_H
+
+#include <Arduino.h>
+#include <DNSServer.h>
+#include <ESP8266WebServer.h>
+#include <ESP8266WiFi.h>
+
+namespace iotwebconf {
+
+struct WifiAuthInfo {
+    const char *ssid;
+    const char *password;
+};
+
+enum class NetworkState {
+    Boot,
+    NotConfigured,
+    ApMode,
+    Connecting,
+    OnLine,
+    OffLine
+};
+
+class Parameter {
+   public:
+    virtual ~Parameter() {}
+
+    // Writes the default value to the value buffer
+    virtual void applyDefaultValue() {}
+
+    Parameter *next = nullptr;
+};
+
+// Parameters of a group, in the order they were added
+class ParameterGroup : public Parameter {
+   public:
+    ParameterGroup(const char *id, const char *label = nullptr) : id(id), label(label) {}
+
+    void addItem(Parameter *parameter);
+    void applyDefaultValue() override;
+
+    const char *id;
+    const char *label;
+
+   private:
+    Parameter *first = nullptr;
+};
+
+class TextParameter : public Parameter {
+   public:
+    TextParameter(const char *label, const char *id, char *valueBuffer, int length, const char *defaultValue = nullptr, const char *placeholder = nullptr, const char *customHtml = nullptr)
+        : label(label), id(id), valueBuffer(valueBuffer), length(length), defaultValue(defaultValue) {}
+
+    void applyDefaultValue() override;
+
+    const char *label;
+    const char *id;
+    char *valueBuffer;
+    int length;
+    const char *defaultValue;
+};
+
+class NumberParameter : public TextParameter {
+   public:
+    using TextParameter::TextParameter;
+};
+
+class PasswordParameter : public TextParameter {
+   public:
+    using TextParameter::TextParameter;
+};
+
+class CheckboxParameter : public TextParameter {
+   public:
+    CheckboxParameter(const char *label, const char *id, char *valueBuffer, int length, bool defaultValue = false)
+        : TextParameter(label, id, valueBuffer, length, defaultValue ? "selected" : nullptr) {}
+
+    bool isChecked() { return strcmp(valueBuffer, "selected") == 0; }
+};
+
+/**
+ * Configuration portal without storage or portal: init() applies the
+ * default value of every parameter and the device is online right away
+ * with the host's network.
+ */
+class IotWebConf {
+   public:
+    IotWebConf(const char *thingName, DNSServer *dnsServer, WebServer *server, const char *initialApPassword, const char *configVersion);
+
+    void addParameterGroup(ParameterGroup *group);
+    ParameterGroup *getSystemParameterGroup() { return &systemGroup; }
+    bool init();
+    void doLoop() {}
+    void saveConfig() {}
+    void handleConfig() {}
+    void handleNotFound() {}
+
+    NetworkState getState() { return state; }
+    char *getThingName() { return thingName; }
+    WifiAuthInfo getWifiAuthInfo() { return {"native", ""}; }
+
+    void setStatusPin(int pin) {}
+    void setConfigPin(int pin) {}
+    void setApTimeoutMs(unsigned long timeout) {}
+    void setWifiConnectionTimeoutMs(unsigned long timeout) {}
+    void skipApStartup() {}
+
+    void setWifiConnectionCallback(std::function<void()> callback) { wifiConnected = callback; }
+    void setConfigSavedCallback(std::function<void()> callback) {}
+    void setWifiConnectionHandler(std::function<void(const char *, const char *)> handler) { connectionHandler = handler; }
+    void setWifiConnectionFailedHandler(std::function<WifiAuthInfo *()> handler) {}
+
+   private:
+    // Groups registered with addParameterGroup()
+    static const uint8_t MAX_GROUPS = 8;
+
+    char thingName[33];
+    ParameterGroup systemGroup = ParameterGroup("iwcSys", "System configuration");
+    ParameterGroup *groups[MAX_GROUPS] = {};
+    uint8_t groupCount = 0;
+    NetworkState state = NetworkState::Boot;
+    std::function<void()> wifiConnected;
+    std::function<void(const char *, const char *)> connectionHandler;
+};
+
+}  // namespace iotwebconf
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef NATIVE_IOT_WEB_CONF_USING_H
+#define NATIVE_IOT_WEB_CONF_USING_H
+
+using iotwebconf::IotWebConf;
+typedef iotwebconf::ParameterGroup IotWebConfParameterGroup;
+typedef iotwebconf::TextParameter IotWebConfTextParameter;
+typedef iotwebconf::NumberParameter IotWebConfNumberParameter;
+typedef iotwebconf::PasswordParameter IotWebConfPasswordParameter;
+typedef iotwebconf::CheckboxParameter IotWebConfCheckboxParameter;
+
+#endif
@@ -0,0 +1,119 @@
+#include "LittleFS.h"
+
+FS LittleFS;
+
+size_t File::size() const {
+    return handle ? handle->data->size() : 0;
+}
+
+size_t File::position() const {
+    return handle ? handle->position : 0;
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    if (!handle) {
+        return false;
+    }
+
+    size_t base = mode == SeekSet ? 0 : (mode == SeekCur ? handle->position : handle->data->size());
+    if (base + pos > handle->data->size()) {
+        return false;
+    }
+    handle->position = base + pos;
+    return true;
+}
+
+bool File::truncate(uint32_t size) {
+    if (!handle || !handle->writable) {
+        return false;
+    }
+    handle->data->resize(size);
+    handle->position = min<size_t>(handle->position, size);
+    return true;
+}
+
+int File::available() {
+    return handle ? (int)(handle->data->size() - handle->position) : 0;
+}
+
+int File::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek() {
+    if (!handle || !handle->readable || handle->position >= handle->data->size()) {
+        return -1;
+    }
+    return (*handle->data)[handle->position];
+}
+
+size_t File::read(uint8_t *buffer, size_t size) {
+    if (!handle || !handle->readable) {
+        return 0;
+    }
+    size_t n = min(size, handle->data->size() - handle->position);
+    memcpy(buffer, handle->data->data() + handle->position, n);
+    handle->position += n;
+    return n;
+}
+
+size_t File::write(const uint8_t *buffer, size_t size) {
+    if (!handle || !handle->writable) {
+        return 0;
+    }
+    if (handle->append) {
+        handle->position = handle->data->size();
+    }
+
+    std::vector<uint8_t> &data = *handle->data;
+    if (handle->position + size > data.size()) {
+        data.resize(handle->position + size);
+    }
+    memcpy(data.data() + handle->position, buffer, size);
+    handle->position += size;
+    return size;
+}
+
+bool FS::format() {
+    files.clear();
+    return true;
+}
+
+File FS::open(const char *path, const char *mode) {
+    File file;
+    bool plus = strchr(mode, '+') != nullptr;
+
+    auto it = files.find(path);
+    if (mode[0] == 'r') {
+        if (it == files.end()) {
+            return file;
+        }
+    } else if (mode[0] == 'w') {
+        it = files.insert_or_assign(path, std::vector<uint8_t>()).first;
+    } else if (mode[0] == 'a') {
+        it = files.emplace(path, std::vector<uint8_t>()).first;
+    } else {
+        return file;
+    }
+
+    // map nodes are stable, the handle can keep a pointer to the contents
+    file.handle = std::make_shared<File::Handle>();
+    file.handle->data = &it->second;
+    file.handle->readable = mode[0] == 'r' || plus;
+    file.handle->writable = mode[0] != 'r' || plus;
+    file.handle->append = mode[0] == 'a';
+    file.handle->position = mode[0] == 'a' ? it->second.size() : 0;
+    return file;
+}
+
+bool FS::rename(const char *from, const char *to) {
+    auto it = files.find(from);
+    if (it == files.end()) {
+        return false;
+    }
+    std::vector<uint8_t> data = std::move(it->second);
+    files.erase(it);
+    files[to] = std::move(data);
+    return true;
+}
@@ -0,0 +1,73 @@
+#ifndef NATIVE_LITTLE_FS_H
+#define NATIVE_LITTLE_FS_H
+
+#include <Arduino.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+enum SeekMode {
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+/**
+ * Handle of an open file, copies share the position like on the device.
+ */
+class File : public Stream {
+   public:
+    File() {}
+
+    operator bool() const { return handle != nullptr; }
+    size_t size() const;
+    size_t position() const;
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    bool truncate(uint32_t size);
+    void flush() {}
+    void close() { handle.reset(); }
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t read(uint8_t *buffer, size_t size);
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+
+   private:
+    friend class FS;
+
+    // Open file: its contents in the file system and the position
+    struct Handle {
+        std::vector<uint8_t> *data;
+        size_t position;
+        bool readable;
+        bool writable;
+        bool append;
+    };
+
+    std::shared_ptr<Handle> handle;
+};
+
+/**
+ * File system in memory, empty at program start.
+ */
+class FS {
+   public:
+    bool begin() { return true; }
+    void end() {}
+    bool format();
+    File open(const char *path, const char *mode);
+    bool exists(const char *path) { return files.count(path) > 0; }
+    bool remove(const char *path) { return files.erase(path) > 0; }
+    bool rename(const char *from, const char *to);
+
+   private:
+    std::map<std::string, std::vector<uint8_t>> files;
+};
+
+extern FS LittleFS;
+
+#endif
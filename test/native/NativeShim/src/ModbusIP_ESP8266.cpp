@@ -0,0 +1,473 @@
+#include "ModbusIP_ESP8266.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// MBAP header: transaction, protocol, length, unit
+static const uint8_t MBAP_SIZE = 7;
+
+// Maximum number of registers of one read
+static const uint16_t MAX_READ_REGS = 125;
+
+static uint16_t getWord(const uint8_t *p) {
+    return (uint16_t)(p[0] << 8 | p[1]);
+}
+
+static void putWord(uint8_t *p, uint16_t value) {
+    p[0] = value >> 8;
+    p[1] = value & 0xff;
+}
+
+// Sends all of a frame, the frames are small enough for the socket buffer
+static bool sendAll(int fd, const uint8_t *data, size_t length) {
+    while (length > 0) {
+        ssize_t n = ::send(fd, data, length, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        length -= n;
+    }
+    return true;
+}
+
+static void setNonBlocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+ModbusIP::~ModbusIP() {
+    for (Peer &peer : clients) {
+        if (peer.fd >= 0) {
+            ::close(peer.fd);
+        }
+    }
+    for (Peer &peer : serverPeers) {
+        if (peer.fd >= 0) {
+            ::close(peer.fd);
+        }
+    }
+    if (listenFd >= 0) {
+        ::close(listenFd);
+    }
+}
+
+// ### Client ###
+
+bool ModbusIP::connect(IPAddress ip, uint16_t port) {
+    if (isConnected(ip)) {
+        return true;
+    }
+
+    Peer *peer = nullptr;
+    for (Peer &candidate : clients) {
+        if (candidate.fd < 0) {
+            peer = &candidate;
+            break;
+        }
+    }
+    if (peer == nullptr) {
+        return false;
+    }
+
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = (uint32_t)ip;  // first octet in the lowest byte is network order
+    if (::connect(fd, (sockaddr *)&address, sizeof(address)) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    setNonBlocking(fd);
+    peer->fd = fd;
+    peer->ip = ip;
+    peer->rxLength = 0;
+    return true;
+}
+
+bool ModbusIP::disconnect(IPAddress ip) {
+    for (Peer &peer : clients) {
+        if (peer.fd >= 0 && peer.ip == ip) {
+            closePeer(peer, false);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ModbusIP::isConnected(IPAddress ip) {
+    for (Peer &peer : clients) {
+        if (peer.fd >= 0 && peer.ip == ip) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint16_t ModbusIP::readHreg(IPAddress ip, uint16_t offset, uint16_t *value, uint16_t numregs, cbTransaction cb, uint8_t unit) {
+    if (numregs == 0 || numregs > MAX_READ_REGS || transactionCount >= MODBUSIP_MAX_TRANSACIONS) {
+        return 0;
+    }
+
+    Peer *peer = nullptr;
+    for (Peer &candidate : clients) {
+        if (candidate.fd >= 0 && candidate.ip == ip) {
+            peer = &candidate;
+            break;
+        }
+    }
+    if (peer == nullptr) {
+        return 0;
+    }
+
+    // 0 marks a failed request, IDs wrap around after it
+    lastTransactionId++;
+    if (lastTransactionId == 0) {
+        lastTransactionId = 1;
+    }
+
+    uint8_t frame[MBAP_SIZE + 5];
+    putWord(&frame[0], lastTransactionId);
+    putWord(&frame[2], 0);
+    putWord(&frame[4], 6);
+    frame[6] = unit;
+    frame[7] = FC_READ_REGS;
+    putWord(&frame[8], offset);
+    putWord(&frame[10], numregs);
+
+    if (!sendAll(peer->fd, frame, sizeof(frame))) {
+        closePeer(*peer, false);
+        return 0;
+    }
+
+    transactions[transactionCount++] = {lastTransactionId, ip, value, numregs, cb, (uint32_t)millis()};
+    return lastTransactionId;
+}
+
+bool ModbusIP::isTransaction(uint16_t id) {
+    for (uint8_t i = 0; i < transactionCount; i++) {
+        if (transactions[i].id == id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ModbusIP::dropTransactions() {
+    while (transactionCount > 0) {
+        finish(0, EX_CANCEL);
+    }
+}
+
+void ModbusIP::finish(uint8_t i, ResultCode result) {
+    Transaction transaction = transactions[i];
+    for (uint8_t j = i + 1; j < transactionCount; j++) {
+        transactions[j - 1] = transactions[j];
+    }
+    transactionCount--;
+
+    if (transaction.cb != nullptr) {
+        transaction.cb(result, transaction.id, nullptr);
+    }
+}
+
+void ModbusIP::onResponse(const uint8_t *frame, uint16_t length) {
+    uint16_t id = getWord(&frame[0]);
+    uint8_t i = 0;
+    while (i < transactionCount && transactions[i].id != id) {
+        i++;
+    }
+    if (i == transactionCount) {
+        return;
+    }
+
+    const uint8_t *pdu = &frame[MBAP_SIZE];
+    uint16_t pduLength = length - MBAP_SIZE;
+    Transaction &transaction = transactions[i];
+
+    if (pduLength >= 2 && pdu[0] == (FC_READ_REGS | 0x80)) {
+        finish(i, (ResultCode)pdu[1]);
+    } else if (pduLength >= 2 && pdu[0] == FC_READ_REGS && pdu[1] == transaction.count * 2 && pduLength >= 2 + pdu[1]) {
+        for (uint16_t r = 0; r < transaction.count; r++) {
+            transaction.value[r] = getWord(&pdu[2 + 2 * r]);
+        }
+        finish(i, EX_SUCCESS);
+    } else {
+        finish(i, EX_UNEXPECTED_RESPONSE);
+    }
+}
+
+// ### Server ###
+
+void ModbusIP::server(uint16_t port) {
+    listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        return;
+    }
+
+    int one = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (::bind(listenFd, (sockaddr *)&address, sizeof(address)) != 0 || ::listen(listenFd, MODBUSIP_MAX_CLIENTS) != 0) {
+        ::close(listenFd);
+        listenFd = -1;
+        return;
+    }
+    fcntl(listenFd, F_SETFL, fcntl(listenFd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+bool ModbusIP::addHreg(uint16_t offset, uint16_t value, uint16_t numregs) {
+    for (uint16_t i = 0; i < numregs; i++) {
+        hregs.emplace(offset + i, value);
+    }
+    return true;
+}
+
+bool ModbusIP::removeHreg(uint16_t offset, uint16_t numregs) {
+    for (uint16_t i = 0; i < numregs; i++) {
+        hregs.erase(offset + i);
+    }
+    return true;
+}
+
+bool ModbusIP::Hreg(uint16_t offset, uint16_t value) {
+    auto it = hregs.find(offset);
+    if (it == hregs.end()) {
+        return false;
+    }
+    it->second = value;
+    return true;
+}
+
+uint16_t ModbusIP::Hreg(uint16_t offset) {
+    auto it = hregs.find(offset);
+    return it == hregs.end() ? 0 : it->second;
+}
+
+bool ModbusIP::onRequest(cbRequest cb) {
+    requestCallback = cb;
+    return true;
+}
+
+bool ModbusIP::onRaw(cbRaw cb) {
+    rawCallback = cb;
+    return true;
+}
+
+uint16_t ModbusIP::setTransactionId(uint16_t id) {
+    responseTransactionId = id;
+    return id;
+}
+
+uint16_t ModbusIP::rawResponce(IPAddress ip, uint8_t *data, uint16_t length, uint8_t unit) {
+    // like the library, the response goes to the first client connected from ip
+    for (Peer &peer : serverPeers) {
+        if (peer.fd < 0 || peer.ip != ip) {
+            continue;
+        }
+        uint8_t response[MBAP_SIZE + 2 + 2 * MAX_READ_REGS];
+        if (length > sizeof(response) - MBAP_SIZE) {
+            return 0;
+        }
+        putWord(&response[0], responseTransactionId);
+        putWord(&response[2], 0);
+        putWord(&response[4], length + 1);
+        response[6] = unit;
+        memcpy(&response[MBAP_SIZE], data, length);
+        if (!sendAll(peer.fd, response, MBAP_SIZE + length)) {
+            closePeer(peer, true);
+            return 0;
+        }
+        return responseTransactionId;
+    }
+    return 0;
+}
+
+uint16_t ModbusIP::errorResponce(IPAddress ip, FunctionCode fc, ResultCode result, uint8_t unit) {
+    uint8_t pdu[2] = {(uint8_t)(fc | 0x80), (uint8_t)result};
+    return rawResponce(ip, pdu, sizeof(pdu), unit);
+}
+
+void ModbusIP::onRequestFrame(Peer &peer, const uint8_t *frame, uint16_t length) {
+    // the raw callback may take the request over, the library then sends nothing
+    if (rawCallback != nullptr) {
+        uint8_t pdu[sizeof(peer.rx)];
+        memcpy(pdu, &frame[MBAP_SIZE], length - MBAP_SIZE);
+        frame_arg_t header(frame[6], (uint32_t)peer.ip, getWord(&frame[0]), true);
+        ResultCode result = rawCallback(pdu, length - MBAP_SIZE, &header);
+        if (result != EX_PASSTHROUGH && result != EX_FORCE_PROCESS) {
+            return;
+        }
+    }
+
+    uint8_t response[MBAP_SIZE + 2 + 2 * MAX_READ_REGS];
+    memcpy(response, frame, MBAP_SIZE);
+    uint8_t *pdu = &response[MBAP_SIZE];
+    uint16_t pduLength;
+
+    FunctionCode fc = (FunctionCode)frame[MBAP_SIZE];
+    uint16_t offset = length >= MBAP_SIZE + 5 ? getWord(&frame[MBAP_SIZE + 1]) : 0;
+    uint16_t count = length >= MBAP_SIZE + 5 ? getWord(&frame[MBAP_SIZE + 3]) : 0;
+
+    ResultCode result = EX_SUCCESS;
+    if (requestCallback != nullptr) {
+        RequestData data = {{HREG, offset}, count, {NONE, 0}, 0, frame[6]};
+        result = requestCallback(fc, data);
+    }
+    if (result == EX_SUCCESS && fc != FC_READ_REGS) {
+        result = EX_ILLEGAL_FUNCTION;
+    }
+    if (result == EX_SUCCESS && (count == 0 || count > MAX_READ_REGS)) {
+        result = EX_ILLEGAL_VALUE;
+    }
+    for (uint16_t r = 0; result == EX_SUCCESS && r < count; r++) {
+        if (hregs.count(offset + r) == 0) {
+            result = EX_ILLEGAL_ADDRESS;
+        }
+    }
+
+    if (result == EX_SUCCESS) {
+        pdu[0] = fc;
+        pdu[1] = count * 2;
+        for (uint16_t r = 0; r < count; r++) {
+            putWord(&pdu[2 + 2 * r], hregs[offset + r]);
+        }
+        pduLength = 2 + count * 2;
+    } else {
+        pdu[0] = fc | 0x80;
+        pdu[1] = result;
+        pduLength = 2;
+    }
+
+    putWord(&response[4], pduLength + 1);
+    if (!sendAll(peer.fd, response, MBAP_SIZE + pduLength)) {
+        closePeer(peer, true);
+    }
+}
+
+// ### Task ###
+
+bool ModbusIP::receive(Peer &peer, bool isServer) {
+    while (true) {
+        ssize_t n = ::recv(peer.fd, &peer.rx[peer.rxLength], sizeof(peer.rx) - peer.rxLength, 0);
+        if (n == 0) {
+            return false;
+        }
+        if (n < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        peer.rxLength += n;
+
+        // handle all complete frames, keep a partial one for the next call
+        while (peer.rxLength >= MBAP_SIZE) {
+            uint16_t frameLength = 6 + getWord(&peer.rx[4]);
+            if (frameLength < MBAP_SIZE + 1 || frameLength > sizeof(peer.rx)) {
+                return false;
+            }
+            if (peer.rxLength < frameLength) {
+                break;
+            }
+
+            if (isServer) {
+                onRequestFrame(peer, peer.rx, frameLength);
+                if (peer.fd < 0) {
+                    return true;
+                }
+            } else {
+                onResponse(peer.rx, frameLength);
+            }
+            memmove(peer.rx, &peer.rx[frameLength], peer.rxLength - frameLength);
+            peer.rxLength -= frameLength;
+        }
+    }
+}
+
+void ModbusIP::closePeer(Peer &peer, bool isServer) {
+    ::close(peer.fd);
+    peer.fd = -1;
+    peer.rxLength = 0;
+
+    if (isServer) {
+        if (disconnectCallback != nullptr) {
+            disconnectCallback(peer.ip);
+        }
+        return;
+    }
+
+    // outstanding requests to this server will not be answered anymore
+    uint8_t i = 0;
+    while (i < transactionCount) {
+        if (transactions[i].ip == peer.ip) {
+            finish(i, EX_CONNECTION_LOST);
+        } else {
+            i++;
+        }
+    }
+}
+
+void ModbusIP::task() {
+    for (Peer &peer : clients) {
+        if (peer.fd >= 0 && !receive(peer, false)) {
+            closePeer(peer, false);
+        }
+    }
+
+    if (listenFd >= 0) {
+        sockaddr_in address = {};
+        socklen_t size = sizeof(address);
+        int fd = ::accept(listenFd, (sockaddr *)&address, &size);
+        if (fd >= 0) {
+            Peer *peer = nullptr;
+            for (Peer &candidate : serverPeers) {
+                if (candidate.fd < 0) {
+                    peer = &candidate;
+                    break;
+                }
+            }
+            IPAddress ip((uint32_t)address.sin_addr.s_addr);
+            if (peer == nullptr || (connectCallback != nullptr && !connectCallback(ip))) {
+                ::close(fd);
+            } else {
+                setNonBlocking(fd);
+                peer->fd = fd;
+                peer->ip = ip;
+                peer->rxLength = 0;
+            }
+        }
+    }
+    for (Peer &peer : serverPeers) {
+        if (peer.fd >= 0 && !receive(peer, true)) {
+            closePeer(peer, true);
+        }
+    }
+
+    // like the library, a transaction without response is reported after MODBUSIP_TIMEOUT
+    uint32_t now = millis();
+    uint8_t i = 0;
+    while (i < transactionCount) {
+        if (now - transactions[i].sentAt >= MODBUSIP_TIMEOUT) {
+            finish(i, EX_TIMEOUT);
+        } else {
+            i++;
+        }
+    }
+}
@@ -0,0 +1,176 @@
+#ifndef NATIVE_MODBUS_IP_ESP8266_H
+#define NATIVE_MODBUS_IP_ESP8266_H
+
+#include <Arduino.h>
+
+#include <map>
+
+#define MODBUSIP_PORT 502
+#define MODBUSIP_UNIT 255
+#ifndef MODBUSIP_TIMEOUT
+#define MODBUSIP_TIMEOUT 1000
+#endif
+#define MODBUSIP_MAX_TRANSACIONS 16
+#define MODBUSIP_MAX_CLIENTS 4
+
+class Modbus {
+   public:
+    enum ResultCode {
+        EX_SUCCESS = 0x00,
+        EX_ILLEGAL_FUNCTION = 0x01,
+        EX_ILLEGAL_ADDRESS = 0x02,
+        EX_ILLEGAL_VALUE = 0x03,
+        EX_SLAVE_FAILURE = 0x04,
+        EX_ACKNOWLEDGE = 0x05,
+        EX_SLAVE_DEVICE_BUSY = 0x06,
+        EX_MEMORY_PARITY_ERROR = 0x08,
+        EX_PATH_UNAVAILABLE = 0x0A,
+        EX_DEVICE_FAILED_TO_RESPOND = 0x0B,
+        EX_GENERAL_FAILURE = 0xE1,
+        EX_DATA_MISMACH = 0xE2,
+        EX_UNEXPECTED_RESPONSE = 0xE3,
+        EX_TIMEOUT = 0xE4,
+        EX_CONNECTION_LOST = 0xE5,
+        EX_CANCEL = 0xE6,
+        EX_PASSTHROUGH = 0xE7,
+        EX_FORCE_PROCESS = 0xE8
+    };
+
+    enum FunctionCode {
+        FC_READ_COILS = 0x01,
+        FC_READ_INPUT_STAT = 0x02,
+        FC_READ_REGS = 0x03,
+        FC_READ_INPUT_REGS = 0x04,
+        FC_WRITE_COIL = 0x05,
+        FC_WRITE_REG = 0x06,
+        FC_WRITE_COILS = 0x0F,
+        FC_WRITE_REGS = 0x10
+    };
+
+    enum TAddressType {
+        COIL,
+        ISTS,
+        IREG,
+        HREG,
+        NONE
+    };
+
+    struct TAddress {
+        TAddressType type;
+        uint16_t address;
+    };
+
+    struct RequestData {
+        TAddress reg;
+        uint16_t regCount;
+        TAddress regRead;
+        uint16_t regReadCount;
+        uint8_t unit;
+    };
+
+    // Header of a frame passed to the raw callback
+    struct frame_arg_t {
+        bool to_server;
+        uint8_t unitId;
+        uint32_t ipaddr;
+        uint16_t transactionId;
+
+        frame_arg_t(uint8_t u, uint32_t a, uint16_t t, bool ts = false) : to_server(ts), unitId(u), ipaddr(a), transactionId(t) {}
+    };
+};
+
+struct TRegister {
+    Modbus::TAddress address;
+    uint16_t value;
+};
+
+typedef bool (*cbTransaction)(Modbus::ResultCode event, uint16_t transactionId, void *data);
+typedef Modbus::ResultCode (*cbRequest)(Modbus::FunctionCode fc, const Modbus::RequestData data);
+typedef bool (*cbModbusConnect)(IPAddress ip);
+typedef Modbus::ResultCode (*cbRaw)(uint8_t *data, uint8_t length, void *custom);
+
+/**
+ * Modbus TCP client and server of the emelianov library on POSIX sockets.
+ * The client connects blocking and then works like the library: requests
+ * return a transaction ID, task() receives the responses and reports
+ * them, timeouts and lost connections through the transaction callback.
+ * The server answers holding register reads from its register map. A raw
+ * callback sees each request PDU first and may answer it later through
+ * setTransactionId() and rawResponce() like the library's bridge example.
+ */
+class ModbusIP : public Modbus {
+   public:
+    ~ModbusIP();
+
+    void client() {}
+    bool connect(IPAddress ip, uint16_t port = MODBUSIP_PORT);
+    bool disconnect(IPAddress ip);
+    bool isConnected(IPAddress ip);
+
+    uint16_t readHreg(IPAddress ip, uint16_t offset, uint16_t *value, uint16_t numregs = 1, cbTransaction cb = nullptr, uint8_t unit = MODBUSIP_UNIT);
+    bool isTransaction(uint16_t id);
+    void dropTransactions();
+
+    void server(uint16_t port = MODBUSIP_PORT);
+    bool addHreg(uint16_t offset, uint16_t value = 0, uint16_t numregs = 1);
+    bool removeHreg(uint16_t offset, uint16_t numregs = 1);
+    bool Hreg(uint16_t offset, uint16_t value);
+    uint16_t Hreg(uint16_t offset);
+    bool onRequest(cbRequest cb = nullptr);
+    void onConnect(cbModbusConnect cb = nullptr) { connectCallback = cb; }
+    void onDisconnect(cbModbusConnect cb = nullptr) { disconnectCallback = cb; }
+    bool onRaw(cbRaw cb = nullptr);
+    uint16_t setTransactionId(uint16_t id);
+    uint16_t rawResponce(IPAddress ip, uint8_t *data, uint16_t length, uint8_t unit = MODBUSIP_UNIT);
+    uint16_t errorResponce(IPAddress ip, FunctionCode fc, ResultCode result, uint8_t unit = MODBUSIP_UNIT);
+
+    // Receives responses and requests, reports timed out transactions
+    void task();
+
+   private:
+    // Connection to a server or of a client to our server
+    struct Peer {
+        int fd = -1;
+        IPAddress ip;
+        uint8_t rx[260];
+        uint16_t rxLength = 0;
+    };
+
+    // Request waiting for its response
+    struct Transaction {
+        uint16_t id;
+        IPAddress ip;
+        uint16_t *value;
+        uint16_t count;
+        cbTransaction cb;
+        uint32_t sentAt;
+    };
+
+    // Reads what arrived on a peer, returns false if the connection was closed
+    bool receive(Peer &peer, bool isServer);
+
+    // Handles one complete frame of a server response or a client request
+    void onResponse(const uint8_t *frame, uint16_t length);
+    void onRequestFrame(Peer &peer, const uint8_t *frame, uint16_t length);
+
+    // Reports and removes transaction i
+    void finish(uint8_t i, ResultCode result);
+
+    void closePeer(Peer &peer, bool isServer);
+
+    Peer clients[MODBUSIP_MAX_CLIENTS];
+    Transaction transactions[MODBUSIP_MAX_TRANSACIONS];
+    uint8_t transactionCount = 0;
+    uint16_t lastTransactionId = 0;
+
+    int listenFd = -1;
+    Peer serverPeers[MODBUSIP_MAX_CLIENTS];
+    std::map<uint16_t, uint16_t> hregs;
+    cbRequest requestCallback = nullptr;
+    cbRaw rawCallback = nullptr;
+    uint16_t responseTransactionId = 0;
+    cbModbusConnect connectCallback = nullptr;
+    cbModbusConnect disconnectCallback = nullptr;
+};
+
+#endif
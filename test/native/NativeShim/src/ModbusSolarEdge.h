@@ -0,0 +1,14 @@
+#ifndef NATIVE_MODBUS_SOLAR_EDGE_H
+#define NATIVE_MODBUS_SOLAR_EDGE_H
+
+#include <ModbusIP_ESP8266.h>
+
+// Protocol addresses of the SolarEdge helper library the register map is anchored to
+#define I_AC_POWER 40083
+#define I_AC_POWER_SF 40084
+#define M1_AC_POWER 40206
+#define M1_AC_POWER_SF 40210
+#define B1_INSTANTANEOUS_POWER 57716
+#define B1_STATE_OF_ENERGY_SOE 57732
+
+#endif
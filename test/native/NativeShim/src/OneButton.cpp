@@ -0,0 +1,109 @@
+#include "OneButton.h"
+
+OneButton::OneButton(int pin, bool activeLow, bool pullupActive) : pin(pin), pressedLevel(activeLow ? LOW : HIGH) {
+    pinMode(pin, pullupActive ? INPUT_PULLUP : INPUT);
+}
+
+void OneButton::attachDoubleClick(void (*callback)()) {
+    doubleClickFunc = callback;
+    maxClicks = max(maxClicks, 2);
+}
+
+void OneButton::attachMultiClick(void (*callback)()) {
+    multiClickFunc = callback;
+    maxClicks = max(maxClicks, 100);
+}
+
+void OneButton::tick() {
+    tick(digitalRead(pin) == pressedLevel);
+}
+
+void OneButton::tick(bool active) {
+    unsigned long now = millis();
+    unsigned long waitTime = now - startTime;
+
+    switch (state) {
+        case Init:
+            if (active) {
+                newState(Down);
+                startTime = now;
+                clicks = 0;
+            }
+            break;
+
+        case Down:
+            if (!active && waitTime < debounceTicks) {
+                newState(lastState);
+            } else if (!active) {
+                newState(Up);
+                startTime = now;
+            } else if (waitTime > pressTicks) {
+                if (longPressStartFunc != nullptr) {
+                    longPressStartFunc();
+                }
+                newState(Press);
+            }
+            break;
+
+        case Up:
+            if (active && waitTime < debounceTicks) {
+                newState(lastState);
+            } else if (waitTime >= debounceTicks) {
+                clicks++;
+                newState(Count);
+            }
+            break;
+
+        case Count:
+            if (active) {
+                newState(Down);
+                startTime = now;
+            } else if (waitTime > clickTicks || clicks == maxClicks) {
+                if (clicks == 1) {
+                    if (clickFunc != nullptr) {
+                        clickFunc();
+                    }
+                } else if (clicks == 2) {
+                    if (doubleClickFunc != nullptr) {
+                        doubleClickFunc();
+                    }
+                } else if (multiClickFunc != nullptr) {
+                    multiClickFunc();
+                }
+                reset();
+            }
+            break;
+
+        case Press:
+            if (!active) {
+                newState(PressEnd);
+                startTime = now;
+            } else if (duringLongPressFunc != nullptr) {
+                duringLongPressFunc();
+            }
+            break;
+
+        case PressEnd:
+            if (active && waitTime < debounceTicks) {
+                newState(lastState);
+            } else if (waitTime >= debounceTicks) {
+                if (longPressStopFunc != nullptr) {
+                    longPressStopFunc();
+                }
+                reset();
+            }
+            break;
+    }
+}
+
+void OneButton::reset() {
+    state = Init;
+    lastState = Init;
+    clicks = 0;
+    startTime = 0;
+}
+
+void OneButton::newState(State next) {
+    lastState = state;
+    state = next;
+}
@@ -0,0 +1,67 @@
+#ifndef NATIVE_ONE_BUTTON_H
+#define NATIVE_ONE_BUTTON_H
+
+#include <Arduino.h>
+
+/**
+ * Button state machine of the OneButton library, reading its pin with
+ * digitalRead(). Tests press the button with nativeSetPin() and call
+ * tick() while time passes.
+ */
+class OneButton {
+   public:
+    OneButton(int pin, bool activeLow = true, bool pullupActive = true);
+
+    void setDebounceTicks(int ticks) { debounceTicks = ticks; }
+    void setClickTicks(int ticks) { clickTicks = ticks; }
+    void setPressTicks(int ticks) { pressTicks = ticks; }
+
+    void attachClick(void (*callback)()) { clickFunc = callback; }
+    void attachDoubleClick(void (*callback)());
+    void attachMultiClick(void (*callback)());
+    void attachLongPressStart(void (*callback)()) { longPressStartFunc = callback; }
+    void attachLongPressStop(void (*callback)()) { longPressStopFunc = callback; }
+    void attachDuringLongPress(void (*callback)()) { duringLongPressFunc = callback; }
+
+    // Reads the pin and advances the state machine
+    void tick();
+    void tick(bool active);
+
+    void reset();
+    int getNumberClicks() const { return clicks; }
+    bool isIdle() const { return state == Init; }
+    bool isLongPressed() const { return state == Press; }
+
+   private:
+    enum State : uint8_t {
+        Init,
+        Down,
+        Up,
+        Count,
+        Press,
+        PressEnd
+    };
+
+    void newState(State next);
+
+    int pin;
+    int pressedLevel;
+    unsigned int debounceTicks = 50;
+    unsigned int clickTicks = 400;
+    unsigned int pressTicks = 800;
+
+    void (*clickFunc)() = nullptr;
+    void (*doubleClickFunc)() = nullptr;
+    void (*multiClickFunc)() = nullptr;
+    void (*longPressStartFunc)() = nullptr;
+    void (*longPressStopFunc)() = nullptr;
+    void (*duringLongPressFunc)() = nullptr;
+
+    State state = Init;
+    State lastState = Init;
+    unsigned long startTime = 0;
+    int clicks = 0;
+    int maxClicks = 1;
+};
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef NATIVE_PUB_SUB_CLIENT_H
+#define NATIVE_PUB_SUB_CLIENT_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+
+#define MQTT_DISCONNECTED -1
+
+/**
+ * MQTT client which never reaches a broker on the host, publishes fail
+ * and the monitor keeps its offline queue.
+ */
+class PubSubClient {
+   public:
+    PubSubClient() {}
+    PubSubClient(WiFiClient &client) {}
+
+    PubSubClient &setServer(const char *domain, uint16_t port) { return *this; }
+    PubSubClient &setServer(IPAddress ip, uint16_t port) { return *this; }
+    PubSubClient &setClient(WiFiClient &client) { return *this; }
+    PubSubClient &setKeepAlive(uint16_t keepAlive) { return *this; }
+    PubSubClient &setSocketTimeout(uint16_t timeout) { return *this; }
+    bool setBufferSize(uint16_t size) { return true; }
+
+    bool connect(const char *id) { return false; }
+    bool connect(const char *id, const char *user, const char *pass) { return false; }
+    bool connect(const char *id, const char *user, const char *pass, const char *willTopic, uint8_t willQos, bool willRetain, const char *willMessage) { return false; }
+    void disconnect() {}
+    bool connected() { return false; }
+    int state() { return MQTT_DISCONNECTED; }
+    bool loop() { return false; }
+
+    bool publish(const char *topic, const char *payload) { return false; }
+    bool publish(const char *topic, const char *payload, bool retained) { return false; }
+    bool publish(const char *topic, const uint8_t *payload, unsigned int length, bool retained) { return false; }
+};
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef NATIVE_SPI_H
+#define NATIVE_SPI_H
+
+// The display is connected via I2C, nothing of SPI is used
+
+#endif
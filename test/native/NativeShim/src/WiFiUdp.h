@@ -0,0 +1,6 @@
+#ifndef NATIVE_WIFI_UDP_H
+#define NATIVE_WIFI_UDP_H
+
+// UDP is not used by the monitor
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef NATIVE_WIRE_H
+#define NATIVE_WIRE_H
+
+#include <Arduino.h>
+
+// Size of the transmit buffer of the ESP8266 Wire library
+#define BUFFER_LENGTH 128
+
+/**
+ * I2C bus which only counts what would be sent, so benchmarks can report
+ * the bytes put on the bus per frame.
+ */
+class TwoWire : public Stream {
+   public:
+    void begin() {}
+    void begin(int sda, int scl) {}
+    void setClock(uint32_t frequency) { clock = frequency; }
+
+    void beginTransmission(uint8_t address) { transmissionCount++; }
+    uint8_t endTransmission(bool stop = true) { return 0; }
+    size_t write(uint8_t c) override {
+        byteCount++;
+        return 1;
+    }
+    size_t write(const uint8_t *buffer, size_t size) override {
+        byteCount += size;
+        return size;
+    }
+    using Print::write;
+
+    // Host only: bytes written since the last resetCounters(), without address bytes
+    uint32_t bytesWritten() const { return byteCount; }
+
+    // Host only: transmissions started since the last resetCounters()
+    uint32_t transmissions() const { return transmissionCount; }
+
+    // Host only: current bus clock
+    uint32_t getClock() const { return clock; }
+
+    void resetCounters() {
+        byteCount = 0;
+        transmissionCount = 0;
+    }
+
+   private:
+    uint32_t byteCount = 0;
+    uint32_t transmissionCount = 0;
+    uint32_t clock = 100000;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef NATIVE_GFXFONT_H
+#define NATIVE_GFXFONT_H
+
+#include <Arduino.h>
+
+// Glyph of a custom font, bitmap rows packed MSB first relative to the baseline, as in the real library
+typedef struct {
+    uint16_t bitmapOffset;
+    uint8_t width;
+    uint8_t height;
+    uint8_t xAdvance;
+    int8_t xOffset;
+    int8_t yOffset;
+} GFXglyph;
+
+// Custom font with the glyphs of first..last, as in the real library
+typedef struct {
+    uint8_t *bitmap;
+    GFXglyph *glyph;
+    uint16_t first;
+    uint16_t last;
+    uint8_t yAdvance;
+} GFXfont;
+
+#endif
@@ -0,0 +1,323 @@
+#include "SunSpecSimulator.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// MBAP header: transaction, protocol, length, unit
+static const uint8_t MBAP_SIZE = 7;
+
+// Connections served at the same time
+static const uint8_t MAX_SIMULATOR_CLIENTS = 4;
+
+// Start of the SunSpec model chain
+static const uint16_t SUNSPEC_BASE = 40000;
+
+// Lengths of the models without ID and length register
+static const uint16_t COMMON_MODEL_LENGTH = 65;
+static const uint16_t INVERTER_MODEL_LENGTH = 50;
+static const uint16_t METER_MODEL_LENGTH = 105;
+
+// Size of the SolarEdge battery info block
+static const uint16_t BATTERY_BLOCK_LENGTH = 0x90;
+
+// Smallest SunSpec scale factor down to -2 that still fits the value into an int16
+static int16_t fittingScaleFactor(int32_t watts, int32_t &scale) {
+    int16_t sf = -2;
+    scale = 100;
+    while (sf < 0 && abs(watts) * scale > INT16_MAX) {
+        sf++;
+        scale /= 10;
+    }
+    return sf;
+}
+
+SunSpecSimulator::SunSpecSimulator(const SimulatorProfile &profile) : current(profile), dice(1) {
+    layout(profile);
+}
+
+SunSpecSimulator::~SunSpecSimulator() {
+    stop();
+}
+
+bool SunSpecSimulator::start(uint16_t port) {
+    listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        return false;
+    }
+
+    int one = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t size = sizeof(address);
+    if (::bind(listenFd, (sockaddr *)&address, size) != 0 || ::listen(listenFd, MAX_SIMULATOR_CLIENTS) != 0 ||
+        ::getsockname(listenFd, (sockaddr *)&address, &size) != 0) {
+        ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    listenPort = ntohs(address.sin_port);
+
+    running = true;
+    worker = std::thread(&SunSpecSimulator::run, this);
+    return true;
+}
+
+void SunSpecSimulator::stop() {
+    if (!running) {
+        return;
+    }
+    running = false;
+    worker.join();
+    ::close(listenFd);
+    listenFd = -1;
+}
+
+void SunSpecSimulator::setProfile(const SimulatorProfile &profile) {
+    std::lock_guard<std::mutex> guard(lock);
+    current = profile;
+    layout(profile);
+}
+
+uint16_t SunSpecSimulator::reg(uint16_t address) {
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = registers.find(address);
+    return it == registers.end() ? 0 : it->second;
+}
+
+// ### Register map ###
+
+void SunSpecSimulator::layout(const SimulatorProfile &profile) {
+    registers.clear();
+
+    // model chain: "SunS", common, inverter, common of meter 1, meter 1, end marker
+    uint16_t inverterBase = DEFAULT_BLOCK_BASES.base[InverterBlock];
+    uint16_t meterBase = DEFAULT_BLOCK_BASES.base[Meter1Block];
+    uint16_t meterCommonBase = inverterBase + 2 + INVERTER_MODEL_LENGTH;
+    uint16_t endBase = meterBase + 2 + METER_MODEL_LENGTH;
+
+    for (uint16_t a = SUNSPEC_BASE; a < endBase + 2; a++) {
+        registers[a] = 0;
+    }
+    registers[SUNSPEC_BASE] = 0x5375;  // "Su"
+    registers[SUNSPEC_BASE + 1] = 0x6e53;  // "nS"
+    registers[SUNSPEC_BASE + 2] = 1;
+    registers[SUNSPEC_BASE + 3] = COMMON_MODEL_LENGTH;
+    registers[inverterBase] = 103;
+    registers[inverterBase + 1] = INVERTER_MODEL_LENGTH;
+    registers[meterCommonBase] = 1;
+    registers[meterCommonBase + 1] = COMMON_MODEL_LENGTH;
+    registers[meterBase] = 203;
+    registers[meterBase + 1] = METER_MODEL_LENGTH;
+    registers[endBase] = 0xFFFF;
+
+    // SolarEdge inverters scale with small negative factors, the magnitude decides
+    int32_t inverterScale;
+    int32_t meterScale;
+    int16_t inverterSf = fittingScaleFactor(profile.inverterPowerW, inverterScale);
+    int16_t meterSf = fittingScaleFactor(profile.meterPowerW, meterScale);
+
+    setInt16(fieldAddress(F_I_AC_VOLTAGE_AN), 2305);
+    setInt16(fieldAddress(F_I_AC_VOLTAGE_SF), -1);
+    setInt16(fieldAddress(F_I_AC_POWER), profile.inverterPowerW * inverterScale);
+    setInt16(fieldAddress(F_I_AC_POWER_SF), inverterSf);
+    setAcc32(fieldAddress(F_I_AC_ENERGY_WH), 12345678);
+    setInt16(fieldAddress(F_I_AC_ENERGY_WH_SF), 0);
+    setInt16(fieldAddress(F_I_DC_POWER), (profile.inverterPowerW + profile.inverterPowerW / 50) * inverterScale);
+    setInt16(fieldAddress(F_I_DC_POWER_SF), inverterSf);
+    setInt16(fieldAddress(F_I_STATUS), profile.inverterPowerW > 0 ? 4 : 2);  // MPPT or sleeping
+
+    setInt16(fieldAddress(F_M1_AC_POWER), profile.meterPowerW * meterScale);
+    setInt16(fieldAddress(F_M1_AC_POWER_SF), meterSf);
+    setAcc32(fieldAddress(F_M1_EXPORTED_WH), 2345678);
+    setAcc32(fieldAddress(F_M1_IMPORTED_WH), 3456789);
+    setInt16(fieldAddress(F_M1_ENERGY_WH_SF), 0);
+
+    // the battery block exists without a battery, filled with 0
+    uint16_t batteryBase = DEFAULT_BLOCK_BASES.base[Battery1Block];
+    for (uint16_t a = batteryBase; a < batteryBase + BATTERY_BLOCK_LENGTH; a++) {
+        registers[a] = 0;
+    }
+    if (profile.ratedEnergyWh > 0) {
+        registers[batteryBase] = 0x4259;  // manufacturer "BYD"
+        registers[batteryBase + 1] = 0x4400;
+        setFloat32Le(fieldAddress(F_B1_RATED_ENERGY), profile.ratedEnergyWh);
+        setFloat32Le(fieldAddress(F_B1_MAX_CHARGE_POWER), profile.maxChargePowerW);
+        setFloat32Le(fieldAddress(F_B1_MAX_DISCHARGE_POWER), profile.maxDischargePowerW);
+        setFloat32Le(fieldAddress(F_B1_INSTANTANEOUS_POWER), profile.batteryPowerW);
+        setFloat32Le(fieldAddress(F_B1_STATE_OF_ENERGY), profile.stateOfEnergyPercent);
+        setUint32Le(fieldAddress(F_B1_STATUS), profile.batteryPowerW > 0 ? 3 : 4);  // charging or discharging
+    }
+}
+
+void SunSpecSimulator::setAcc32(uint16_t address, uint32_t value) {
+    registers[address] = value >> 16;
+    registers[address + 1] = value & 0xffff;
+}
+
+void SunSpecSimulator::setFloat32Le(uint16_t address, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    setUint32Le(address, bits);
+}
+
+void SunSpecSimulator::setUint32Le(uint16_t address, uint32_t value) {
+    registers[address] = value & 0xffff;
+    registers[address + 1] = value >> 16;
+}
+
+// ### Server ###
+
+std::vector<uint8_t> SunSpecSimulator::respond(const uint8_t *frame, uint16_t length, uint32_t &delayMillis) {
+    std::lock_guard<std::mutex> guard(lock);
+    requestCount++;
+
+    uint32_t roll = dice() % 100;
+    int32_t jitter = current.jitterMillis == 0 ? 0 : (int32_t)(dice() % (2 * current.jitterMillis + 1)) - (int32_t)current.jitterMillis;
+    delayMillis = max<int32_t>((int32_t)current.latencyMillis + jitter, 0);
+
+    if (roll < current.dropPercent) {
+        dropCount++;
+        return {};
+    }
+
+    std::vector<uint8_t> response(frame, frame + MBAP_SIZE);
+    uint8_t fc = frame[MBAP_SIZE];
+    uint16_t start = length >= MBAP_SIZE + 5 ? frame[MBAP_SIZE + 1] << 8 | frame[MBAP_SIZE + 2] : 0;
+    uint16_t count = length >= MBAP_SIZE + 5 ? frame[MBAP_SIZE + 3] << 8 | frame[MBAP_SIZE + 4] : 0;
+
+    uint8_t exception = 0;
+    if (roll < current.dropPercent + current.busyPercent) {
+        exception = Modbus::EX_SLAVE_DEVICE_BUSY;
+        busyCount++;
+    } else if (fc != Modbus::FC_READ_REGS) {
+        exception = Modbus::EX_ILLEGAL_FUNCTION;
+    } else if (count == 0 || count > MAX_BLOCK_REGS) {
+        exception = Modbus::EX_ILLEGAL_VALUE;
+    } else {
+        for (uint16_t r = 0; r < count; r++) {
+            if (registers.count(start + r) == 0) {
+                exception = Modbus::EX_ILLEGAL_ADDRESS;
+                break;
+            }
+        }
+    }
+
+    if (exception != 0) {
+        response.push_back(fc | 0x80);
+        response.push_back(exception);
+    } else {
+        response.push_back(fc);
+        response.push_back(count * 2);
+        for (uint16_t r = 0; r < count; r++) {
+            uint16_t value = registers[start + r];
+            response.push_back(value >> 8);
+            response.push_back(value & 0xff);
+        }
+        answerCount++;
+    }
+
+    uint16_t mbapLength = response.size() - 6;
+    response[4] = mbapLength >> 8;
+    response[5] = mbapLength & 0xff;
+    return response;
+}
+
+void SunSpecSimulator::run() {
+    pollfd fds[1 + MAX_SIMULATOR_CLIENTS];
+    uint8_t rx[MAX_SIMULATOR_CLIENTS][260];
+    uint16_t rxLength[MAX_SIMULATOR_CLIENTS] = {};
+
+    fds[0] = {listenFd, POLLIN, 0};
+    for (uint8_t c = 0; c < MAX_SIMULATOR_CLIENTS; c++) {
+        fds[1 + c] = {-1, POLLIN, 0};
+    }
+
+    while (running) {
+        // sleep until the next response is due, wake up regularly to notice stop()
+        uint32_t now = millis();
+        int timeout = 10;
+        for (const Pending &p : pending) {
+            timeout = min<int>(timeout, p.dueMillis > now ? p.dueMillis - now : 0);
+        }
+        ::poll(fds, 1 + MAX_SIMULATOR_CLIENTS, timeout);
+
+        if (fds[0].revents & POLLIN) {
+            int fd = ::accept(listenFd, nullptr, nullptr);
+            uint8_t c = 0;
+            while (c < MAX_SIMULATOR_CLIENTS && fds[1 + c].fd >= 0) {
+                c++;
+            }
+            if (fd >= 0 && c < MAX_SIMULATOR_CLIENTS) {
+                int one = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                fds[1 + c].fd = fd;
+                rxLength[c] = 0;
+            } else if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+
+        for (uint8_t c = 0; c < MAX_SIMULATOR_CLIENTS; c++) {
+            pollfd &client = fds[1 + c];
+            if (client.fd < 0 || (client.revents & (POLLIN | POLLHUP | POLLERR)) == 0) {
+                continue;
+            }
+
+            ssize_t n = ::recv(client.fd, &rx[c][rxLength[c]], sizeof(rx[c]) - rxLength[c], 0);
+            if (n <= 0) {
+                ::close(client.fd);
+                for (Pending &p : pending) {
+                    p.fd = p.fd == client.fd ? -1 : p.fd;
+                }
+                client.fd = -1;
+                continue;
+            }
+            rxLength[c] += n;
+
+            while (rxLength[c] >= MBAP_SIZE) {
+                uint16_t frameLength = 6 + (rx[c][4] << 8 | rx[c][5]);
+                if (rxLength[c] < frameLength) {
+                    break;
+                }
+
+                uint32_t delayMillis;
+                std::vector<uint8_t> response = respond(rx[c], frameLength, delayMillis);
+                if (!response.empty()) {
+                    pending.push_back({client.fd, (uint32_t)millis() + delayMillis, std::move(response)});
+                }
+
+                memmove(rx[c], &rx[c][frameLength], rxLength[c] - frameLength);
+                rxLength[c] -= frameLength;
+            }
+        }
+
+        now = millis();
+        for (auto it = pending.begin(); it != pending.end();) {
+            if ((int32_t)(now - it->dueMillis) < 0) {
+                ++it;
+                continue;
+            }
+            if (it->fd >= 0) {
+                ::send(it->fd, it->frame.data(), it->frame.size(), MSG_NOSIGNAL);
+            }
+            it = pending.erase(it);
+        }
+    }
+
+    for (uint8_t c = 0; c < MAX_SIMULATOR_CLIENTS; c++) {
+        if (fds[1 + c].fd >= 0) {
+            ::close(fds[1 + c].fd);
+        }
+    }
+    pending.clear();
+}
@@ -0,0 +1,124 @@
+#ifndef SUNSPEC_SIMULATOR_H
+#define SUNSPEC_SIMULATOR_H
+
+#include <Arduino.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "SunSpecRegisters.h"
+
+// Values and link behaviour served by the simulator
+struct SimulatorProfile {
+    const char *name;
+
+    // inverter AC power and meter 1 power, meter positive = export
+    int32_t inverterPowerW;
+    int32_t meterPowerW;
+
+    // battery 1, positive = charging, 0 rated energy = no battery
+    float batteryPowerW;
+    float stateOfEnergyPercent;
+    float ratedEnergyWh;
+    float maxChargePowerW;
+    float maxDischargePowerW;
+
+    // response delay: latency +- jitter, uniformly distributed
+    uint32_t latencyMillis;
+    uint32_t jitterMillis;
+
+    // share of requests which are not answered at all or rejected as busy
+    uint8_t dropPercent;
+    uint8_t busyPercent;
+};
+
+// Midday with export and a charging battery, fast link
+constexpr SimulatorProfile PROFILE_SUNNY_NOON = {"sunny noon", 6000, 1500, 600.0f, 60.0f, 10000.0f, 5000.0f, 5000.0f, 2, 1, 0, 0};
+
+// Night with import and a discharging battery
+constexpr SimulatorProfile PROFILE_NIGHT = {"night", 0, -800, -450.0f, 35.5f, 10000.0f, 5000.0f, 5000.0f, 2, 1, 0, 0};
+
+// Inverter without battery behind a slow WiFi link
+constexpr SimulatorProfile PROFILE_SLOW_LINK = {"slow link", 3200, 200, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 40, 20, 0, 0};
+
+// Lost and busy rejected requests, exercises the retries
+constexpr SimulatorProfile PROFILE_FLAKY = {"flaky", 4500, -300, -1200.0f, 80.0f, 10000.0f, 5000.0f, 5000.0f, 5, 5, 10, 10};
+
+/**
+ * SolarEdge inverter with meter 1 and battery 1 as a Modbus TCP server on
+ * the loopback interface. Registers are laid out like on the inverter:
+ * the SunSpec model chain from 40000 (common, inverter 103, common, meter
+ * 203) and the SolarEdge battery info block, field positions taken from
+ * SUNSPEC_REGISTERS. Requests are answered from a thread after the
+ * profile's latency and jitter, so responses may arrive out of order.
+ */
+class SunSpecSimulator {
+   public:
+    explicit SunSpecSimulator(const SimulatorProfile &profile = PROFILE_SUNNY_NOON);
+    ~SunSpecSimulator();
+
+    // Listens on 127.0.0.1, port 0 picks a free port, returns false if the socket failed
+    bool start(uint16_t port = 0);
+
+    // Closes the listener and all connections
+    void stop();
+
+    // Port the simulator listens on
+    uint16_t port() const { return listenPort; }
+
+    // Replaces values and link behaviour, applies to following requests
+    void setProfile(const SimulatorProfile &profile);
+
+    // Value of a register, 0 if it does not exist
+    uint16_t reg(uint16_t address);
+
+    // Requests received, answered, dropped and rejected as busy since start
+    uint32_t requests() const { return requestCount; }
+    uint32_t answered() const { return answerCount; }
+    uint32_t dropped() const { return dropCount; }
+    uint32_t rejected() const { return busyCount; }
+
+   private:
+    // Response waiting for its delay to pass
+    struct Pending {
+        int fd;
+        uint32_t dueMillis;
+        std::vector<uint8_t> frame;
+    };
+
+    // Fills the register map from the profile, caller holds the lock
+    void layout(const SimulatorProfile &profile);
+
+    void setInt16(uint16_t address, int16_t value) { registers[address] = (uint16_t)value; }
+    void setAcc32(uint16_t address, uint32_t value);
+    void setFloat32Le(uint16_t address, float value);
+    void setUint32Le(uint16_t address, uint32_t value);
+
+    // Thread: accepts clients, reads requests, sends due responses
+    void run();
+
+    // Builds the response to a request frame and its delay, empty if it is dropped
+    std::vector<uint8_t> respond(const uint8_t *frame, uint16_t length, uint32_t &delayMillis);
+
+    std::mutex lock;
+    SimulatorProfile current;
+    std::map<uint16_t, uint16_t> registers;
+    std::mt19937 dice;
+
+    int listenFd = -1;
+    uint16_t listenPort = 0;
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::vector<Pending> pending;
+
+    std::atomic<uint32_t> requestCount{0};
+    std::atomic<uint32_t> answerCount{0};
+    std::atomic<uint32_t> dropCount{0};
+    std::atomic<uint32_t> busyCount{0};
+};
+
+#endif
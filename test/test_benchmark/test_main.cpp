@@ -0,0 +1,445 @@
+#include <Adafruit_SSD1306.h>
+#include <Arduino.h>
+#include <Wire.h>
+#include <unity.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "DisplayFlusher.h"
+#include "FlowAnimator.h"
+#include "LayoutCache.h"
+#include "PageBlitter.h"
+#include "RegisterMirror.h"
+#include "SolarSite.h"
+#include "SolarSnapshot.h"
+#include "SunSpecSimulator.h"
+
+// Display and polling path of the monitor
+extern Adafruit_SSD1306 display;
+extern DisplayFlusher flusher;
+extern PageBlitter blitter;
+extern SolarSite site;
+extern RegisterMirror mirror;
+void printStateScreen1(const SolarSnapshot &snapshot, boolean stale);
+extern FlowAnimator animator;
+void animateFrame(boolean full);
+
+// Poll cycles measured per profile
+const int BENCHMARK_CYCLES = 200;
+
+// Poll cycles against the flaky profile, every lost request costs a timeout
+const int FLAKY_CYCLES = 50;
+
+// Frames composed for the display benchmark
+const int BENCHMARK_FRAMES = 500;
+
+// Animation frames measured, one per ANIMATION_FRAME_MILLIS
+const int ANIMATION_FRAMES = 50;
+
+// Bound of a single poll cycle before the benchmark gives up
+const unsigned long CYCLE_LIMIT_MILLIS = 5000;
+
+// Port of the monitor's Modbus server in the mirror test
+const uint16_t MIRROR_PORT = 15020;
+
+SunSpecSimulator simulator;
+
+// Further monitors which boot with the layout cache left by the first
+SolarSite rebooted;
+SolarSite rebootedWithoutMeter;
+SolarSite rebootedWithoutBattery;
+
+// Site driven by runCycle()
+SolarSite *polled = &site;
+
+// Set by the cycle callback
+bool cycleDone;
+bool cycleOk;
+
+// Set by the transaction callback of a client of the mirror
+bool mirrorReadDone;
+Modbus::ResultCode mirrorReadResult;
+
+// Results of one benchmark run
+struct PollStats {
+    std::vector<unsigned long> cycleMicros;
+    uint32_t requests;
+    uint32_t retries;
+    int succeeded;
+};
+
+void onCycle(ReadPlanner &plan, bool success) {
+    if (polled->finish(plan, success)) {
+        cycleDone = true;
+        cycleOk = polled->cycleSucceeded();
+    }
+}
+
+// Runs one cycle to completion, returns false if it could not be submitted or did not finish
+bool runCycle() {
+    cycleDone = false;
+    if (!polled->submit(onCycle)) {
+        return false;
+    }
+
+    unsigned long start = millis();
+    while (!cycleDone && millis() - start < CYCLE_LIMIT_MILLIS) {
+        polled->task();
+    }
+    return cycleDone;
+}
+
+bool onMirrorRead(Modbus::ResultCode event, uint16_t, void *) {
+    mirrorReadDone = true;
+    mirrorReadResult = event;
+    return true;
+}
+
+// Reads count registers from first through the mirror like a client of the monitor, returns the result
+Modbus::ResultCode readMirror(ModbusIP &client, uint16_t first, uint16_t *values, uint16_t count) {
+    mirrorReadDone = false;
+    TEST_ASSERT_NOT_EQUAL(0, client.readHreg(IPAddress(127, 0, 0, 1), first, values, count, onMirrorRead, 1));
+
+    unsigned long start = millis();
+    while (!mirrorReadDone && millis() - start < CYCLE_LIMIT_MILLIS) {
+        client.task();
+        mirror.task(true);
+        site.task();
+    }
+    TEST_ASSERT_TRUE_MESSAGE(mirrorReadDone, "mirror read did not finish");
+    return mirrorReadResult;
+}
+
+// Reads the metadata of the current profile, then measures cycles usage polls
+PollStats poll(const SimulatorProfile &profile, int cycles) {
+    simulator.setProfile(profile);
+    site.invalidate();
+    TEST_ASSERT_TRUE_MESSAGE(runCycle() && cycleOk, "metadata cycle failed");
+    TEST_ASSERT_TRUE(site.metadataValid());
+
+    PollStats stats = {};
+    uint32_t requestsBefore = site.requests();
+    uint32_t retriesBefore = site.retries();
+
+    for (int i = 0; i < cycles; i++) {
+        unsigned long start = micros();
+        TEST_ASSERT_TRUE_MESSAGE(runCycle(), "poll cycle did not finish");
+        stats.cycleMicros.push_back(micros() - start);
+        stats.succeeded += cycleOk ? 1 : 0;
+    }
+
+    stats.requests = site.requests() - requestsBefore;
+    stats.retries = site.retries() - retriesBefore;
+    return stats;
+}
+
+// Percentile p (0..100) of the sorted cycle times
+unsigned long percentile(std::vector<unsigned long> sorted, int p) {
+    std::sort(sorted.begin(), sorted.end());
+    return sorted[(sorted.size() - 1) * p / 100];
+}
+
+void report(const SimulatorProfile &profile, const PollStats &stats) {
+    int cycles = stats.cycleMicros.size();
+    printf("[%s] %d cycles, latency %ld +- %ld ms\n", profile.name, cycles, (long)profile.latencyMillis, (long)profile.jitterMillis);
+    printf("  poll cycle latency us: p50 %lu, p95 %lu, max %lu\n",
+           percentile(stats.cycleMicros, 50), percentile(stats.cycleMicros, 95), percentile(stats.cycleMicros, 100));
+    printf("  transactions per cycle: %.2f (retries %lu), succeeded %d\n",
+           (double)stats.requests / cycles, (unsigned long)stats.retries, stats.succeeded);
+}
+
+void assertTotals(milliwatt_t inverter, milliwatt_t meter, milliwatt_t battery, decipercent_t soe) {
+    SolarSnapshot snapshot = {};
+    site.aggregate(snapshot);
+    TEST_ASSERT_EQUAL_INT32(inverter, snapshot.inverterPower);
+    TEST_ASSERT_EQUAL_INT32(meter, snapshot.meterPower);
+    TEST_ASSERT_EQUAL_INT32(battery, snapshot.batteryPower);
+    TEST_ASSERT_EQUAL_INT32(soe, snapshot.batteryStateOfEnergy);
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_layout_discovery() {
+    simulator.setProfile(PROFILE_SUNNY_NOON);
+    site.invalidate();
+    uint32_t requestsBefore = simulator.requests();
+    TEST_ASSERT_TRUE_MESSAGE(runCycle() && cycleOk, "discovery cycle failed");
+
+    // marker with the common header, inverter, meter common, meter, end marker, two battery probes, then the metadata
+    uint32_t metadataReads = planFields(metadataFields(0x01, 0x01)).blockCount;
+    printf("[discovery] %lu reads including the metadata\n", (unsigned long)(simulator.requests() - requestsBefore));
+    TEST_ASSERT_EQUAL_UINT32(7 + metadataReads, simulator.requests() - requestsBefore);
+    TEST_ASSERT_EQUAL_UINT32(1, site.discoveries());
+    TEST_ASSERT_EQUAL_MEMORY(&DEFAULT_BLOCK_BASES, &site.leaderBases(), sizeof(BlockBases));
+    TEST_ASSERT_EQUAL_UINT32(1, site.layoutCache().writes());
+
+    // after a reconnect the end of the chain and the metadata read validate the layout, no second walk
+    site.invalidate();
+    requestsBefore = simulator.requests();
+    TEST_ASSERT_TRUE(runCycle() && cycleOk);
+    TEST_ASSERT_EQUAL_UINT32(1 + metadataReads, simulator.requests() - requestsBefore);
+    TEST_ASSERT_EQUAL_UINT32(1, site.discoveries());
+}
+
+// Stores a stale layout of the simulator, boots target with it and runs its metadata cycle, returns false if the cycle failed
+bool bootWithStaleLayout(SolarSite &target, DeviceLayout stale) {
+    LayoutCache cache;
+    ModelDiscovery::seal(stale);
+    TEST_ASSERT_TRUE(cache.begin());
+    TEST_ASSERT_TRUE(cache.store(IPAddress(127, 0, 0, 1), simulator.port(), 1, 0x01, 0x01, stale));
+
+    target.addDevice({IPAddress(127, 0, 0, 1), simulator.port(), 1, 0x01, 0x01});
+    target.begin();
+    TEST_ASSERT_TRUE(target.hasLayout(0));
+    TEST_ASSERT_EQUAL_UINT8(1, target.connect());
+
+    polled = &target;
+    bool ok = runCycle() && cycleOk;
+    polled = &site;
+    target.cancel();
+    return ok;
+}
+
+// Layout of the simulator as discovered by the first monitor
+DeviceLayout cachedLayout() {
+    LayoutCache cache;
+    DeviceLayout layout = {};
+    TEST_ASSERT_TRUE(cache.begin());
+    TEST_ASSERT_TRUE(cache.find(IPAddress(127, 0, 0, 1), simulator.port(), 1, 0x01, 0x01, layout));
+    return layout;
+}
+
+void test_layout_cache_rediscovers_on_mismatch() {
+    // the cached meter model disagrees with the inverter, e.g. after a meter was replaced
+    DeviceLayout stale = cachedLayout();
+    stale.meterModel[0] = 201;
+
+    // the metadata read finds model 203 and walks the chain again within the same cycle
+    TEST_ASSERT_TRUE_MESSAGE(bootWithStaleLayout(rebooted, stale), "metadata cycle with a stale layout failed");
+    TEST_ASSERT_EQUAL_UINT32(1, rebooted.discoveries());
+    TEST_ASSERT_TRUE(rebooted.metadataValid());
+    TEST_ASSERT_EQUAL_UINT16(203, cachedLayout().meterModel[0]);
+
+    // a layout is only found for the meters and batteries it was discovered with
+    LayoutCache cache;
+    DeviceLayout other;
+    TEST_ASSERT_TRUE(cache.begin());
+    TEST_ASSERT_FALSE(cache.find(IPAddress(127, 0, 0, 1), simulator.port(), 1, 0x01, 0x03, other));
+}
+
+void test_layout_check_finds_added_equipment() {
+    // the chain ended before the meter, e.g. the meter was installed after the walk
+    DeviceLayout withoutMeter = cachedLayout();
+    withoutMeter.meters = 0;
+    withoutMeter.meterModel[0] = 0;
+    withoutMeter.chainEnd = withoutMeter.bases.base[Meter1Block];
+    TEST_ASSERT_TRUE_MESSAGE(bootWithStaleLayout(rebootedWithoutMeter, withoutMeter), "metadata cycle without meter failed");
+    TEST_ASSERT_EQUAL_UINT32(1, rebootedWithoutMeter.discoveries());
+    TEST_ASSERT_EQUAL_UINT8(0x01, cachedLayout().meters);
+
+    // the configured battery was not there at the walk
+    DeviceLayout withoutBattery = cachedLayout();
+    withoutBattery.batteries = 0;
+    TEST_ASSERT_TRUE_MESSAGE(bootWithStaleLayout(rebootedWithoutBattery, withoutBattery), "metadata cycle without battery failed");
+    TEST_ASSERT_EQUAL_UINT32(1, rebootedWithoutBattery.discoveries());
+    TEST_ASSERT_EQUAL_UINT8(0x01, cachedLayout().batteries);
+}
+
+void test_poll_sunny_noon() {
+    PollStats stats = poll(PROFILE_SUNNY_NOON, BENCHMARK_CYCLES);
+    report(PROFILE_SUNNY_NOON, stats);
+
+    // inverter, M1 and B1: one read per block
+    TEST_ASSERT_EQUAL_INT(BENCHMARK_CYCLES, stats.succeeded);
+    TEST_ASSERT_EQUAL_UINT32(3 * BENCHMARK_CYCLES, stats.requests);
+    assertTotals(6000000, 1500000, 600000, 600);
+}
+
+void test_poll_night() {
+    PollStats stats = poll(PROFILE_NIGHT, BENCHMARK_CYCLES);
+    report(PROFILE_NIGHT, stats);
+
+    TEST_ASSERT_EQUAL_INT(BENCHMARK_CYCLES, stats.succeeded);
+    assertTotals(0, -800000, -450000, 355);
+}
+
+void test_mirror_waits_for_outdated_range() {
+    poll(PROFILE_SUNNY_NOON, 1);
+    mirror.begin(MIRROR_PORT, DEFAULT_MIRROR_MAX_AGE_MILLIS, site.leaderBases());
+    ModbusIP client;
+    TEST_ASSERT_TRUE(client.connect(IPAddress(127, 0, 0, 1), MIRROR_PORT));
+
+    // the inverter model was never fetched, the read is answered after one upstream read instead of "busy"
+    uint16_t inverter = site.leaderBases().base[InverterBlock];
+    uint16_t values[52] = {};
+    TEST_ASSERT_EQUAL_INT(Modbus::EX_SUCCESS, readMirror(client, inverter, values, 52));
+    TEST_ASSERT_EQUAL_UINT16(103, values[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, mirror.fetches());
+    TEST_ASSERT_EQUAL_UINT32(1, mirror.misses());
+
+    // the next read comes from the cache
+    TEST_ASSERT_EQUAL_INT(Modbus::EX_SUCCESS, readMirror(client, inverter, values, 2));
+    TEST_ASSERT_EQUAL_UINT32(1, mirror.fetches());
+    TEST_ASSERT_EQUAL_UINT32(1, mirror.hits());
+
+    // outside of the ranges
+    TEST_ASSERT_EQUAL_INT(Modbus::EX_ILLEGAL_ADDRESS, readMirror(client, inverter + 50, values, 4));
+}
+
+void test_poll_slow_link_is_pipelined() {
+    PollStats stats = poll(PROFILE_SLOW_LINK, BENCHMARK_CYCLES / 4);
+    report(PROFILE_SLOW_LINK, stats);
+
+    // the three reads are in flight together: a cycle takes the slowest round trip, not the sum
+    TEST_ASSERT_EQUAL_INT(BENCHMARK_CYCLES / 4, stats.succeeded);
+    unsigned long bound = (PROFILE_SLOW_LINK.latencyMillis + PROFILE_SLOW_LINK.jitterMillis) * 1000 + 10000;
+    TEST_ASSERT_LESS_THAN_UINT32(bound, percentile(stats.cycleMicros, 95));
+}
+
+void test_poll_follows_changed_scale_factor() {
+    poll(PROFILE_SUNNY_NOON, 1);
+    uint32_t metadataReads = site.cacheMisses();
+
+    // the inverter scales its power by 100 at night, the next poll decodes it with the new factor
+    simulator.setProfile(PROFILE_NIGHT);
+    TEST_ASSERT_TRUE(runCycle() && cycleOk);
+    assertTotals(0, -800000, -450000, 355);
+
+    simulator.setProfile(PROFILE_SUNNY_NOON);
+    TEST_ASSERT_TRUE(runCycle() && cycleOk);
+    assertTotals(6000000, 1500000, 600000, 600);
+
+    // the factors are no metadata, changing them needs no metadata read
+    TEST_ASSERT_TRUE(site.metadataValid());
+    TEST_ASSERT_EQUAL_UINT32(metadataReads, site.cacheMisses());
+}
+
+void test_poll_flaky_recovers() {
+    // a lost request is repeated after the short MODBUSIP_TIMEOUT of the native build
+    site.leaderPipeline().setRetries(3);
+    PollStats stats = poll(PROFILE_FLAKY, FLAKY_CYCLES);
+    site.leaderPipeline().setRetries(DEFAULT_REQUEST_RETRIES);
+    report(PROFILE_FLAKY, stats);
+
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stats.retries);
+    TEST_ASSERT_GREATER_OR_EQUAL_INT(FLAKY_CYCLES - 1, stats.succeeded);
+    printf("  simulator: %lu requests, %lu dropped, %lu busy\n", (unsigned long)simulator.requests(), (unsigned long)simulator.dropped(), (unsigned long)simulator.rejected());
+}
+
+void test_frame_compose_and_flush() {
+    TEST_ASSERT_TRUE(display.begin(SSD1306_SWITCHCAPVCC, 0x3C));
+    display.setRotation(2);
+    blitter.begin();
+    flusher.invalidate();
+
+    // the first frame goes out in full, page by page with its own address window
+    SolarSnapshot snapshot = {};
+    printStateScreen1(snapshot, false);
+    TEST_ASSERT_EQUAL_UINT32(FLUSH_PAGES * (7 + FLUSH_COLUMNS + (FLUSH_COLUMNS + 30) / 31), flusher.lastFrameBytes());
+
+    flusher.resetStats();
+    Wire.resetCounters();
+
+    // values change every frame like with a fast poll
+    unsigned long start = micros();
+    for (int i = 0; i < BENCHMARK_FRAMES; i++) {
+        snapshot.inverterPower = 1000 * (i * 37 % 9000);
+        snapshot.sunPower = snapshot.inverterPower;
+        snapshot.meterPower = 1000 * (i * 53 % 6000 - 3000);
+        snapshot.houseUsage = snapshot.inverterPower - snapshot.meterPower;
+        snapshot.batteryPower = 1000 * (i * 11 % 4000 - 2000);
+        snapshot.batteryStateOfEnergy = i * 7 % 1001;
+        printStateScreen1(snapshot, i % 10 == 0);
+    }
+    unsigned long frameMicros = (micros() - start) / BENCHMARK_FRAMES;
+
+    uint32_t bytesPerFrame = flusher.totalBytes() / flusher.frames();
+    printf("[display] %d frames\n", BENCHMARK_FRAMES);
+    printf("  frame compose + flush us: %lu\n", frameMicros);
+    printf("  bytes flushed per frame: %lu (full frame %u), transmissions %lu\n",
+           (unsigned long)bytesPerFrame, FULL_FRAME_BYTES, (unsigned long)Wire.transmissions() / BENCHMARK_FRAMES);
+
+    // the flusher reports what went over the bus, and only changed ranges go
+    TEST_ASSERT_EQUAL_UINT32(flusher.totalBytes(), Wire.bytesWritten());
+    TEST_ASSERT_LESS_THAN_UINT32(FULL_FRAME_BYTES, bytesPerFrame);
+}
+
+void test_animation_frames() {
+    TEST_ASSERT_TRUE(display.begin(SSD1306_SWITCHCAPVCC, 0x3C));
+    display.setRotation(2);
+    blitter.begin();
+    flusher.invalidate();
+
+    // all three arrows move, the values settle after the first transition
+    SolarSnapshot snapshot = {};
+    snapshot.sequence = 1;
+    snapshot.inverterPower = 4000000;
+    snapshot.meterPower = -1500000;
+    snapshot.batteryPower = 2500000;
+    snapshot.batteryStateOfEnergy = 500;
+    snapshot.sunPower = snapshot.inverterPower + snapshot.batteryPower;
+    snapshot.houseUsage = snapshot.inverterPower - snapshot.meterPower;
+    animator.setTarget(snapshot, millis());
+    animateFrame(true);
+    delay(TWEEN_MILLIS);
+    animateFrame(false);
+
+    flusher.resetStats();
+    std::vector<unsigned long> frameMicros;
+    int moved = 0;
+    for (int i = 0; i < ANIMATION_FRAMES; i++) {
+        delay(ANIMATION_FRAME_MILLIS);
+        unsigned long start = micros();
+        animateFrame(false);
+        frameMicros.push_back(micros() - start);
+        moved += flusher.lastFrameBytes() > 0 ? 1 : 0;
+    }
+
+    uint32_t bytesPerFrame = flusher.totalBytes() / flusher.frames();
+    printf("[animation] %d frames, %d with movement\n", ANIMATION_FRAMES, moved);
+    printf("  frame us: p50 %lu, max %lu (budget %lu)\n", percentile(frameMicros, 50), percentile(frameMicros, 100), (unsigned long)FRAME_BUDGET_MICROS);
+    printf("  bytes flushed per frame: %lu\n", (unsigned long)bytesPerFrame);
+
+    // only the arrow boxes go over the bus, a handful of columns each
+    TEST_ASSERT_GREATER_THAN_UINT32(ANIMATION_FRAMES / 2, moved);
+    TEST_ASSERT_LESS_THAN_UINT32(FULL_FRAME_BYTES / 4, bytesPerFrame);
+    TEST_ASSERT_LESS_THAN_UINT32(FRAME_BUDGET_MICROS, percentile(frameMicros, 95));
+}
+
+int main(int argc, char **argv) {
+    // the metadata dumps of the register cache would drown the report
+    Serial.setMuted(true);
+
+    if (!simulator.start()) {
+        printf("simulator could not listen\n");
+        return 1;
+    }
+    site.addDevice({IPAddress(127, 0, 0, 1), simulator.port(), 1, 0x01, 0x01});
+    site.begin();
+    if (site.connect() != 1) {
+        printf("could not connect to the simulator on port %u\n", simulator.port());
+        return 1;
+    }
+
+    UNITY_BEGIN();
+    RUN_TEST(test_layout_discovery);
+    RUN_TEST(test_layout_cache_rediscovers_on_mismatch);
+    RUN_TEST(test_layout_check_finds_added_equipment);
+    RUN_TEST(test_poll_sunny_noon);
+    RUN_TEST(test_poll_night);
+    RUN_TEST(test_poll_follows_changed_scale_factor);
+    RUN_TEST(test_mirror_waits_for_outdated_range);
+    RUN_TEST(test_poll_slow_link_is_pipelined);
+    RUN_TEST(test_poll_flaky_recovers);
+    RUN_TEST(test_frame_compose_and_flush);
+    RUN_TEST(test_animation_frames);
+    int failures = UNITY_END();
+
+    simulator.stop();
+    return failures;
+}
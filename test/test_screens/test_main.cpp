@@ -0,0 +1,167 @@
+#include <Adafruit_SSD1306.h>
+#include <Arduino.h>
+#include <unity.h>
+
+#include "DisplayFlusher.h"
+#include "PageBlitter.h"
+#include "SolarSnapshot.h"
+
+// Golden frames, relative to the project directory the tests run in
+#ifndef GOLDEN_DIR
+#define GOLDEN_DIR "test/golden"
+#endif
+
+// Logical screen size
+const int16_t SCREEN_W = 128;
+const int16_t SCREEN_H = 64;
+
+// Display path of the monitor
+extern Adafruit_SSD1306 display;
+extern DisplayFlusher flusher;
+extern PageBlitter blitter;
+void printStateScreen1(const SolarSnapshot &snapshot, boolean stale);
+void printStateScreen2(const char *line1, const char *line2, const char *line3, const char *line4);
+
+// Frame as a binary PBM (P4) in logical coordinates, lit pixels are black
+std::string framePbm() {
+    std::string pbm = "P4\n128 64\n";
+    for (int16_t y = 0; y < SCREEN_H; y++) {
+        for (int16_t x = 0; x < SCREEN_W; x += 8) {
+            uint8_t bits = 0;
+            for (int16_t i = 0; i < 8; i++) {
+                bits |= display.getPixel(x + i, y) ? 0x80 >> i : 0;
+            }
+            pbm += (char)bits;
+        }
+    }
+    return pbm;
+}
+
+bool readFile(const std::string &path, std::string &contents) {
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    char buffer[512];
+    size_t n;
+    contents.clear();
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        contents.append(buffer, n);
+    }
+    fclose(file);
+    return true;
+}
+
+bool writeFile(const std::string &path, const std::string &contents) {
+    FILE *file = fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool ok = fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    return fclose(file) == 0 && ok;
+}
+
+/**
+ * Compares the display with the golden frame of name. A missing golden
+ * fails the test, UPDATE_GOLDEN=1 records all of them again. On a
+ * mismatch the frame is written next to the golden as <name>.actual.pbm.
+ */
+void assertGolden(const char *name) {
+    std::string actual = framePbm();
+    std::string path = std::string(GOLDEN_DIR) + "/" + name + ".pbm";
+    std::string expected;
+
+    const char *update = getenv("UPDATE_GOLDEN");
+    if (update != nullptr && strcmp(update, "1") == 0) {
+        TEST_ASSERT_TRUE_MESSAGE(writeFile(path, actual), "golden frame could not be written");
+        TEST_IGNORE_MESSAGE("golden frame recorded");
+    }
+    if (!readFile(path, expected)) {
+        writeFile(std::string(GOLDEN_DIR) + "/" + name + ".actual.pbm", actual);
+
+        char message[96];
+        snprintf(message, sizeof(message), "golden frame %s missing, record it with UPDATE_GOLDEN=1", path.c_str());
+        TEST_FAIL_MESSAGE(message);
+    }
+
+    if (actual != expected) {
+        int differing = 0;
+        for (size_t i = 0; i < actual.size() && i < expected.size(); i++) {
+            differing += __builtin_popcount((uint8_t)(actual[i] ^ expected[i]));
+        }
+        writeFile(std::string(GOLDEN_DIR) + "/" + name + ".actual.pbm", actual);
+
+        char message[96];
+        snprintf(message, sizeof(message), "%d pixels differ from %s", differing, path.c_str());
+        TEST_FAIL_MESSAGE(message);
+    }
+}
+
+// Snapshot as acquireSnapshot() derives it from the polled powers
+SolarSnapshot snapshotOf(milliwatt_t inverter, milliwatt_t meter, milliwatt_t battery, decipercent_t soe) {
+    SolarSnapshot snapshot = {};
+    snapshot.sequence = 1;
+    snapshot.inverterPower = inverter;
+    snapshot.meterPower = meter;
+    snapshot.batteryPower = battery;
+    snapshot.batteryStateOfEnergy = soe;
+    snapshot.sunPower = inverter + battery;
+    snapshot.houseUsage = inverter - meter;
+    return snapshot;
+}
+
+void setUp() {
+    flusher.invalidate();
+}
+
+void tearDown() {
+}
+
+void test_screen1_export_and_charge() {
+    printStateScreen1(snapshotOf(6000000, 1500000, 600000, 600), false);
+    assertGolden("screen1_export_and_charge");
+}
+
+void test_screen1_import_and_discharge() {
+    printStateScreen1(snapshotOf(0, -800000, -450000, 355), false);
+    assertGolden("screen1_import_and_discharge");
+}
+
+void test_screen1_idle() {
+    printStateScreen1(snapshotOf(0, 0, 0, 0), false);
+    assertGolden("screen1_idle");
+}
+
+void test_screen1_stale_full_battery() {
+    printStateScreen1(snapshotOf(12340000, 9870000, 0, 1000), true);
+    assertGolden("screen1_stale_full_battery");
+}
+
+void test_screen2_two_lines() {
+    printStateScreen2("Init WiFi connection", "Connecting", nullptr, nullptr);
+    assertGolden("screen2_two_lines");
+}
+
+void test_screen2_four_lines() {
+    printStateScreen2("Init Modbus client", "192.168.0.1:1502", "Unit 255", "connected");
+    assertGolden("screen2_four_lines");
+}
+
+int main(int argc, char **argv) {
+    // same display setup as setup()
+    if (!display.begin(SSD1306_SWITCHCAPVCC, 0x3C)) {
+        return 1;
+    }
+    display.setRotation(2);
+    display.clearDisplay();
+    blitter.begin();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_screen1_export_and_charge);
+    RUN_TEST(test_screen1_import_and_discharge);
+    RUN_TEST(test_screen1_idle);
+    RUN_TEST(test_screen1_stale_full_battery);
+    RUN_TEST(test_screen2_two_lines);
+    RUN_TEST(test_screen2_four_lines);
+    return UNITY_END();
+}
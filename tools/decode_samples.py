@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""Decodes the sample blocks of /api/samples into CSV.
+
+Usage:
+    curl -o samples.bin "http://<monitor>/api/samples?from=1700000000&to=1700086400"
+    python3 decode_samples.py samples.bin [--from EPOCH] [--to EPOCH] > samples.csv
+
+Every 512 byte block has a 16 byte header (magic "SL", sample count,
+column count, sequence, time of the first sample, encoded length) followed
+by the columns time, sun, house, grid, battery and state of energy. Each
+column holds one zigzag varint per sample: the delta to the previous sample
+of the block, the first sample relative to the header time or 0.
+"""
+
+import argparse
+import csv
+import datetime
+import struct
+import sys
+
+BLOCK_SIZE = 512
+HEADER = struct.Struct("<HBBIIHH")
+MAGIC = 0x4C53
+COLUMNS = ("time", "sun_w", "house_w", "grid_w", "battery_w", "soe_percent")
+
+
+def varints(data, pos, count):
+    """Reads count unsigned varints starting at pos, returns them and the new position."""
+    values = []
+    for _ in range(count):
+        value = shift = 0
+        while True:
+            byte = data[pos]
+            pos += 1
+            value |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                break
+        values.append(value)
+    return values, pos
+
+
+def unzigzag(v):
+    return (v >> 1) ^ -(v & 1)
+
+
+def decode_block(block):
+    """Yields the samples of one block as tuples in the order of COLUMNS."""
+    magic, count, columns, _sequence, first_time, _length, _ = HEADER.unpack_from(block)
+    if magic != MAGIC:
+        raise ValueError("not a sample block")
+
+    pos = HEADER.size
+    decoded = []
+    for c in range(columns):
+        deltas, pos = varints(block, pos, count)
+        value = first_time if c == 0 else 0
+        column = []
+        for d in deltas:
+            value += unzigzag(d)
+            column.append(value)
+        decoded.append(column)
+
+    for row in zip(*decoded):
+        yield row
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("file")
+    parser.add_argument("--from", dest="start", type=int, default=0, help="first time, seconds since 1970")
+    parser.add_argument("--to", dest="end", type=int, default=2**32, help="last time, seconds since 1970")
+    args = parser.parse_args()
+
+    with open(args.file, "rb") as f:
+        data = f.read()
+
+    out = csv.writer(sys.stdout)
+    out.writerow(("utc",) + COLUMNS)
+    for offset in range(0, len(data) - BLOCK_SIZE + 1, BLOCK_SIZE):
+        for row in decode_block(data[offset:offset + BLOCK_SIZE]):
+            if args.start <= row[0] <= args.end:
+                utc = datetime.datetime.fromtimestamp(row[0], datetime.timezone.utc).isoformat()
+                out.writerow((utc,) + row[:5] + ("%.1f" % (row[5] / 10),))
+
+
+if __name__ == "__main__":
+    main()